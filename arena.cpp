@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "arena.hpp"
+
+
+MonotonicArena::MonotonicArena(size_t initial_block_size)
+{
+    current_block = nullptr;
+    cursor = nullptr;
+    block_end = nullptr;
+    this->initial_block_size = std::max(initial_block_size, size_t(1024));
+    next_block_size = this->initial_block_size;
+    block_num = 0;
+    reserved_bytes = 0;
+    used_bytes = 0;
+}
+
+MonotonicArena::~MonotonicArena()
+{
+    Release();
+}
+
+void* MonotonicArena::Allocate(size_t bytes, size_t alignment)
+{
+    uintptr_t address = (reinterpret_cast<uintptr_t>(cursor) + alignment-1) & ~uintptr_t(alignment-1);
+    if(cursor == nullptr || address + bytes > reinterpret_cast<uintptr_t>(block_end))
+    {
+        // 块头之后按最大对齐留出位置, 保证新块上的第一次申请一定放得下
+        size_t block_size = std::max(next_block_size, sizeof(Block) + alignof(std::max_align_t) + bytes + alignment);
+        Block* block = static_cast<Block*>(::operator new(block_size));
+        block->previous = current_block;
+        block->size = block_size;
+        current_block = block;
+        cursor = reinterpret_cast<char*>(block) + sizeof(Block);
+        block_end = reinterpret_cast<char*>(block) + block_size;
+        next_block_size = std::max(next_block_size, block_size)*2;
+        block_num++;
+        reserved_bytes += block_size;
+
+        address = (reinterpret_cast<uintptr_t>(cursor) + alignment-1) & ~uintptr_t(alignment-1);
+    }
+
+    used_bytes += bytes;
+    cursor = reinterpret_cast<char*>(address + bytes);
+    return reinterpret_cast<void*>(address);
+}
+
+void MonotonicArena::Release()
+{
+    while(current_block != nullptr)
+    {
+        Block* previous = current_block->previous;
+        ::operator delete(current_block);
+        current_block = previous;
+    }
+    cursor = nullptr;
+    block_end = nullptr;
+    next_block_size = initial_block_size;
+    block_num = 0;
+    reserved_bytes = 0;
+    used_bytes = 0;
+}
+
+int MonotonicArena::GetBlockCount() const
+{
+    return block_num;
+}
+
+size_t MonotonicArena::GetReservedBytes() const
+{
+    return reserved_bytes;
+}
+
+size_t MonotonicArena::GetUsedBytes() const
+{
+    return used_bytes;
+}
@@ -0,0 +1,108 @@
+#ifndef BCD_PLANNER_ARENA_H
+#define BCD_PLANNER_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+
+/** 单调增长的内存池: 按块向堆申请, 块内顺序切分, 释放单个对象什么也不做, 析构或Release时整块归还 **/
+/** 供一次规划内的临时容器使用, 一次规划只有少数几次堆分配; 不加锁, 只能在一个线程内使用 **/
+
+
+class MonotonicArena
+{
+public:
+    // 第一块的大小, 之后每块翻倍, 单次申请超过块大小时单独成块
+    explicit MonotonicArena(size_t initial_block_size=64*1024);
+    ~MonotonicArena();
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    void* Allocate(size_t bytes, size_t alignment);
+    // 一次归还所有块, 之前分出的内存全部失效; 之后的块数, 字节数与块大小都与新建时相同
+    void Release();
+
+    // 向堆申请过的块数与字节数, 以及已分出去的字节数
+    int GetBlockCount() const;
+    size_t GetReservedBytes() const;
+    size_t GetUsedBytes() const;
+
+private:
+    class Block
+    {
+    public:
+        Block* previous;
+        size_t size;
+    };
+
+    Block* current_block;
+    char* cursor;
+    char* block_end;
+    size_t initial_block_size;
+    size_t next_block_size;
+    int block_num;
+    size_t reserved_bytes;
+    size_t used_bytes;
+};
+
+/** 从MonotonicArena分配的标准分配器; arena为nullptr时退回全局operator new, 与std::allocator相同 **/
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    ArenaAllocator(): arena(nullptr)
+    {
+    }
+    explicit ArenaAllocator(MonotonicArena* arena): arena(arena)
+    {
+    }
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other): arena(other.GetArena())
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if(arena == nullptr)
+        {
+            return static_cast<T*>(::operator new(n*sizeof(T)));
+        }
+        return static_cast<T*>(arena->Allocate(n*sizeof(T), alignof(T)));
+    }
+    void deallocate(T* ptr, size_t)
+    {
+        if(arena == nullptr)
+        {
+            ::operator delete(ptr);
+        }
+    }
+
+    MonotonicArena* GetArena() const
+    {
+        return arena;
+    }
+
+private:
+    MonotonicArena* arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+    return lhs.GetArena() == rhs.GetArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+    return lhs.GetArena() != rhs.GetArena();
+}
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif //BCD_PLANNER_ARENA_H
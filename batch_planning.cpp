@@ -0,0 +1,72 @@
+#include <map>
+#include <chrono>
+#include <algorithm>
+
+#include "batch_planning.hpp"
+#include "profiler.hpp"
+
+
+namespace
+{
+
+typedef std::chrono::steady_clock BatchClock;
+
+double ElapsedMilliseconds(const BatchClock::time_point& start)
+{
+    return std::chrono::duration<double, std::milli>(BatchClock::now()-start).count();
+}
+
+}
+
+std::vector<PlanJobResult> PlanBatch(ConfigurationSpaceCache& configuration_spaces, const std::vector<PlanJob>& jobs, bool sequence_cells, ThreadPool& pool)
+{
+    BCD_PROFILE_SCOPE("PlanBatch");
+
+    std::vector<PlanJobResult> results(jobs.size());
+
+    // 半径 -> 该组任务的下标, 按半径从小到大处理
+    std::map<int, std::vector<int>> job_groups;
+    for(int i = 0; i < int(jobs.size()); i++)
+    {
+        job_groups[std::max(jobs[i].robot_radius, 0)].emplace_back(i);
+    }
+    BCD_PROFILE_COUNT("batch_radius_groups", job_groups.size());
+
+    // 逐组处理, 同一时刻只需持有一个半径的配置空间
+    for(const auto& job_group : job_groups)
+    {
+        const std::vector<int>& job_indices = job_group.second;
+
+        BatchClock::time_point start = BatchClock::now();
+        std::shared_ptr<const ConfigurationSpace> configuration_space = configuration_spaces.Get(job_group.first);
+        double decomposition_milliseconds = ElapsedMilliseconds(start);
+
+        for(const auto& job_index : job_indices)
+        {
+            results[job_index].decomposition_milliseconds = decomposition_milliseconds;
+        }
+        if(configuration_space == nullptr)
+        {
+            continue;
+        }
+
+        const CellGraph& cell_graph = configuration_space->flat_cell_graph;
+        pool.ParallelFor(int(job_indices.size()), [&](int i)
+        {
+            int job_index = job_indices[i];
+            const PlanJob& job = jobs[job_index];
+            PlanJobResult& result = results[job_index];
+
+            BatchClock::time_point job_start = BatchClock::now();
+            if(!DetermineCellIndex(cell_graph, job.start_point).empty())
+            {
+                CellGraph working_graph = cell_graph;
+                result.global_path = StaticPathPlanning(working_graph, job.start_point, configuration_space->robot_radius, sequence_cells);
+                result.planned = true;
+            }
+            result.planning_milliseconds = ElapsedMilliseconds(job_start);
+        });
+    }
+
+    return results;
+}
@@ -0,0 +1,53 @@
+#ifndef BCD_PLANNER_BATCH_PLANNING_H
+#define BCD_PLANNER_BATCH_PLANNING_H
+
+#include <vector>
+#include <deque>
+
+#include "bcd.hpp"
+#include "configuration_space.hpp"
+#include "thread_pool.hpp"
+
+
+/** 批量规划: 同一张地图上许多(起点, 半径)的组合 **/
+/** 按半径分组, 每组的轮廓与cell graph只生成一次(来自ConfigurationSpaceCache), 组内各起点的规划分给线程池并行执行 **/
+
+
+class PlanJob
+{
+public:
+    PlanJob()
+    {
+        robot_radius = 0;
+    }
+    PlanJob(const Point2D& start, int radius)
+    {
+        start_point = start;
+        robot_radius = radius;
+    }
+    Point2D start_point;
+    int robot_radius;
+};
+
+class PlanJobResult
+{
+public:
+    PlanJobResult()
+    {
+        planned = false;
+        decomposition_milliseconds = 0.0;
+        planning_milliseconds = 0.0;
+    }
+    // 该半径下没有空闲区域或起点不在空闲区域内时为false, global_path为空
+    bool planned;
+    std::deque<std::deque<Point2D>> global_path;
+    // 所在分组取得配置空间的耗时(缓存命中时接近0), 同组的任务相同
+    double decomposition_milliseconds;
+    double planning_milliseconds;
+};
+
+// 结果与jobs的顺序一致; 每个任务在扁平cell graph的一份副本上规划, 与逐个调用StaticPathPlanning的结果相同
+std::vector<PlanJobResult> PlanBatch(ConfigurationSpaceCache& configuration_spaces, const std::vector<PlanJob>& jobs, bool sequence_cells=false,
+                                     ThreadPool& pool=DefaultThreadPool());
+
+#endif //BCD_PLANNER_BATCH_PLANNING_H
@@ -0,0 +1,4828 @@
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <map>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cfloat>
+#include <atomic>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/imgcodecs/imgcodecs.hpp>
+
+#include <Eigen/Core>
+
+#include "bcd.hpp"
+#include "profiler.hpp"
+#include "thread_pool.hpp"
+#include "sweep_cache.hpp"
+#include "arena.hpp"
+
+
+/** 路径规划功能函数 **/
+
+
+int WrappedIndex(int index, int list_length)
+{
+    int wrapped_index = (index%list_length+list_length)%list_length;
+    return wrapped_index;
+}
+
+/** 深度优先搜索遍历邻接图 **/
+/** 回溯沿parentIndex进行, parentIndex链即为搜索栈, 因此不需要递归 **/
+void WalkThroughGraph(CellGraph& cell_graph, int cell_index, int& unvisited_counter, std::vector<int>& path)
+{
+    // 已访问的邻居不会再变为未访问, 每个cell记录下次从第几个邻居开始找
+    std::vector<int> neighbor_cursors(cell_graph.Size(), 0);
+
+    int curr_cell_index = cell_index;
+
+    while(true)
+    {
+        if(!cell_graph.IsVisited(curr_cell_index))
+        {
+            cell_graph.SetVisited(curr_cell_index, true);
+            unvisited_counter--;
+        }
+        path.emplace_back(curr_cell_index);
+        BCD_PROFILE_COUNT("WalkThroughGraph.steps", 1);
+
+        int neighbor_idx = INT_MAX;
+
+        int& cursor = neighbor_cursors[curr_cell_index];
+        for(; cursor < cell_graph.NeighborCount(curr_cell_index); cursor++)
+        {
+            if(!cell_graph.IsVisited(cell_graph.Neighbor(curr_cell_index, cursor)))
+            {
+                neighbor_idx = cell_graph.Neighbor(curr_cell_index, cursor);
+                break;
+            }
+        }
+
+        if(neighbor_idx != INT_MAX) // unvisited neighbor found
+        {
+            cell_graph.SetParentIndex(neighbor_idx, curr_cell_index);
+            curr_cell_index = neighbor_idx;
+        }
+        else  // unvisited neighbor not found
+        {
+            if (cell_graph.ParentIndex(curr_cell_index) == INT_MAX) // cannot go on back-tracking
+            {
+                return;
+            }
+            else if(unvisited_counter == 0)
+            {
+                return;
+            }
+            else
+            {
+                curr_cell_index = cell_graph.ParentIndex(curr_cell_index);
+            }
+        }
+    }
+}
+
+std::vector<int> GetVisittingPath(CellGraph& cell_graph, int first_cell_index)
+{
+    BCD_PROFILE_SCOPE("GetVisittingPath");
+
+    std::vector<int> visitting_path;
+
+    if(cell_graph.Size()==1)
+    {
+        visitting_path.emplace_back(0);
+    }
+    else
+    {
+        int unvisited_counter = cell_graph.Size();
+        WalkThroughGraph(cell_graph, first_cell_index, unvisited_counter, visitting_path);
+    }
+
+    return visitting_path;
+}
+
+std::vector<Point2D> ComputeCellCornerPoints(const CellNode& cell)
+{
+
+    Point2D topleft = cell.ceiling.front();
+    Point2D bottomleft = cell.floor.front();
+    Point2D bottomright = cell.floor.back();
+    Point2D topright = cell.ceiling.back();
+
+    // 按照TOPLEFT、BOTTOMLEFT、BOTTOMRIGHT、TOPRIGHT的顺序储存corner points（逆时针）
+    std::vector<Point2D> corner_points = {topleft, bottomleft, bottomright, topright};
+
+    return corner_points;
+}
+
+std::vector<Point2D> ComputeCellCornerPoints(const CellGraph& cell_graph, int cell_index)
+{
+    CellEdgeView ceiling = cell_graph.Ceiling(cell_index);
+    CellEdgeView floor = cell_graph.Floor(cell_index);
+
+    std::vector<Point2D> corner_points = {ceiling.front(), floor.front(), floor.back(), ceiling.back()};
+
+    return corner_points;
+}
+
+// 与ComputeCellCornerPoints(cell_graph, cell_index)[corner_indicator]相同, 不分配内存
+Point2D ComputeCellCornerPoint(const CellGraph& cell_graph, int cell_index, int corner_indicator)
+{
+    if(corner_indicator == TOPLEFT)
+    {
+        return cell_graph.Ceiling(cell_index).front();
+    }
+    if(corner_indicator == BOTTOMLEFT)
+    {
+        return cell_graph.Floor(cell_index).front();
+    }
+    if(corner_indicator == BOTTOMRIGHT)
+    {
+        return cell_graph.Floor(cell_index).back();
+    }
+    return cell_graph.Ceiling(cell_index).back();
+}
+
+std::vector<int> DetermineCellIndex(const std::vector<CellNode>& cell_graph, const Point2D& point)
+{
+    std::vector<int> cell_index;
+
+    for(int i = 0; i < cell_graph.size(); i++)
+    {
+        for(int j = 0; j < cell_graph[i].ceiling.size(); j++)
+        {
+            if(point.x ==  cell_graph[i].ceiling[j].x && point.y >= cell_graph[i].ceiling[j].y && point.y <= cell_graph[i].floor[j].y)
+            {
+                cell_index.emplace_back(int(i));
+            }
+        }
+
+    }
+    return cell_index;
+}
+
+std::vector<int> DetermineCellIndex(const CellGraph& cell_graph, const Point2D& point)
+{
+    std::vector<int> cell_index;
+    cell_graph.Locate(point, cell_index);
+    return cell_index;
+}
+
+// 往返路径接在path的末尾, path可以是任意支持emplace_back的点容器
+template <typename Path>
+void AppendBoustrophedonPath(const CellGraph& cell_graph, int cell_index, int corner_indicator, int robot_radius, Path& path)
+{
+    BCD_PROFILE_SCOPE("GetBoustrophedonPath");
+
+    int delta, increment;
+
+    CellEdgeView ceiling = cell_graph.Ceiling(cell_index);
+    CellEdgeView floor = cell_graph.Floor(cell_index);
+
+    Point2D corner_points[4] = {ceiling.front(), floor.front(), floor.back(), ceiling.back()};
+
+    if(cell_graph.IsCleaned(cell_index))
+    {
+        if(corner_indicator == TOPLEFT)
+        {
+            path.emplace_back(corner_points[TOPLEFT]);
+        }
+        if(corner_indicator == TOPRIGHT)
+        {
+            path.emplace_back(corner_points[TOPRIGHT]);
+        }
+        if(corner_indicator == BOTTOMLEFT)
+        {
+            path.emplace_back(corner_points[BOTTOMLEFT]);
+        }
+        if(corner_indicator == BOTTOMRIGHT)
+        {
+            path.emplace_back(corner_points[BOTTOMRIGHT]);
+        }
+    }
+    else
+    {
+        if(corner_indicator == TOPLEFT)
+        {
+            int x, y, y_start, y_end;
+            bool reverse = false;
+
+            for(int i = 0; i < ceiling.size(); i = i + (robot_radius+1))
+            {
+                x = ceiling[i].x;
+
+                if(!reverse)
+                {
+                    y_start = ceiling[i].y;
+                    y_end   = floor[i].y;
+
+                    for(y = y_start; y <= y_end; y++)
+                    {
+                        path.emplace_back(Point2D(x, y));
+                    }
+
+                    if((i+1<floor.size())&&(std::abs(floor[i+1].y-floor[i].y)>=2))
+                    {
+                        delta = floor[i+1].y-floor[i].y;
+                        increment = delta/abs(delta);
+                        for(int k = 1; k <= abs(delta); k++)
+                        {
+                            path.emplace_back(Point2D(floor[i].x, floor[i].y + increment * (k)));
+                        }
+                    }
+
+                    if(robot_radius != 0)
+                    {
+                        for(int j = 1; j <= robot_radius+1; j++)
+                        {
+                            // 沿着floor从左往右
+                            if( x+j >= floor.back().x)
+                            {
+                                i = i - (robot_radius - (j - 1));
+                                break;
+                            }
+
+                            //提前转
+                            else if((floor[i+(j)].y-floor[i+(j+1)].y>=2)
+                               &&(j<=robot_radius+1)
+                               &&(j+1<=robot_radius+1))
+                            {
+                                delta = floor[i+(j+1)].y-floor[i+(j)].y;
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(floor[i+(j)].x, floor[i+(j)].y+increment*(k)));
+                                }
+                            }
+                            //滞后转
+                            else if((floor[i+(j+1)].y-floor[i+(j)].y>=2)
+                                    &&(j+1<=robot_radius+1)
+                                    &&(j<=robot_radius+1))
+                            {
+                                path.emplace_back(Point2D(floor[i+(j)].x, floor[i+(j)].y));
+
+                                delta = floor[i+(j+1)].y-floor[i+(j)].y;
+
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(floor[i+(j+1)].x, floor[i+(j+1)].y-abs(delta) +increment*(k)));
+                                }
+                            }
+                            else
+                            {
+                                path.emplace_back(floor[i+(j)]);
+                            }
+
+                        }
+                    }
+
+                    reverse = !reverse;
+                }
+                else
+                {
+                    y_start = floor[i].y;
+                    y_end   = ceiling[i].y;
+
+                    for (y = y_start; y >= y_end; y--)
+                    {
+                        path.emplace_back(Point2D(x, y));
+                    }
+
+                    if((i+1<ceiling.size())&&(std::abs(ceiling[i+1].y-ceiling[i].y)>=2))
+                    {
+                        delta = ceiling[i+1].y-ceiling[i].y;
+                        increment = delta/abs(delta);
+                        for(int k = 1; k <= abs(delta); k++)
+                        {
+                            path.emplace_back(Point2D(ceiling[i].x, ceiling[i].y+increment*(k)));
+                        }
+                    }
+
+                    if(robot_radius != 0)
+                    {
+                        for(int j = 1; j <= robot_radius+1; j++)
+                        {
+                            // 沿着ceiling从左往右
+                            if(x+j >= ceiling.back().x)
+                            {
+                                i = i - (robot_radius - (j - 1));
+                                break;
+                            }
+
+                            // 提前转
+                            else if((ceiling[i+(j+1)].y-ceiling[i+(j)].y>=2)
+                               &&(j+1 <= robot_radius+1)
+                               &&(j <= robot_radius+1))
+                            {
+                                delta = ceiling[i+(j+1)].y-ceiling[i+(j)].y;
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(ceiling[i+j].x, ceiling[i+j].y+increment*(k)));
+                                }
+                            }
+                            // 滞后转
+                            else if((ceiling[i+(j)].y-ceiling[i+(j+1)].y>=2)
+                                    &&(j<=robot_radius+1)
+                                    &&(j+1<=robot_radius+1))
+                            {
+                                path.emplace_back(ceiling[i+(j)]);
+
+                                delta = ceiling[i+(j+1)].y-ceiling[i+(j)].y;
+
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(ceiling[i+(j+1)].x, ceiling[i+(j+1)].y+abs(delta)+increment*(k)));
+                                }
+                            }
+                            else
+                            {
+                                path.emplace_back(ceiling[i+j]);
+                            }
+
+                        }
+                    }
+
+                    reverse = !reverse;
+                }
+            }
+        }
+
+        if(corner_indicator == TOPRIGHT)
+        {
+            int x=0, y=0, y_start=0, y_end=0;
+            bool reverse = false;
+
+            for(int i = ceiling.size()-1; i >= 0; i=i-(robot_radius+1))
+            {
+                x = ceiling[i].x;
+
+                if(!reverse)
+                {
+                    y_start = ceiling[i].y;
+                    y_end   = floor[i].y;
+
+                    for(y = y_start; y <= y_end; y++)
+                    {
+                        path.emplace_back(Point2D(x, y));
+                    }
+
+                    if((i-1>=0)&&(std::abs(floor[i-1].y-floor[i].y)>=2))
+                    {
+                        delta = floor[i-1].y-floor[i].y;
+                        increment = delta/abs(delta);
+                        for(int k = 1; k <= abs(delta); k++)
+                        {
+                            path.emplace_back(Point2D(floor[i].x, floor[i].y+increment*(k)));
+                        }
+                    }
+
+                    if(robot_radius != 0)
+                    {
+                        for(int j = 1; j <= robot_radius+1; j++)
+                        {
+                            // 沿着floor从右往左
+                            if(x-j <= floor.front().x)
+                            {
+                                i = i + (robot_radius - (j - 1));
+                                break;
+                            }
+                            //提前转
+                            else if((floor[i-(j)].y-floor[i-(j+1)].y>=2)
+                               &&(j<=robot_radius+1)
+                               &&(j+1<=robot_radius+1))
+                            {
+                                delta = floor[i-(j+1)].y-floor[i-(j)].y;
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(floor[i-(j)].x, floor[i-(j)].y+increment*(k)));
+                                }
+                            }
+                            //滞后转
+                            else if((floor[i-(j+1)].y-floor[i-(j)].y>=2)
+                                    &&(j+1<=robot_radius+1)
+                                    &&(j<=robot_radius+1))
+                            {
+                                path.emplace_back(Point2D(floor[i-(j)].x, floor[i-(j)].y));
+
+                                delta = floor[i-(j+1)].y-floor[i-(j)].y;
+
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(floor[i-(j+1)].x, floor[i-(j+1)].y-abs(delta) +increment*(k)));
+                                }
+                            }
+                            else
+                            {
+                                path.emplace_back(floor[i-(j)]);
+                            }
+                        }
+                    }
+
+                    reverse = !reverse;
+                }
+                else
+                {
+                    y_start = floor[i].y;
+                    y_end   = ceiling[i].y;
+
+                    for (y = y_start; y >= y_end; y--)
+                    {
+                        path.emplace_back(Point2D(x, y));
+                    }
+
+                    if((i-1>=0)&&(std::abs(ceiling[i-1].y-ceiling[i].y)>=2))
+                    {
+                        delta = ceiling[i-1].y-ceiling[i].y;
+                        increment = delta/abs(delta);
+                        for(int k = 1; k <= abs(delta); k++)
+                        {
+                            path.emplace_back(Point2D(ceiling[i].x, ceiling[i].y+increment*(k)));
+                        }
+                    }
+
+                    if(robot_radius != 0)
+                    {
+                        for(int j = 1; j <= robot_radius+1; j++)
+                        {
+                            // 沿着ceiling从右往左
+                            if( x-j <= ceiling.front().x)
+                            {
+                                i = i + (robot_radius - (j - 1));
+                                break;
+                            }
+                            // 提前转
+                            else if((ceiling[i-(j+1)].y-ceiling[i-(j)].y>=2)
+                               &&(j+1 <= robot_radius+1)
+                               &&(j <= robot_radius+1))
+                            {
+                                delta = ceiling[i-(j+1)].y-ceiling[i-(j)].y;
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(ceiling[i-j].x, ceiling[i-j].y+increment*(k)));
+                                }
+                            }
+                            // 滞后转
+                            else if((ceiling[i-(j)].y-ceiling[i-(j+1)].y>=2)
+                                    &&(j<=robot_radius+1)
+                                    &&(j+1<=robot_radius+1))
+                            {
+                                path.emplace_back(ceiling[i-(j)]);
+
+                                delta = ceiling[i-(j+1)].y-ceiling[i-(j)].y;
+
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(ceiling[i-(j+1)].x, ceiling[i-(j+1)].y+abs(delta)+increment*(k)));
+                                }
+                            }
+                            else
+                            {
+                                path.emplace_back(ceiling[i-j]);
+                            }
+                        }
+                    }
+
+                    reverse = !reverse;
+                }
+            }
+        }
+
+        if(corner_indicator == BOTTOMLEFT)
+        {
+            int x=0, y=0, y_start=0, y_end=0;
+            bool reverse = false;
+
+            for(int i = 0; i < ceiling.size(); i=i+(robot_radius+1))
+            {
+                x = ceiling[i].x;
+
+                if(!reverse)
+                {
+                    y_start = floor[i].y;
+                    y_end   = ceiling[i].y;
+
+                    for(y = y_start; y >= y_end; y--)
+                    {
+                        path.emplace_back(Point2D(x, y));
+                    }
+
+                    if((i+1<ceiling.size())&&(std::abs(ceiling[i+1].y-ceiling[i].y)>=2))
+                    {
+                        delta = ceiling[i+1].y-ceiling[i].y;
+                        increment = delta/abs(delta);
+                        for(int k = 1; k <= abs(delta); k++)
+                        {
+                            path.emplace_back(Point2D(ceiling[i].x, ceiling[i].y+increment*(k)));
+                        }
+                    }
+
+                    if(robot_radius != 0)
+                    {
+                        for(int j = 1; j <= robot_radius+1; j++)
+                        {
+                            // 沿着ceiling从左往右
+                            if(x+j >= ceiling.back().x)
+                            {
+                                i = i - (robot_radius - (j - 1));
+                                break;
+                            }
+                            // 提前转
+                            else if((ceiling[i+(j+1)].y-ceiling[i+(j)].y>=2)
+                               &&(j+1 <= robot_radius+1)
+                               &&(j <= robot_radius+1))
+                            {
+                                delta = ceiling[i+(j+1)].y-ceiling[i+(j)].y;
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(ceiling[i+j].x, ceiling[i+j].y+increment*(k)));
+                                }
+                            }
+                                // 滞后转
+                            else if((ceiling[i+(j)].y-ceiling[i+(j+1)].y>=2)
+                                    &&(j<=robot_radius+1)
+                                    &&(j+1<=robot_radius+1))
+                            {
+                                path.emplace_back(ceiling[i+(j)]);
+
+                                delta = ceiling[i+(j+1)].y-ceiling[i+(j)].y;
+
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(ceiling[i+(j+1)].x, ceiling[i+(j+1)].y+abs(delta)+increment*(k)));
+                                }
+                            }
+                            else
+                            {
+                                path.emplace_back(ceiling[i+j]);
+                            }
+                        }
+                    }
+
+                    reverse = !reverse;
+                }
+                else
+                {
+                    y_start = ceiling[i].y;
+                    y_end   = floor[i].y;
+
+                    for (y = y_start; y <= y_end; y++)
+                    {
+                        path.emplace_back(Point2D(x, y));
+                    }
+
+                    if((i+1<floor.size())&&(std::abs(floor[i+1].y-floor[i].y)>=2))
+                    {
+                        delta = floor[i+1].y-floor[i].y;
+                        increment = delta/abs(delta);
+                        for(int k = 1; k <= abs(delta); k++)
+                        {
+                            path.emplace_back(Point2D(floor[i].x, floor[i].y+increment*(k)));
+                        }
+                    }
+
+                    if(robot_radius != 0)
+                    {
+                        for(int j = 1; j <= robot_radius+1; j++)
+                        {
+                            // 沿着floor从左往右
+                            if(x+j >= floor.back().x)
+                            {
+                                i = i - (robot_radius - (j - 1));
+                                break;
+                            }
+
+                            //提前转
+                            else if((floor[i+(j)].y-floor[i+(j+1)].y>=2)
+                               &&(j<=robot_radius+1)
+                               &&(j+1<=robot_radius+1))
+                            {
+                                delta = floor[i+(j+1)].y-floor[i+(j)].y;
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(floor[i+(j)].x, floor[i+(j)].y+increment*(k)));
+                                }
+                            }
+                                //滞后转
+                            else if((floor[i+(j+1)].y-floor[i+(j)].y>=2)
+                                    &&(j+1<=robot_radius+1)
+                                    &&(j<=robot_radius+1))
+                            {
+                                path.emplace_back(Point2D(floor[i+(j)].x, floor[i+(j)].y));
+
+                                delta = floor[i+(j+1)].y-floor[i+(j)].y;
+
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(floor[i+(j+1)].x, floor[i+(j+1)].y-abs(delta) +increment*(k)));
+                                }
+                            }
+                            else
+                            {
+                                path.emplace_back(floor[i+(j)]);
+                            }
+                        }
+                    }
+
+                    reverse = !reverse;
+                }
+            }
+        }
+
+        if(corner_indicator == BOTTOMRIGHT)
+        {
+            int x=0, y=0, y_start=0, y_end=0;
+            bool reverse = false;
+
+            for(int i = ceiling.size()-1; i >= 0; i=i-(robot_radius+1))
+            {
+                x = ceiling[i].x;
+
+                if(!reverse)
+                {
+                    y_start = floor[i].y;
+                    y_end   = ceiling[i].y;
+
+                    for(y = y_start; y >= y_end; y--)
+                    {
+                        path.emplace_back(Point2D(x, y));
+                    }
+
+                    if((i-1>=0)&&(std::abs(ceiling[i-1].y-ceiling[i].y)>=2))
+                    {
+                        delta = ceiling[i-1].y-ceiling[i].y;
+                        increment = delta/abs(delta);
+                        for(int k = 1; k <= abs(delta); k++)
+                        {
+                            path.emplace_back(Point2D(ceiling[i].x, ceiling[i].y+increment*(k)));
+                        }
+                    }
+
+                    if(robot_radius != 0)
+                    {
+                        for(int j = 1; j <= robot_radius+1; j++)
+                        {
+                            // 沿着ceiling从右往左
+                            if(x-j <= ceiling.front().x)
+                            {
+                                i = i + (robot_radius - (j - 1));
+                                break;
+                            }
+                            // 提前转
+                            else if((ceiling[i-(j+1)].y-ceiling[i-(j)].y>=2)
+                               &&(j+1 <= robot_radius+1)
+                               &&(j <= robot_radius+1))
+                            {
+                                delta = ceiling[i-(j+1)].y-ceiling[i-(j)].y;
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(ceiling[i-j].x, ceiling[i-j].y+increment*(k)));
+                                }
+                            }
+                                // 滞后转
+                            else if((ceiling[i-(j)].y-ceiling[i-(j+1)].y>=2)
+                                    &&(j<=robot_radius+1)
+                                    &&(j+1<=robot_radius+1))
+                            {
+                                path.emplace_back(ceiling[i-(j)]);
+
+                                delta = ceiling[i-(j+1)].y-ceiling[i-(j)].y;
+
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(ceiling[i-(j+1)].x, ceiling[i-(j+1)].y+abs(delta)+increment*(k)));
+                                }
+                            }
+                            else
+                            {
+                                path.emplace_back(ceiling[i-j]);
+                            }
+
+                        }
+                    }
+
+                    reverse = !reverse;
+                }
+                else
+                {
+                    y_start = ceiling[i].y;
+                    y_end   = floor[i].y;
+
+                    for (y = y_start; y <= y_end; y++)
+                    {
+                        path.emplace_back(Point2D(x, y));
+                    }
+
+                    if((i-1>=0)&&(std::abs(floor[i-1].y-floor[i].y)>=2))
+                    {
+                        delta = floor[i-1].y-floor[i].y;
+                        increment = delta/abs(delta);
+                        for(int k = 1; k <= abs(delta); k++)
+                        {
+                            path.emplace_back(Point2D(floor[i].x, floor[i].y+increment*(k)));
+                        }
+                    }
+
+                    if(robot_radius != 0)
+                    {
+                        for(int j = 1; j <= robot_radius+1; j++)
+                        {
+                            // 沿着floor从右往左
+                            if(x-j <= floor.front().x)
+                            {
+                                i = i + (robot_radius - (j - 1));
+                                break;
+                            }
+                            //提前转
+                            else if((floor[i-(j)].y-floor[i-(j+1)].y>=2)
+                               &&(j<=robot_radius+1)
+                               &&(j+1<=robot_radius+1))
+                            {
+                                delta = floor[i-(j+1)].y-floor[i-(j)].y;
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(floor[i-(j)].x, floor[i-(j)].y+increment*(k)));
+                                }
+                            }
+                                //滞后转
+                            else if((floor[i-(j+1)].y-floor[i-(j)].y>=2)
+                                    &&(j+1<=robot_radius+1)
+                                    &&(j<=robot_radius+1))
+                            {
+                                path.emplace_back(Point2D(floor[i-(j)].x, floor[i-(j)].y));
+
+                                delta = floor[i-(j+1)].y-floor[i-(j)].y;
+
+                                increment = delta/abs(delta);
+                                for(int k = 0; k <= abs(delta); k++)
+                                {
+                                    path.emplace_back(Point2D(floor[i-(j+1)].x, floor[i-(j+1)].y-abs(delta) +increment*(k)));
+                                }
+                            }
+                            else
+                            {
+                                path.emplace_back(floor[i-(j)]);
+                            }
+
+                        }
+                    }
+
+                    reverse = !reverse;
+                }
+            }
+        }
+    }
+
+}
+
+std::deque<Point2D> GetBoustrophedonPath(const CellGraph& cell_graph, int cell_index, int corner_indicator, int robot_radius)
+{
+    std::deque<Point2D> path;
+    AppendBoustrophedonPath(cell_graph, cell_index, corner_indicator, robot_radius, path);
+    return path;
+}
+
+std::vector<Event> InitializeEventList(const Polygon& polygon, int polygon_index)
+{
+    std::vector<Event> event_list;
+
+    for(const auto& point : polygon)
+    {
+        event_list.emplace_back(Event(polygon_index, point.x, point.y));
+    }
+
+    return event_list;
+}
+
+/** 查表确定事件类型 **/
+/** 先把多边形按x相同的连续顶点做游程编码, 游程端点的类型由(前一游程在左/右, 后一游程在左/右, 端点朝向)查表得到, **/
+/** 游程内部的点为MIDDLE; 再沿多边形走一遍, 夹在in与out之间的点标记为ceiling或floor **/
+
+namespace
+{
+// 游程端点朝向: 单点游程; 端点比游程内的相邻点及游程另一端之外的点都高(TOP)或都低(BOTTOM); 其余
+const int SINGLE_VERTEX = 0;
+const int END_TOP = 1;
+const int END_BOTTOM = 2;
+const int END_MIXED = 3;
+
+enum EventSide
+{
+    NO_SIDE,
+    IN_SIDE,
+    OUT_SIDE
+};
+
+class EventTypeEntry
+{
+public:
+    EventType type;
+    // 向外一侧的相邻像素仍在障碍物内(或仍在墙内)时的类型
+    EventType inner_type;
+    EventSide side;
+};
+
+const EventTypeEntry no_event_entry = {UNALLOCATED, UNALLOCATED, NO_SIDE};
+
+// 下标依次为[前一游程在右侧][后一游程在右侧][端点朝向]
+const EventTypeEntry obstacle_event_table[2][2][4] =
+{
+    {
+        {{OUT, INNER_OUT, OUT_SIDE}, {OUT_TOP, INNER_OUT_TOP, OUT_SIDE}, {OUT_BOTTOM, INNER_OUT_BOTTOM, OUT_SIDE}, no_event_entry},
+        {no_event_entry, no_event_entry, no_event_entry, no_event_entry}
+    },
+    {
+        {no_event_entry, no_event_entry, no_event_entry, no_event_entry},
+        {{IN, INNER_IN, IN_SIDE}, {IN_TOP, INNER_IN_TOP, IN_SIDE}, {IN_BOTTOM, INNER_IN_BOTTOM, IN_SIDE}, no_event_entry}
+    }
+};
+
+const EventTypeEntry wall_event_table[2][2][4] =
+{
+    {
+        {{OUT_EX, INNER_OUT_EX, OUT_SIDE}, {OUT_TOP_EX, INNER_OUT_TOP_EX, OUT_SIDE}, {OUT_BOTTOM_EX, INNER_OUT_BOTTOM_EX, OUT_SIDE}, no_event_entry},
+        {no_event_entry, no_event_entry, no_event_entry, no_event_entry}
+    },
+    {
+        {no_event_entry, no_event_entry, no_event_entry, no_event_entry},
+        {{IN_EX, INNER_IN_EX, IN_SIDE}, {IN_TOP_EX, INNER_IN_TOP_EX, IN_SIDE}, {IN_BOTTOM_EX, INNER_IN_BOTTOM_EX, IN_SIDE}, no_event_entry}
+    }
+};
+
+int RunEndOrientation(const std::vector<Event>& event_list, int end_index, int inner_index, int far_index)
+{
+    int y = event_list[end_index].y;
+    if(y < event_list[inner_index].y && y < event_list[far_index].y)
+    {
+        return END_TOP;
+    }
+    if(y > event_list[inner_index].y && y > event_list[far_index].y)
+    {
+        return END_BOTTOM;
+    }
+    return END_MIXED;
+}
+
+// 同一x上相邻的两个ceiling(floor)只保留一个
+void FilterCeilingFloorPair(std::vector<Event>& event_list, int first_index, int second_index)
+{
+    Event& first = event_list[first_index];
+    Event& second = event_list[second_index];
+
+    if(first.event_type==CEILING && second.event_type==CEILING && first.x==second.x)
+    {
+        if(first.y > second.y)
+        {
+            second.event_type = MIDDLE;
+        }
+        else
+        {
+            first.event_type = MIDDLE;
+        }
+    }
+    if(first.event_type==FLOOR && second.event_type==FLOOR && first.x==second.x)
+    {
+        if(first.y < second.y)
+        {
+            second.event_type = MIDDLE;
+        }
+        else
+        {
+            first.event_type = MIDDLE;
+        }
+    }
+}
+
+void AllocateEventType(const cv::Mat& map, std::vector<Event>& event_list, const EventTypeEntry (&event_table)[2][2][4],
+                       const cv::Vec3b& inner_color, EventType in_out_chain_type, EventType out_in_chain_type)
+{
+    int N = event_list.size();
+    if(N == 0)
+    {
+        return;
+    }
+
+    // 找到一个游程的起点, 所有顶点x相同时没有事件
+    int run_start = 0;
+    while(run_start < N && event_list[run_start].x == event_list[(run_start+N-1)%N].x)
+    {
+        run_start++;
+    }
+    if(run_start == N)
+    {
+        for(auto& event : event_list)
+        {
+            event.event_type = MIDDLE;
+        }
+        return;
+    }
+
+    std::vector<char> event_sides(N, NO_SIDE);
+    int first_event_index = INT_MAX;
+
+    auto allocate = [&](int index, const EventTypeEntry& entry)
+    {
+        Event& event = event_list[index];
+        event.event_type = entry.type;
+        if(entry.side == NO_SIDE)
+        {
+            return;
+        }
+
+        int neighbor_x = entry.side == IN_SIDE ? event.x-1 : event.x+1;
+        if(neighbor_x >= 0 && neighbor_x < map.cols && map.at<cv::Vec3b>(event.y, neighbor_x) == inner_color)
+        {
+            event.event_type = entry.inner_type;
+        }
+        event_sides[index] = entry.side;
+        first_event_index = std::min(first_event_index, index);
+    };
+
+    // 逐个游程查表
+    for(int offset = 0; offset < N; )
+    {
+        int first = (run_start + offset) % N;
+        int length = 1;
+        while(event_list[(first+length)%N].x == event_list[first].x)
+        {
+            length++;
+        }
+        int last = (first + length - 1) % N;
+        int before = (first + N - 1) % N;
+        int after = (first + length) % N;
+
+        int x = event_list[first].x;
+        int entry_right = event_list[before].x > x ? 1 : 0;
+        int exit_right = event_list[after].x > x ? 1 : 0;
+
+        if(length == 1)
+        {
+            allocate(first, event_table[entry_right][exit_right][SINGLE_VERTEX]);
+        }
+        else
+        {
+            allocate(first, event_table[entry_right][exit_right][RunEndOrientation(event_list, first, (first+1)%N, after)]);
+            for(int i = 1; i < length-1; i++)
+            {
+                event_list[(first+i)%N].event_type = MIDDLE;
+            }
+            allocate(last, event_table[entry_right][exit_right][RunEndOrientation(event_list, last, (last+N-1)%N, before)]);
+        }
+
+        offset += length;
+    }
+
+    if(first_event_index == INT_MAX)
+    {
+        return;
+    }
+
+    // 从第一个事件出发绕多边形一周, 两个相邻事件之间的点在in->out之间或out->in之间时分别标记
+    std::vector<int> ceiling_floor_indices;
+    std::vector<int> pending_indices;
+    EventSide last_side = EventSide(event_sides[first_event_index]);
+
+    for(int offset = 1; offset <= N; offset++)
+    {
+        int index = (first_event_index + offset) % N;
+
+        if(event_sides[index] == NO_SIDE)
+        {
+            if(event_list[index].event_type != MIDDLE)
+            {
+                pending_indices.emplace_back(index);
+            }
+            continue;
+        }
+
+        EventSide curr_side = EventSide(event_sides[index]);
+        EventType chain_type = UNALLOCATED;
+        if(last_side == IN_SIDE && curr_side == OUT_SIDE)
+        {
+            chain_type = in_out_chain_type;
+        }
+        if(last_side == OUT_SIDE && curr_side == IN_SIDE)
+        {
+            chain_type = out_in_chain_type;
+        }
+
+        if(chain_type != UNALLOCATED)
+        {
+            for(auto pending_index : pending_indices)
+            {
+                event_list[pending_index].event_type = chain_type;
+                ceiling_floor_indices.emplace_back(pending_index);
+            }
+        }
+        pending_indices.clear();
+        last_side = curr_side;
+    }
+
+    if(ceiling_floor_indices.empty())
+    {
+        return;
+    }
+
+    for(int i = 0; i < int(ceiling_floor_indices.size())-1; i++)
+    {
+        FilterCeilingFloorPair(event_list, ceiling_floor_indices[i], ceiling_floor_indices[i+1]);
+    }
+    FilterCeilingFloorPair(event_list, ceiling_floor_indices.back(), ceiling_floor_indices.front());
+}
+}
+
+void AllocateObstacleEventType(const cv::Mat& map, std::vector<Event>& event_list)
+{
+    // 障碍物内部为黑色
+    AllocateEventType(map, event_list, obstacle_event_table, cv::Vec3b(0,0,0), CEILING, FLOOR);
+}
+
+void AllocateWallEventType(const cv::Mat& map, std::vector<Event>& event_list)
+{
+    // 墙外为白色, ceiling与floor的方向与障碍物相反
+    AllocateEventType(map, event_list, wall_event_table, cv::Vec3b(255,255,255), FLOOR, CEILING);
+}
+
+// 各障碍物的事件表已分别有序, 用小根堆做k路归并
+std::vector<Event> MergeEventLists(const std::vector<std::vector<Event>>& event_lists)
+{
+    size_t event_num = 0;
+    for(const auto& event_list : event_lists)
+    {
+        event_num += event_list.size();
+    }
+
+    std::vector<Event> merged_list;
+    merged_list.reserve(event_num);
+
+    // 堆中存放(所在表的下标, 表内位置)
+    std::vector<std::pair<int, int>> heads;
+    for(int i = 0; i < int(event_lists.size()); i++)
+    {
+        if(!event_lists[i].empty())
+        {
+            heads.emplace_back(std::make_pair(i, 0));
+        }
+    }
+
+    auto greater_head = [&event_lists](const std::pair<int, int>& h1, const std::pair<int, int>& h2)
+    {
+        return event_lists[h2.first][h2.second] < event_lists[h1.first][h1.second];
+    };
+    std::make_heap(heads.begin(), heads.end(), greater_head);
+
+    while(!heads.empty())
+    {
+        std::pop_heap(heads.begin(), heads.end(), greater_head);
+        std::pair<int, int>& head = heads.back();
+        merged_list.emplace_back(event_lists[head.first][head.second]);
+
+        head.second++;
+        if(head.second < int(event_lists[head.first].size()))
+        {
+            std::push_heap(heads.begin(), heads.end(), greater_head);
+        }
+        else
+        {
+            heads.pop_back();
+        }
+    }
+
+    return merged_list;
+}
+
+std::vector<Event> GenerateObstacleEventList(const cv::Mat& map, const PolygonList& polygons)
+{
+    BCD_PROFILE_SCOPE("GenerateObstacleEventList");
+
+    std::vector<std::vector<Event>> event_sublists(polygons.size());
+
+    // 各障碍物之间互不影响, 分别在线程池中分类并排序
+    DefaultThreadPool().ParallelFor(int(polygons.size()), [&](int i)
+    {
+        event_sublists[i] = InitializeEventList(polygons[i], i);
+        AllocateObstacleEventType(map, event_sublists[i]);
+        std::sort(event_sublists[i].begin(), event_sublists[i].end());
+    });
+
+#ifdef BCD_PROFILING
+    for(const auto& event_sublist : event_sublists)
+    {
+        BCD_PROFILE_SAMPLE("events_per_polygon", event_sublist.size());
+    }
+#endif
+
+    return MergeEventLists(event_sublists);
+}
+
+std::vector<Event> GenerateWallEventList(const cv::Mat& map, const Polygon& external_contour)
+{
+    BCD_PROFILE_SCOPE("GenerateWallEventList");
+
+    std::vector<Event> event_list;
+
+    event_list = InitializeEventList(external_contour, INT_MAX);
+    AllocateWallEventType(map, event_list);
+    BCD_PROFILE_COUNT("wall_events", event_list.size());
+    std::sort(event_list.begin(), event_list.end());
+
+    return event_list;
+}
+
+SliceList SliceListGenerator(const std::vector<Event>& wall_event_list, const std::vector<Event>& obstacle_event_list)
+{
+    BCD_PROFILE_SCOPE("SliceListGenerator");
+
+    SliceList slice_list;
+    slice_list.events.reserve(wall_event_list.size()+obstacle_event_list.size());
+
+    // 两个事件表都已有序, 线性归并, 同时丢弃MIDDLE与UNALLOCATED, 每遇到新的x就结束上一个slice
+    auto obstacle_iter = obstacle_event_list.begin();
+    auto wall_iter = wall_event_list.begin();
+
+    while(obstacle_iter != obstacle_event_list.end() || wall_iter != wall_event_list.end())
+    {
+        const Event* event;
+        if(wall_iter == wall_event_list.end() || (obstacle_iter != obstacle_event_list.end() && !(*wall_iter < *obstacle_iter)))
+        {
+            event = &(*obstacle_iter);
+            ++obstacle_iter;
+        }
+        else
+        {
+            event = &(*wall_iter);
+            ++wall_iter;
+        }
+
+        if(event->event_type==MIDDLE || event->event_type==UNALLOCATED)
+        {
+            continue;
+        }
+
+        if(!slice_list.events.empty() && event->x != slice_list.events.back().x)
+        {
+            slice_list.slice_offsets.emplace_back(int(slice_list.events.size()));
+        }
+        slice_list.events.emplace_back(*event);
+    }
+    if(!slice_list.events.empty())
+    {
+        slice_list.slice_offsets.emplace_back(int(slice_list.events.size()));
+    }
+    BCD_PROFILE_COUNT("slices", slice_list.size());
+
+    return slice_list;
+}
+
+void ExecuteOpenOperation(std::vector<CellNode>& cell_graph, int curr_cell_idx, Point2D in, Point2D c, Point2D f, bool rewrite = false)
+{
+    BCD_PROFILE_CELLS("ExecuteOpenOperation.cells", cell_graph);
+
+    CellNode top_cell, bottom_cell;
+
+    top_cell.ceiling.emplace_back(c);
+    top_cell.floor.emplace_back(in);
+
+    bottom_cell.ceiling.emplace_back(in);
+    bottom_cell.floor.emplace_back(f);
+
+    if(!rewrite)
+    {
+        int top_cell_index = cell_graph.size();
+        int bottom_cell_index = cell_graph.size() + 1;
+
+        top_cell.cellIndex = top_cell_index;
+        bottom_cell.cellIndex = bottom_cell_index;
+        cell_graph.emplace_back(top_cell);
+        cell_graph.emplace_back(bottom_cell);
+
+
+        cell_graph[top_cell_index].neighbor_indices.emplace_back(curr_cell_idx);
+        cell_graph[bottom_cell_index].neighbor_indices.emplace_front(curr_cell_idx);
+
+        cell_graph[curr_cell_idx].neighbor_indices.emplace_front(top_cell_index);
+        cell_graph[curr_cell_idx].neighbor_indices.emplace_front(bottom_cell_index);
+    }
+    else
+    {
+        cell_graph[curr_cell_idx].ceiling.assign(top_cell.ceiling.begin(), top_cell.ceiling.end());
+        cell_graph[curr_cell_idx].floor.assign(top_cell.floor.begin(), top_cell.floor.end());
+
+        int bottom_cell_index = cell_graph.size();
+        bottom_cell.cellIndex = bottom_cell_index;
+        cell_graph.emplace_back(bottom_cell);
+
+        cell_graph[cell_graph[curr_cell_idx].neighbor_indices.back()].neighbor_indices.emplace_back(bottom_cell_index);
+        cell_graph[bottom_cell_index].neighbor_indices.emplace_back(cell_graph[curr_cell_idx].neighbor_indices.back());
+
+    }
+}
+
+void ExecuteCloseOperation(std::vector<CellNode>& cell_graph, int top_cell_idx, int bottom_cell_idx, Point2D c, Point2D f, bool rewrite = false)
+{
+    BCD_PROFILE_CELLS("ExecuteCloseOperation.cells", cell_graph);
+
+    CellNode new_cell;
+
+    new_cell.ceiling.emplace_back(c);
+    new_cell.floor.emplace_back(f);
+
+    if(!rewrite)
+    {
+        int new_cell_idx = cell_graph.size();
+        new_cell.cellIndex = new_cell_idx;
+
+        cell_graph.emplace_back(new_cell);
+
+
+        cell_graph[new_cell_idx].neighbor_indices.emplace_back(top_cell_idx);
+        cell_graph[new_cell_idx].neighbor_indices.emplace_back(bottom_cell_idx);
+
+        cell_graph[top_cell_idx].neighbor_indices.emplace_front(new_cell_idx);
+        cell_graph[bottom_cell_idx].neighbor_indices.emplace_back(new_cell_idx);
+    }
+    else
+    {
+        cell_graph[top_cell_idx].ceiling.assign(new_cell.ceiling.begin(), new_cell.ceiling.end());
+        cell_graph[top_cell_idx].floor.assign(new_cell.floor.begin(), new_cell.floor.end());
+
+        cell_graph[top_cell_idx].neighbor_indices.emplace_back(bottom_cell_idx);
+        cell_graph[bottom_cell_idx].neighbor_indices.emplace_back(top_cell_idx);
+    }
+
+}
+
+void ExecuteCeilOperation(std::vector<CellNode>& cell_graph, int curr_cell_idx, const Point2D& ceil_point)
+{
+    cell_graph[curr_cell_idx].ceiling.emplace_back(ceil_point);
+}
+
+void ExecuteFloorOperation(std::vector<CellNode>& cell_graph, int curr_cell_idx, const Point2D& floor_point)
+{
+    cell_graph[curr_cell_idx].floor.emplace_back(floor_point);
+}
+
+void ExecuteOpenOperation(std::vector<CellNode>& cell_graph, int curr_cell_idx, Point2D in_top, Point2D in_bottom, Point2D c, Point2D f, bool rewrite = false)
+{
+    BCD_PROFILE_CELLS("ExecuteOpenOperation.cells", cell_graph);
+
+    CellNode top_cell, bottom_cell;
+
+    top_cell.ceiling.emplace_back(c);
+    top_cell.floor.emplace_back(in_top);
+
+    bottom_cell.ceiling.emplace_back(in_bottom);
+    bottom_cell.floor.emplace_back(f);
+
+
+    if(!rewrite)
+    {
+        int top_cell_index = cell_graph.size();
+        int bottom_cell_index = cell_graph.size() + 1;
+
+        top_cell.cellIndex = top_cell_index;
+        bottom_cell.cellIndex = bottom_cell_index;
+        cell_graph.emplace_back(top_cell);
+        cell_graph.emplace_back(bottom_cell);
+
+
+        cell_graph[top_cell_index].neighbor_indices.emplace_back(curr_cell_idx);
+        cell_graph[bottom_cell_index].neighbor_indices.emplace_front(curr_cell_idx);
+
+        cell_graph[curr_cell_idx].neighbor_indices.emplace_front(top_cell_index);
+        cell_graph[curr_cell_idx].neighbor_indices.emplace_front(bottom_cell_index);
+    }
+    else
+    {
+        cell_graph[curr_cell_idx].ceiling.assign(top_cell.ceiling.begin(), top_cell.ceiling.end());
+        cell_graph[curr_cell_idx].floor.assign(top_cell.floor.begin(), top_cell.floor.end());
+
+        int bottom_cell_index = cell_graph.size();
+        bottom_cell.cellIndex = bottom_cell_index;
+        cell_graph.emplace_back(bottom_cell);
+
+        cell_graph[cell_graph[curr_cell_idx].neighbor_indices.back()].neighbor_indices.emplace_back(bottom_cell_index);
+        cell_graph[bottom_cell_index].neighbor_indices.emplace_back(cell_graph[curr_cell_idx].neighbor_indices.back());
+    }
+
+}
+
+void ExecuteInnerOpenOperation(std::vector<CellNode>& cell_graph, Point2D inner_in)
+{
+    BCD_PROFILE_CELLS("ExecuteInnerOpenOperation.cells", cell_graph);
+
+    CellNode new_cell;
+
+    new_cell.ceiling.emplace_back(inner_in);
+    new_cell.floor.emplace_back(inner_in);
+
+    int new_cell_index = cell_graph.size();
+
+    new_cell.cellIndex = new_cell_index;
+    cell_graph.emplace_back(new_cell);
+}
+
+void ExecuteInnerOpenOperation(std::vector<CellNode>& cell_graph, Point2D inner_in_top, Point2D inner_in_bottom)
+{
+    BCD_PROFILE_CELLS("ExecuteInnerOpenOperation.cells", cell_graph);
+
+    CellNode new_cell;
+
+    new_cell.ceiling.emplace_back(inner_in_top);
+    new_cell.floor.emplace_back(inner_in_bottom);
+
+    int new_cell_index = cell_graph.size();
+
+    new_cell.cellIndex = new_cell_index;
+    cell_graph.emplace_back(new_cell);
+}
+
+void ExecuteInnerCloseOperation(std::vector<CellNode>& cell_graph, int curr_cell_idx, Point2D inner_out)
+{
+    cell_graph[curr_cell_idx].ceiling.emplace_back(inner_out);
+    cell_graph[curr_cell_idx].floor.emplace_back(inner_out);
+}
+
+void ExecuteInnerCloseOperation(std::vector<CellNode>& cell_graph, int curr_cell_idx, Point2D inner_out_top, Point2D inner_out_bottom)
+{
+    cell_graph[curr_cell_idx].ceiling.emplace_back(inner_out_top);
+    cell_graph[curr_cell_idx].floor.emplace_back(inner_out_bottom);
+}
+
+int CountCells(const SliceView& slice, int curr_idx)
+{
+    int cell_num = 0;
+    for(int i = 0; i < curr_idx; i++)
+    {
+        if(
+              (slice[i].event_type==IN)
+           || (slice[i].event_type==IN_TOP)
+           || (slice[i].event_type==INNER_IN)
+           || (slice[i].event_type==INNER_IN_BOTTOM)
+           || (slice[i].event_type==FLOOR)
+           || (slice[i].event_type==IN_BOTTOM_EX)
+           || (slice[i].event_type==INNER_IN_EX)
+           || (slice[i].event_type==INNER_IN_TOP_EX)
+          )
+        {
+            cell_num++;
+        }
+    }
+    return cell_num;
+}
+
+// 从first_slice扫描到end_slice(不含), cell_index_slice为扫描开始时的活动cell
+// ceiling或floor事件找不到对应的活动cell时返回false(条带的占位cell数与实际的活动cell数不一致)
+bool DecomposeSliceRange(std::vector<CellNode>& cell_graph, std::vector<int>& cell_index_slice, std::vector<int>& original_cell_index_slice, const SliceList& slice_list, int first_slice, int end_slice)
+{
+    int curr_cell_idx = INT_MAX;
+    int top_cell_idx = INT_MAX;
+    int bottom_cell_idx = INT_MAX;
+
+    Point2D c, f;
+    int c_index = INT_MAX, f_index = INT_MAX;
+    int min_dist = INT_MAX;
+
+    int event_y = INT_MAX;
+
+    bool rewrite = false;
+
+    std::vector<int> sub_cell_index_slices;
+    // 事件本身只读, 是否已被处理记录在这里
+    std::vector<char> used_flags;
+
+    int cell_counter = 0;
+
+    for(int i = first_slice; i < end_slice; i++)
+    {
+        SliceView curr_slice = slice_list[i];
+        used_flags.assign(curr_slice.size(), false);
+
+        original_cell_index_slice.assign(cell_index_slice.begin(), cell_index_slice.end());
+
+        for(int j = 0; j < curr_slice.size(); j++)
+        {
+            if(curr_slice[j].event_type == INNER_IN_EX)
+            {
+                event_y = curr_slice[j].y;
+                for(int k = 0; k < cell_index_slice.size(); k++)
+                {
+                    if(event_y > cell_graph[cell_index_slice[k]].ceiling.back().y && event_y < cell_graph[cell_index_slice[k]].floor.back().y)
+                    {
+                        rewrite = std::find(original_cell_index_slice.begin(), original_cell_index_slice.end(), cell_index_slice[k])==original_cell_index_slice.end(); // 若为true，则覆盖
+
+                        min_dist = INT_MAX;
+                        for(int m = 0; m < curr_slice.size(); m++)
+                        {
+                            if(abs(curr_slice[m].y-cell_graph[cell_index_slice[k]].ceiling.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[m].y-cell_graph[cell_index_slice[k]].ceiling.back().y);
+                                c_index = m;
+                                c = Point2D(curr_slice[m].x, curr_slice[m].y);
+                            }
+                        }
+                        used_flags[c_index] = true;
+
+                        min_dist = INT_MAX;
+                        for(int n = 0; n < curr_slice.size(); n++)
+                        {
+                            if(abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y);
+                                f_index = n;
+                                f = Point2D(curr_slice[n].x, curr_slice[n].y);
+                            }
+                        }
+                        used_flags[f_index] = true;
+
+                        curr_cell_idx = cell_index_slice[k];
+                        ExecuteOpenOperation(cell_graph, curr_cell_idx,
+                                                          Point2D(curr_slice[j].x, curr_slice[j].y),
+                                                          c,
+                                                          f,
+                                                          rewrite);
+
+                        if(!rewrite)
+                        {
+                            cell_index_slice.erase(cell_index_slice.begin()+k);
+                            sub_cell_index_slices.clear();
+                            sub_cell_index_slices = {int(cell_graph.size()-2), int(cell_graph.size()-1)};
+                            cell_index_slice.insert(cell_index_slice.begin()+k, sub_cell_index_slices.begin(), sub_cell_index_slices.end());
+                        }
+                        else
+                        {
+                            cell_index_slice.insert(cell_index_slice.begin()+k+1, int(cell_graph.size()-1));
+                        }
+
+                        used_flags[j] = true;
+
+                        break;
+                    }
+                }
+            }
+            if(curr_slice[j].event_type == INNER_OUT_EX)
+            {
+                event_y = curr_slice[j].y;
+                for(int k = 1; k < cell_index_slice.size(); k++)
+                {
+                    if(event_y > cell_graph[cell_index_slice[k-1]].ceiling.back().y && event_y < cell_graph[cell_index_slice[k]].floor.back().y)
+                    {
+                        rewrite = std::find(original_cell_index_slice.begin(), original_cell_index_slice.end(), cell_index_slice[k-1]) == original_cell_index_slice.end();
+
+                        min_dist = INT_MAX;
+                        for(int m = 0; m < curr_slice.size(); m++)
+                        {
+                            if(abs(curr_slice[m].y - cell_graph[cell_index_slice[k-1]].ceiling.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[m].y - cell_graph[cell_index_slice[k-1]].ceiling.back().y);
+                                c_index = m;
+                                c = Point2D(curr_slice[m].x, curr_slice[m].y);
+                            }
+                        }
+                        used_flags[c_index] = true;
+
+                        min_dist = INT_MAX;
+                        for(int n = 0; n < curr_slice.size(); n++)
+                        {
+                            if(abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y);
+                                f_index = n;
+                                f = Point2D(curr_slice[n].x, curr_slice[n].y);
+                            }
+                        }
+                        used_flags[f_index] = true;
+
+                        top_cell_idx = cell_index_slice[k-1];
+                        bottom_cell_idx = cell_index_slice[k];
+
+                        ExecuteCloseOperation(cell_graph, top_cell_idx, bottom_cell_idx,
+                                                           c,
+                                                           f,
+                                                           rewrite);
+
+                        if(!rewrite)
+                        {
+                            cell_index_slice.erase(cell_index_slice.begin() + k - 1);
+                            cell_index_slice.erase(cell_index_slice.begin() + k - 1);
+                            cell_index_slice.insert(cell_index_slice.begin() + k - 1, int(cell_graph.size() - 1));
+                        }
+                        else
+                        {
+                            cell_index_slice.erase(cell_index_slice.begin() + k);
+                        }
+
+
+                        used_flags[j] = true;
+
+                        break;
+                    }
+                }
+            }
+
+            if(curr_slice[j].event_type == INNER_IN_BOTTOM_EX)
+            {
+                event_y = curr_slice[j].y;
+                for(int k = 0; k < cell_index_slice.size(); k++)
+                {
+                    if(event_y > cell_graph[cell_index_slice[k]].ceiling.back().y && event_y < cell_graph[cell_index_slice[k]].floor.back().y)
+                    {
+                        rewrite = std::find(original_cell_index_slice.begin(), original_cell_index_slice.end(), cell_index_slice[k])==original_cell_index_slice.end();
+
+                        min_dist = INT_MAX;
+                        for(int m = 0; m < curr_slice.size(); m++)
+                        {
+                            if(abs(curr_slice[m].y - cell_graph[cell_index_slice[k]].ceiling.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[m].y - cell_graph[cell_index_slice[k]].ceiling.back().y);
+                                c_index = m;
+                                c = Point2D(curr_slice[m].x, curr_slice[m].y);
+                            }
+                        }
+                        used_flags[c_index] = true;
+
+                        min_dist = INT_MAX;
+                        for(int n = 0; n < curr_slice.size(); n++)
+                        {
+                            if(abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y);
+                                f_index = n;
+                                f = Point2D(curr_slice[n].x, curr_slice[n].y);
+                            }
+                        }
+                        used_flags[f_index] = true;
+
+                        curr_cell_idx = cell_index_slice[k];
+                        ExecuteOpenOperation(cell_graph, curr_cell_idx,
+                                                          Point2D(curr_slice[j-1].x, curr_slice[j-1].y),  // in top
+                                                          Point2D(curr_slice[j].x, curr_slice[j].y),      // in bottom
+                                                          c,
+                                                          f,
+                                                          rewrite);
+
+
+                        if(!rewrite)
+                        {
+                            cell_index_slice.erase(cell_index_slice.begin() + k);
+                            sub_cell_index_slices.clear();
+                            sub_cell_index_slices = {int(cell_graph.size() - 2), int(cell_graph.size() - 1)};
+                            cell_index_slice.insert(cell_index_slice.begin() + k, sub_cell_index_slices.begin(),
+                                                    sub_cell_index_slices.end());
+                        }
+                        else
+                        {
+                            cell_index_slice.insert(cell_index_slice.begin()+k+1, int(cell_graph.size()-1));
+                        }
+
+                        used_flags[j-1] = true;
+                        used_flags[j] = true;
+
+                        break;
+                    }
+                }
+            }
+
+
+            if(curr_slice[j].event_type == INNER_OUT_BOTTOM_EX)
+            {
+                event_y = curr_slice[j].y;
+                for(int k = 1; k < cell_index_slice.size(); k++)
+                {
+                    if(event_y > cell_graph[cell_index_slice[k-1]].ceiling.back().y && event_y < cell_graph[cell_index_slice[k]].floor.back().y)
+                    {
+                        rewrite = std::find(original_cell_index_slice.begin(), original_cell_index_slice.end(), cell_index_slice[k-1]) == original_cell_index_slice.end();
+
+                        min_dist = INT_MAX;
+                        for(int m = 0; m < curr_slice.size(); m++)
+                        {
+                            if(abs(curr_slice[m].y - cell_graph[cell_index_slice[k-1]].ceiling.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[m].y - cell_graph[cell_index_slice[k-1]].ceiling.back().y);
+                                c_index = m;
+                                c = Point2D(curr_slice[m].x, curr_slice[m].y);
+                            }
+                        }
+                        used_flags[c_index] = true;
+
+                        min_dist = INT_MAX;
+                        for(int n = 0; n < curr_slice.size(); n++)
+                        {
+                            if(abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y);
+                                f_index = n;
+                                f = Point2D(curr_slice[n].x, curr_slice[n].y);
+                            }
+                        }
+                        used_flags[f_index] = true;
+
+                        top_cell_idx = cell_index_slice[k-1];
+                        bottom_cell_idx = cell_index_slice[k];
+                        ExecuteCloseOperation(cell_graph, top_cell_idx, bottom_cell_idx,
+                                                           c,
+                                                           f,
+                                                           rewrite);
+
+                        if(!rewrite)
+                        {
+                            cell_index_slice.erase(cell_index_slice.begin()+k-1);
+                            cell_index_slice.erase(cell_index_slice.begin()+k-1);
+                            cell_index_slice.insert(cell_index_slice.begin()+k-1, int(cell_graph.size()-1));
+                        }
+                        else
+                        {
+                            cell_index_slice.erase(cell_index_slice.begin() + k);
+                        }
+
+                        used_flags[j-1] = true;
+                        used_flags[j] = true;
+
+                        break;
+                    }
+                }
+            }
+
+
+            if(curr_slice[j].event_type == IN_EX)
+            {
+                event_y = curr_slice[j].y;
+
+                if(!cell_index_slice.empty())
+                {
+                    for(int k = 1; k < cell_index_slice.size(); k++)
+                    {
+                        if(event_y >= cell_graph[cell_index_slice[k-1]].floor.back().y && event_y <= cell_graph[cell_index_slice[k]].ceiling.back().y)
+                        {
+                            ExecuteInnerOpenOperation(cell_graph, Point2D(curr_slice[j].x, curr_slice[j].y));  // inner_in
+                            cell_index_slice.insert(cell_index_slice.begin()+k, int(cell_graph.size()-1));
+                            used_flags[j] = true;
+                            break;
+                        }
+                    }
+                    if(event_y <= cell_graph[cell_index_slice.front()].ceiling.back().y)
+                    {
+                        ExecuteInnerOpenOperation(cell_graph, Point2D(curr_slice[j].x, curr_slice[j].y));  // inner_in
+                        cell_index_slice.insert(cell_index_slice.begin(), int(cell_graph.size()-1));
+                        used_flags[j] = true;
+                    }
+                    if(event_y >= cell_graph[cell_index_slice.back()].floor.back().y)
+                    {
+                        ExecuteInnerOpenOperation(cell_graph, Point2D(curr_slice[j].x, curr_slice[j].y));  // inner_in
+                        cell_index_slice.insert(cell_index_slice.end(), int(cell_graph.size()-1));
+                        used_flags[j] = true;
+                    }
+
+                }
+                else
+                {
+                    ExecuteInnerOpenOperation(cell_graph, Point2D(curr_slice[j].x, curr_slice[j].y));  // inner_in
+                    cell_index_slice.emplace_back(int(cell_graph.size()-1));
+                    used_flags[j] = true;
+                }
+
+            }
+
+            if(curr_slice[j].event_type == IN_BOTTOM_EX)
+            {
+                event_y = curr_slice[j].y;
+
+                if(!cell_index_slice.empty())
+                {
+                    for(int k = 1; k < cell_index_slice.size(); k++)
+                    {
+                        if(event_y >= cell_graph[cell_index_slice[k-1]].floor.back().y && event_y <= cell_graph[cell_index_slice[k]].ceiling.back().y)
+                        {
+
+                            ExecuteInnerOpenOperation(cell_graph, Point2D(curr_slice[j-1].x, curr_slice[j-1].y), // inner_in_top,
+                                                         Point2D(curr_slice[j].x, curr_slice[j].y));    // inner_in_bottom
+
+                            cell_index_slice.insert(cell_index_slice.begin()+k, int(cell_graph.size()-1));
+
+                            used_flags[j-1] = true;
+                            used_flags[j] = true;
+
+                            break;
+                        }
+                    }
+                    if(event_y <= cell_graph[cell_index_slice.front()].ceiling.back().y)
+                    {
+
+                        ExecuteInnerOpenOperation(cell_graph, Point2D(curr_slice[j-1].x, curr_slice[j-1].y), // inner_in_top,
+                                                     Point2D(curr_slice[j].x, curr_slice[j].y));    // inner_in_bottom
+
+                        cell_index_slice.insert(cell_index_slice.begin(), int(cell_graph.size()-1));
+
+                        used_flags[j-1] = true;
+                        used_flags[j] = true;
+                    }
+                    if(event_y >= cell_graph[cell_index_slice.back()].floor.back().y)
+                    {
+
+                        ExecuteInnerOpenOperation(cell_graph, Point2D(curr_slice[j-1].x, curr_slice[j-1].y), // inner_in_top,
+                                                     Point2D(curr_slice[j].x, curr_slice[j].y));    // inner_in_bottom
+
+                        cell_index_slice.insert(cell_index_slice.end(), int(cell_graph.size()-1));
+
+                        used_flags[j-1] = true;
+                        used_flags[j] = true;
+                    }
+                }
+                else
+                {
+                    ExecuteInnerOpenOperation(cell_graph, Point2D(curr_slice[j-1].x, curr_slice[j-1].y), // inner_in_top,
+                                                 Point2D(curr_slice[j].x, curr_slice[j].y));    // inner_in_bottom
+
+                    cell_index_slice.emplace_back(int(cell_graph.size()-1));
+
+                    used_flags[j-1] = true;
+                    used_flags[j] = true;
+                }
+
+            }
+
+
+            if(curr_slice[j].event_type == OUT_EX)
+            {
+                event_y = curr_slice[j].y;
+
+                for(int k = 0; k < cell_index_slice.size(); k++)
+                {
+                    if(event_y >= cell_graph[cell_index_slice[k]].ceiling.back().y && event_y <= cell_graph[cell_index_slice[k]].floor.back().y)
+                    {
+                        curr_cell_idx = cell_index_slice[k];
+                        ExecuteInnerCloseOperation(cell_graph, curr_cell_idx, Point2D(curr_slice[j].x, curr_slice[j].y));  // inner_out
+                        cell_index_slice.erase(cell_index_slice.begin()+k);
+                        used_flags[j] = true;
+                        break;
+                    }
+                }
+            }
+
+            if(curr_slice[j].event_type == OUT_BOTTOM_EX)
+            {
+                event_y = curr_slice[j].y;
+
+                for(int k = 0; k < cell_index_slice.size(); k++)
+                {
+                    if(event_y >= cell_graph[cell_index_slice[k]].ceiling.back().y && event_y <= cell_graph[cell_index_slice[k]].floor.back().y)
+                    {
+                        curr_cell_idx = cell_index_slice[k];
+                        ExecuteInnerCloseOperation(cell_graph, curr_cell_idx, Point2D(curr_slice[j-1].x, curr_slice[j-1].y), Point2D(curr_slice[j].x, curr_slice[j].y));  // inner_out_top, inner_out_bottom
+                        cell_index_slice.erase(cell_index_slice.begin()+k);
+                        used_flags[j-1] = true;
+                        used_flags[j] = true;
+                        break;
+                    }
+                }
+            }
+
+        }
+
+
+        for(int j = 0; j < curr_slice.size(); j++)
+        {
+            if(curr_slice[j].event_type == IN)
+            {
+                event_y = curr_slice[j].y;
+                for(int k = 0; k < cell_index_slice.size(); k++)
+                {
+                    if(event_y > cell_graph[cell_index_slice[k]].ceiling.back().y && event_y < cell_graph[cell_index_slice[k]].floor.back().y)
+                    {
+                        rewrite = std::find(original_cell_index_slice.begin(), original_cell_index_slice.end(), cell_index_slice[k])==original_cell_index_slice.end(); // 若为true，则覆盖
+
+                        min_dist = INT_MAX;
+                        for(int m = 0; m < curr_slice.size(); m++)
+                        {
+                            if(abs(curr_slice[m].y-cell_graph[cell_index_slice[k]].ceiling.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[m].y-cell_graph[cell_index_slice[k]].ceiling.back().y);
+                                c_index = m;
+                                c = Point2D(curr_slice[m].x, curr_slice[m].y);
+                            }
+                        }
+                        used_flags[c_index] = true;
+
+                        min_dist = INT_MAX;
+                        for(int n = 0; n < curr_slice.size(); n++)
+                        {
+                            if(abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y);
+                                f_index = n;
+                                f = Point2D(curr_slice[n].x, curr_slice[n].y);
+                            }
+                        }
+                        used_flags[f_index] = true;
+
+                        curr_cell_idx = cell_index_slice[k];
+                        ExecuteOpenOperation(cell_graph, curr_cell_idx,
+                                             Point2D(curr_slice[j].x, curr_slice[j].y),
+                                             c,
+                                             f,
+                                             rewrite);
+
+                        if(!rewrite)
+                        {
+                            cell_index_slice.erase(cell_index_slice.begin()+k);
+                            sub_cell_index_slices.clear();
+                            sub_cell_index_slices = {int(cell_graph.size()-2), int(cell_graph.size()-1)};
+                            cell_index_slice.insert(cell_index_slice.begin()+k, sub_cell_index_slices.begin(), sub_cell_index_slices.end());
+                        }
+                        else
+                        {
+                            cell_index_slice.insert(cell_index_slice.begin()+k+1, int(cell_graph.size()-1));
+                        }
+
+                        used_flags[j] = true;
+
+                        break;
+                    }
+                }
+            }
+            if(curr_slice[j].event_type == OUT)
+            {
+                event_y = curr_slice[j].y;
+                for(int k = 1; k < cell_index_slice.size(); k++)
+                {
+                    if(event_y > cell_graph[cell_index_slice[k-1]].ceiling.back().y && event_y < cell_graph[cell_index_slice[k]].floor.back().y)
+                    {
+                        rewrite = std::find(original_cell_index_slice.begin(), original_cell_index_slice.end(), cell_index_slice[k-1]) == original_cell_index_slice.end();
+
+                        min_dist = INT_MAX;
+                        for(int m = 0; m < curr_slice.size(); m++)
+                        {
+                            if(abs(curr_slice[m].y - cell_graph[cell_index_slice[k-1]].ceiling.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[m].y - cell_graph[cell_index_slice[k-1]].ceiling.back().y);
+                                c_index = m;
+                                c = Point2D(curr_slice[m].x, curr_slice[m].y);
+                            }
+                        }
+                        used_flags[c_index] = true;
+
+                        min_dist = INT_MAX;
+                        for(int n = 0; n < curr_slice.size(); n++)
+                        {
+                            if(abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y);
+                                f_index = n;
+                                f = Point2D(curr_slice[n].x, curr_slice[n].y);
+                            }
+                        }
+                        used_flags[f_index] = true;
+
+                        top_cell_idx = cell_index_slice[k-1];
+                        bottom_cell_idx = cell_index_slice[k];
+
+                        ExecuteCloseOperation(cell_graph, top_cell_idx, bottom_cell_idx,
+                                              c,
+                                              f,
+                                              rewrite);
+
+                        if(!rewrite)
+                        {
+                            cell_index_slice.erase(cell_index_slice.begin() + k - 1);
+                            cell_index_slice.erase(cell_index_slice.begin() + k - 1);
+                            cell_index_slice.insert(cell_index_slice.begin() + k - 1, int(cell_graph.size() - 1));
+                        }
+                        else
+                        {
+                            cell_index_slice.erase(cell_index_slice.begin() + k);
+                        }
+
+
+                        used_flags[j] = true;
+
+                        break;
+                    }
+                }
+            }
+
+            if(curr_slice[j].event_type == IN_BOTTOM)
+            {
+                event_y = curr_slice[j].y;
+                for(int k = 0; k < cell_index_slice.size(); k++)
+                {
+                    if(event_y > cell_graph[cell_index_slice[k]].ceiling.back().y && event_y < cell_graph[cell_index_slice[k]].floor.back().y)
+                    {
+                        rewrite = std::find(original_cell_index_slice.begin(), original_cell_index_slice.end(), cell_index_slice[k])==original_cell_index_slice.end();
+
+                        min_dist = INT_MAX;
+                        for(int m = 0; m < curr_slice.size(); m++)
+                        {
+                            if(abs(curr_slice[m].y - cell_graph[cell_index_slice[k]].ceiling.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[m].y - cell_graph[cell_index_slice[k]].ceiling.back().y);
+                                c_index = m;
+                                c = Point2D(curr_slice[m].x, curr_slice[m].y);
+                            }
+                        }
+                        used_flags[c_index] = true;
+
+                        min_dist = INT_MAX;
+                        for(int n = 0; n < curr_slice.size(); n++)
+                        {
+                            if(abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y);
+                                f_index = n;
+                                f = Point2D(curr_slice[n].x, curr_slice[n].y);
+                            }
+                        }
+                        used_flags[f_index] = true;
+
+                        curr_cell_idx = cell_index_slice[k];
+                        ExecuteOpenOperation(cell_graph, curr_cell_idx,
+                                             Point2D(curr_slice[j-1].x, curr_slice[j-1].y),  // in top
+                                             Point2D(curr_slice[j].x, curr_slice[j].y),      // in bottom
+                                             c,
+                                             f,
+                                             rewrite);
+
+
+                        if(!rewrite)
+                        {
+                            cell_index_slice.erase(cell_index_slice.begin() + k);
+                            sub_cell_index_slices.clear();
+                            sub_cell_index_slices = {int(cell_graph.size() - 2), int(cell_graph.size() - 1)};
+                            cell_index_slice.insert(cell_index_slice.begin() + k, sub_cell_index_slices.begin(),
+                                                    sub_cell_index_slices.end());
+                        }
+                        else
+                        {
+                            cell_index_slice.insert(cell_index_slice.begin()+k+1, int(cell_graph.size()-1));
+                        }
+
+                        used_flags[j-1] = true;
+                        used_flags[j] = true;
+
+                        break;
+                    }
+                }
+            }
+
+
+            if(curr_slice[j].event_type == OUT_BOTTOM)
+            {
+                event_y = curr_slice[j].y;
+                for(int k = 1; k < cell_index_slice.size(); k++)
+                {
+                    if(event_y > cell_graph[cell_index_slice[k-1]].ceiling.back().y && event_y < cell_graph[cell_index_slice[k]].floor.back().y)
+                    {
+                        rewrite = std::find(original_cell_index_slice.begin(), original_cell_index_slice.end(), cell_index_slice[k-1]) == original_cell_index_slice.end();
+
+                        min_dist = INT_MAX;
+                        for(int m = 0; m < curr_slice.size(); m++)
+                        {
+                            if(abs(curr_slice[m].y - cell_graph[cell_index_slice[k-1]].ceiling.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[m].y - cell_graph[cell_index_slice[k-1]].ceiling.back().y);
+                                c_index = m;
+                                c = Point2D(curr_slice[m].x, curr_slice[m].y);
+                            }
+                        }
+                        used_flags[c_index] = true;
+
+                        min_dist = INT_MAX;
+                        for(int n = 0; n < curr_slice.size(); n++)
+                        {
+                            if(abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y)<min_dist)
+                            {
+                                min_dist = abs(curr_slice[n].y - cell_graph[cell_index_slice[k]].floor.back().y);
+                                f_index = n;
+                                f = Point2D(curr_slice[n].x, curr_slice[n].y);
+                            }
+                        }
+                        used_flags[f_index] = true;
+
+                        top_cell_idx = cell_index_slice[k-1];
+                        bottom_cell_idx = cell_index_slice[k];
+                        ExecuteCloseOperation(cell_graph, top_cell_idx, bottom_cell_idx,
+                                              c,
+                                              f,
+                                              rewrite);
+
+                        if(!rewrite)
+                        {
+                            cell_index_slice.erase(cell_index_slice.begin()+k-1);
+                            cell_index_slice.erase(cell_index_slice.begin()+k-1);
+                            cell_index_slice.insert(cell_index_slice.begin()+k-1, int(cell_graph.size()-1));
+                        }
+                        else
+                        {
+                            cell_index_slice.erase(cell_index_slice.begin() + k);
+                        }
+
+                        used_flags[j-1] = true;
+                        used_flags[j] = true;
+
+                        break;
+                    }
+                }
+            }
+
+
+            if(curr_slice[j].event_type == INNER_IN)
+            {
+                event_y = curr_slice[j].y;
+                for(int k = 1; k < cell_index_slice.size(); k++)
+                {
+                    if(event_y >= cell_graph[cell_index_slice[k-1]].floor.back().y && event_y <= cell_graph[cell_index_slice[k]].ceiling.back().y)
+                    {
+                        ExecuteInnerOpenOperation(cell_graph, Point2D(curr_slice[j].x, curr_slice[j].y));  // inner_in
+                        cell_index_slice.insert(cell_index_slice.begin()+k, int(cell_graph.size()-1));
+                        used_flags[j] = true;
+                        break;
+                    }
+                }
+            }
+
+            if(curr_slice[j].event_type == INNER_IN_BOTTOM)
+            {
+                event_y = curr_slice[j].y;
+                for(int k = 1; k < cell_index_slice.size(); k++)
+                {
+                    if(event_y >= cell_graph[cell_index_slice[k-1]].floor.back().y && event_y <= cell_graph[cell_index_slice[k]].ceiling.back().y)
+                    {
+
+                        ExecuteInnerOpenOperation(cell_graph, Point2D(curr_slice[j-1].x, curr_slice[j-1].y), // inner_in_top,
+                                                  Point2D(curr_slice[j].x, curr_slice[j].y));    // inner_in_bottom
+
+                        cell_index_slice.insert(cell_index_slice.begin()+k, int(cell_graph.size()-1));
+
+                        used_flags[j-1] = true;
+                        used_flags[j] = true;
+
+                        break;
+                    }
+                }
+            }
+
+
+            if(curr_slice[j].event_type == INNER_OUT)
+            {
+                event_y = curr_slice[j].y;
+                for(int k = 0; k < cell_index_slice.size(); k++)
+                {
+                    if(event_y >= cell_graph[cell_index_slice[k]].ceiling.back().y && event_y <= cell_graph[cell_index_slice[k]].floor.back().y)
+                    {
+                        curr_cell_idx = cell_index_slice[k];
+                        ExecuteInnerCloseOperation(cell_graph, curr_cell_idx, Point2D(curr_slice[j].x, curr_slice[j].y));  // inner_out
+                        cell_index_slice.erase(cell_index_slice.begin()+k);
+                        used_flags[j] = true;
+                        break;
+                    }
+                }
+            }
+
+            if(curr_slice[j].event_type == INNER_OUT_BOTTOM)
+            {
+                event_y = curr_slice[j].y;
+                for(int k = 0; k < cell_index_slice.size(); k++)
+                {
+                    if(event_y >= cell_graph[cell_index_slice[k]].ceiling.back().y && event_y <= cell_graph[cell_index_slice[k]].floor.back().y)
+                    {
+                        curr_cell_idx = cell_index_slice[k];
+                        ExecuteInnerCloseOperation(cell_graph, curr_cell_idx, Point2D(curr_slice[j-1].x, curr_slice[j-1].y), Point2D(curr_slice[j].x, curr_slice[j].y));  // inner_out_top, inner_out_bottom
+                        cell_index_slice.erase(cell_index_slice.begin()+k);
+                        used_flags[j-1] = true;
+                        used_flags[j] = true;
+                        break;
+                    }
+                }
+            }
+
+        }
+
+        for(int j = 0; j < curr_slice.size(); j++)
+        {
+            if(curr_slice[j].event_type == CEILING)
+            {
+                cell_counter = CountCells(curr_slice,j);
+                if(cell_counter >= int(cell_index_slice.size()))
+                {
+                    return false;
+                }
+                curr_cell_idx = cell_index_slice[cell_counter];
+                if(!used_flags[j])
+                {
+                    ExecuteCeilOperation(cell_graph, curr_cell_idx, Point2D(curr_slice[j].x, curr_slice[j].y));
+                }
+            }
+            if(curr_slice[j].event_type == FLOOR)
+            {
+                cell_counter = CountCells(curr_slice,j);
+                if(cell_counter >= int(cell_index_slice.size()))
+                {
+                    return false;
+                }
+                curr_cell_idx = cell_index_slice[cell_counter];
+                if(!used_flags[j])
+                {
+                    ExecuteFloorOperation(cell_graph, curr_cell_idx, Point2D(curr_slice[j].x, curr_slice[j].y));
+                }
+            }
+        }
+
+        BCD_PROFILE_SAMPLE("active_cells_per_slice", cell_index_slice.size());
+    }
+    return true;
+}
+
+void ExecuteCellDecomposition(std::vector<CellNode>& cell_graph, std::vector<int>& cell_index_slice, std::vector<int>& original_cell_index_slice, const SliceList& slice_list)
+{
+    BCD_PROFILE_SCOPE("ExecuteCellDecomposition");
+
+    DecomposeSliceRange(cell_graph, cell_index_slice, original_cell_index_slice, slice_list, 0, slice_list.size());
+
+    BCD_PROFILE_COUNT("cells", cell_graph.size());
+}
+
+void ExecuteCellDecomposition(std::vector<CellNode>& cell_graph, CellGraph& flat_cell_graph, std::vector<int>& cell_index_slice, std::vector<int>& original_cell_index_slice, const SliceList& slice_list)
+{
+    ExecuteCellDecomposition(cell_graph, cell_index_slice, original_cell_index_slice, slice_list);
+
+    BCD_PROFILE_SCOPE("BuildCellGraph");
+    flat_cell_graph.Assign(cell_graph);
+}
+
+/** 按竖直条带并行分解 **/
+/** 只在"稳定"的slice处切分: 该slice只有成对的ceiling/floor, 扫描到这里时每个活动cell恰好对应一对事件, 不会新建或合并cell; **/
+/** 每个条带用占位cell代替这些活动cell独立扫描, 最后按条带顺序把占位cell并回前一条带的活动cell, 其余cell的编号顺延 **/
+
+namespace
+{
+
+// 占位cell的邻居表中用这个值标记前一条带已有的邻居插入的位置
+const int seam_neighbor_placeholder = -1;
+
+bool IsStableSlice(const SliceView& slice)
+{
+    if(slice.empty() || slice.size() % 2 != 0)
+    {
+        return false;
+    }
+    for(int i = 0; i < slice.size(); i++)
+    {
+        if(slice[i].event_type != (i % 2 == 0 ? CEILING : FLOOR))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+void ExecuteStripedCellDecomposition(std::vector<CellNode>& cell_graph, const SliceList& slice_list, int stripe_num)
+{
+    BCD_PROFILE_SCOPE("ExecuteStripedCellDecomposition");
+
+    cell_graph.clear();
+
+    if(stripe_num <= 0)
+    {
+        stripe_num = DefaultThreadPool().Size() + 1;
+    }
+
+    // 按事件数均分, 第k个切分点取事件累计数达到k/stripe_num之后的第一个稳定slice
+    std::vector<int> stripe_begins = {0};
+    long long event_num = slice_list.events.size();
+    for(int i = 1; i < slice_list.size() && int(stripe_begins.size()) < stripe_num; i++)
+    {
+        if(slice_list.slice_offsets[i] * (long long)stripe_num >= event_num * (long long)stripe_begins.size() && IsStableSlice(slice_list[i]))
+        {
+            stripe_begins.emplace_back(i);
+        }
+    }
+    stripe_begins.emplace_back(slice_list.size());
+
+    int stripe_count = int(stripe_begins.size()) - 1;
+
+    if(stripe_count <= 1)
+    {
+        std::vector<int> cell_index_slice, original_cell_index_slice;
+        DecomposeSliceRange(cell_graph, cell_index_slice, original_cell_index_slice, slice_list, 0, slice_list.size());
+        BCD_PROFILE_COUNT("cells", cell_graph.size());
+        return;
+    }
+
+    std::vector<std::vector<CellNode>> stripe_graphs(stripe_count);
+    std::vector<std::vector<int>> stripe_end_slices(stripe_count);  // 每个条带扫描结束时的活动cell
+    std::vector<int> seed_nums(stripe_count, 0);
+    std::vector<char> stripe_completed(stripe_count, 0);  // 各条带并行写入, 不用vector<bool>
+
+    DefaultThreadPool().ParallelFor(stripe_count, [&](int stripe)
+    {
+        std::vector<CellNode>& stripe_graph = stripe_graphs[stripe];
+        std::vector<int> cell_index_slice, original_cell_index_slice;
+
+        if(stripe > 0)
+        {
+            seed_nums[stripe] = slice_list[stripe_begins[stripe]].size() / 2;
+            for(int k = 0; k < seed_nums[stripe]; k++)
+            {
+                CellNode seed_cell;
+                seed_cell.cellIndex = k;
+                seed_cell.neighbor_indices.emplace_back(seam_neighbor_placeholder);
+                stripe_graph.emplace_back(seed_cell);
+                cell_index_slice.emplace_back(k);
+            }
+        }
+
+        stripe_completed[stripe] = DecomposeSliceRange(stripe_graph, cell_index_slice, original_cell_index_slice, slice_list, stripe_begins[stripe], stripe_begins[stripe+1]);
+        stripe_end_slices[stripe] = cell_index_slice;
+    });
+
+    // 条带中途找不到活动cell, 或占位cell的数目与前一条带结束时的活动cell数不一致, 说明切分点并不稳定, 退回单线程扫描
+    for(int stripe = 0; stripe < stripe_count; stripe++)
+    {
+        if(!stripe_completed[stripe] || (stripe > 0 && seed_nums[stripe] != int(stripe_end_slices[stripe-1].size())))
+        {
+            std::vector<int> cell_index_slice, original_cell_index_slice;
+            DecomposeSliceRange(cell_graph, cell_index_slice, original_cell_index_slice, slice_list, 0, slice_list.size());
+            BCD_PROFILE_COUNT("cells", cell_graph.size());
+            return;
+        }
+    }
+
+    // 上一条带结束时活动cell的全局编号
+    std::vector<int> seam_cell_indices;
+    std::vector<int> global_indices;
+
+    for(int stripe = 0; stripe < stripe_count; stripe++)
+    {
+        std::vector<CellNode>& stripe_graph = stripe_graphs[stripe];
+        int seed_num = seed_nums[stripe];
+        int cell_offset = int(cell_graph.size()) - seed_num;
+
+        global_indices.resize(stripe_graph.size());
+        for(int i = 0; i < int(stripe_graph.size()); i++)
+        {
+            global_indices[i] = i < seed_num ? seam_cell_indices[i] : cell_offset + i;
+        }
+
+        for(int i = 0; i < int(stripe_graph.size()); i++)
+        {
+            CellNode& cell = stripe_graph[i];
+            for(auto& neighbor_index : cell.neighbor_indices)
+            {
+                if(neighbor_index != seam_neighbor_placeholder)
+                {
+                    neighbor_index = global_indices[neighbor_index];
+                }
+            }
+
+            if(i < seed_num)
+            {
+                // 占位cell的点接在原cell之后, 原有邻居放回占位的位置
+                CellNode& seam_cell = cell_graph[global_indices[i]];
+                seam_cell.ceiling.insert(seam_cell.ceiling.end(), cell.ceiling.begin(), cell.ceiling.end());
+                seam_cell.floor.insert(seam_cell.floor.end(), cell.floor.begin(), cell.floor.end());
+
+                auto placeholder = std::find(cell.neighbor_indices.begin(), cell.neighbor_indices.end(), seam_neighbor_placeholder);
+                std::deque<int> neighbor_indices(cell.neighbor_indices.begin(), placeholder);
+                neighbor_indices.insert(neighbor_indices.end(), seam_cell.neighbor_indices.begin(), seam_cell.neighbor_indices.end());
+                neighbor_indices.insert(neighbor_indices.end(), placeholder+1, cell.neighbor_indices.end());
+                seam_cell.neighbor_indices.swap(neighbor_indices);
+            }
+            else
+            {
+                cell.cellIndex = global_indices[i];
+                cell_graph.emplace_back(std::move(cell));
+            }
+        }
+
+        seam_cell_indices.resize(stripe_end_slices[stripe].size());
+        for(int k = 0; k < int(stripe_end_slices[stripe].size()); k++)
+        {
+            seam_cell_indices[k] = global_indices[stripe_end_slices[stripe][k]];
+        }
+        std::vector<CellNode>().swap(stripe_graph);
+    }
+
+    BCD_PROFILE_COUNT("stripes", stripe_count);
+    BCD_PROFILE_COUNT("cells", cell_graph.size());
+}
+
+void ExecuteStripedCellDecomposition(std::vector<CellNode>& cell_graph, CellGraph& flat_cell_graph, const SliceList& slice_list, int stripe_num)
+{
+    ExecuteStripedCellDecomposition(cell_graph, slice_list, stripe_num);
+
+    BCD_PROFILE_SCOPE("BuildCellGraph");
+    flat_cell_graph.Assign(cell_graph);
+}
+
+Point2D FindNextEntrance(const Point2D& curr_point, const CellGraph& cell_graph, int next_cell_index, int& corner_indicator)
+{
+    Point2D next_entrance;
+
+    CellEdgeView ceiling = cell_graph.Ceiling(next_cell_index);
+    CellEdgeView floor = cell_graph.Floor(next_cell_index);
+
+    int front_x = ceiling.front().x;
+    int back_x = ceiling.back().x;
+
+    Point2D corner_points[4] = {ceiling.front(), floor.front(), floor.back(), ceiling.back()};
+
+    if(abs(curr_point.x - front_x) < abs(curr_point.x - back_x))
+    {
+        if(abs(curr_point.y - ceiling.front().y)<abs(curr_point.y - floor.front().y))
+        {
+            next_entrance = corner_points[TOPLEFT];
+            corner_indicator = TOPLEFT;
+        }
+        else
+        {
+            next_entrance = corner_points[BOTTOMLEFT];
+            corner_indicator = BOTTOMLEFT;
+        }
+    }
+    else
+    {
+        if(abs(curr_point.y - ceiling.back().y)<abs(curr_point.y - floor.back().y))
+        {
+            next_entrance = corner_points[TOPRIGHT];
+            corner_indicator = TOPRIGHT;
+        }
+        else
+        {
+            next_entrance = corner_points[BOTTOMRIGHT];
+            corner_indicator = BOTTOMRIGHT;
+        }
+    }
+
+    return next_entrance;
+}
+
+// cell内的路径接在inner_path的末尾
+template <typename Path>
+void AppendWalkInsideCell(const CellGraph& cell_graph, int cell_index, const Point2D& start, const Point2D& end, Path& inner_path)
+{
+    BCD_PROFILE_SCOPE("WalkInsideCell");
+
+    CellEdgeView ceiling = cell_graph.Ceiling(cell_index);
+    CellEdgeView floor = cell_graph.Floor(cell_index);
+
+    inner_path.emplace_back(start);
+
+    int start_ceiling_index_offset = start.x - ceiling.front().x;
+    int first_ceiling_delta_y = ceiling[start_ceiling_index_offset].y - start.y;
+    int end_ceiling_index_offset = end.x - ceiling.front().x;
+    int second_ceiling_delta_y = end.y - ceiling[end_ceiling_index_offset].y;
+
+    int start_floor_index_offset = start.x - floor.front().x;
+    int first_floor_delta_y = floor[start_floor_index_offset].y - start.y;
+    int end_floor_index_offset = end.x - floor.front().x;
+    int second_floor_delta_y = end.y - floor[end_floor_index_offset].y;
+
+    if((abs(first_ceiling_delta_y)+abs(second_ceiling_delta_y)) < (abs(first_floor_delta_y)+abs(second_floor_delta_y))) //to ceiling
+    {
+        int first_increment_y = 0;
+        if(first_ceiling_delta_y != 0)
+        {
+            first_increment_y = first_ceiling_delta_y / abs(first_ceiling_delta_y);
+
+            for(int i = 1; i <= abs(first_ceiling_delta_y); i++)
+            {
+                inner_path.emplace_back(Point2D(start.x, start.y+(first_increment_y*i)));
+            }
+        }
+
+        int delta_x = ceiling[end_ceiling_index_offset].x - ceiling[start_ceiling_index_offset].x;
+        int increment_x = 0;
+        if(delta_x != 0)
+        {
+            increment_x = delta_x / abs(delta_x);
+        }
+        for(int i = 0; i < abs(delta_x); i++)
+        {
+            // 提前转
+            if((ceiling[start_ceiling_index_offset+increment_x*(i+1)].y-ceiling[start_ceiling_index_offset+increment_x*(i)].y>=2)
+               &&(i+1 <= abs(delta_x))
+               &&(i <= abs(delta_x)))
+            {
+                int delta = ceiling[start_ceiling_index_offset+increment_x*(i+1)].y-ceiling[start_ceiling_index_offset+increment_x*(i)].y;
+                int increment = delta/abs(delta);
+                for(int j = 0; j <= abs(delta); j++)
+                {
+                    inner_path.emplace_back(Point2D(ceiling[start_ceiling_index_offset+increment_x*i].x, ceiling[start_ceiling_index_offset+increment_x*i].y+increment*(j)));
+                }
+            }
+            // 滞后转
+            else if((ceiling[start_ceiling_index_offset+increment_x*(i)].y-ceiling[start_ceiling_index_offset+increment_x*(i+1)].y>=2)
+                     &&(i<=abs(delta_x))
+                     &&(i+1<=abs(delta_x)))
+            {
+                inner_path.emplace_back(ceiling[start_ceiling_index_offset+increment_x*(i)]);
+
+                int delta = ceiling[start_ceiling_index_offset+increment_x*(i+1)].y-ceiling[start_ceiling_index_offset+increment_x*(i)].y;
+
+                int increment = delta/abs(delta);
+                for(int k = 0; k <= abs(delta); k++)
+                {
+                    inner_path.emplace_back(Point2D(ceiling[start_ceiling_index_offset+increment_x*(i+1)].x, ceiling[start_ceiling_index_offset+increment_x*(i+1)].y+abs(delta)+increment*(k)));
+                }
+            }
+            else
+            {
+                inner_path.emplace_back(ceiling[start_ceiling_index_offset+(increment_x*i)]);
+            }
+        }
+
+        int second_increment_y = 0;
+        if(second_ceiling_delta_y!=0)
+        {
+            second_increment_y = second_ceiling_delta_y/abs(second_ceiling_delta_y);
+
+            for(int i = 1; i <= abs(second_ceiling_delta_y); i++)
+            {
+                inner_path.emplace_back(Point2D(ceiling[end_ceiling_index_offset].x, ceiling[end_ceiling_index_offset].y+(second_increment_y*i)));
+            }
+        }
+
+    }
+    else // to floor
+    {
+        int first_increment_y = 0;
+        if(first_floor_delta_y != 0)
+        {
+            first_increment_y = first_floor_delta_y / abs(first_floor_delta_y);
+
+            for(int i = 1; i <= abs(first_floor_delta_y); i++)
+            {
+                inner_path.emplace_back(Point2D(start.x, start.y+(first_increment_y*i)));
+            }
+        }
+
+        int delta_x = floor[end_floor_index_offset].x - floor[start_floor_index_offset].x;
+        int increment_x = 0;
+        if(delta_x != 0)
+        {
+            increment_x = delta_x / abs(delta_x);
+        }
+        for(int i = 0; i < abs(delta_x); i++)
+        {
+            //提前转
+            if((floor[start_floor_index_offset+increment_x*(i)].y-floor[start_floor_index_offset+increment_x*(i+1)].y>=2)
+               &&(i<=abs(delta_x))
+               &&(i+1<=abs(delta_x)))
+            {
+                int delta = floor[start_floor_index_offset+increment_x*(i+1)].y-floor[start_floor_index_offset+increment_x*(i)].y;
+                int increment = delta/abs(delta);
+                for(int j = 0; j <= abs(delta); j++)
+                {
+                    inner_path.emplace_back(Point2D(floor[start_floor_index_offset+increment_x*(i)].x, floor[start_floor_index_offset+increment_x*(i)].y+increment*(j)));
+                }
+            }
+            //滞后转
+            else if((floor[start_floor_index_offset+increment_x*(i+1)].y-floor[start_floor_index_offset+increment_x*(i)].y>=2)
+                    &&(i+1<=abs(delta_x))
+                    &&(i<=abs(delta_x)))
+            {
+                inner_path.emplace_back(Point2D(floor[start_floor_index_offset+increment_x*(i)].x, floor[start_floor_index_offset+increment_x*(i)].y));
+
+                int delta = floor[start_floor_index_offset+increment_x*(i+1)].y-floor[start_floor_index_offset+increment_x*(i)].y;
+
+                int increment = delta/abs(delta);
+                for(int k = 0; k <= abs(delta); k++)
+                {
+                    inner_path.emplace_back(Point2D(floor[start_floor_index_offset+increment_x*(i+1)].x, floor[start_floor_index_offset+increment_x*(i+1)].y-abs(delta) +increment*(k)));
+                }
+            }
+            else
+            {
+                inner_path.emplace_back(floor[start_floor_index_offset+(increment_x*i)]);
+            }
+
+        }
+
+        int second_increment_y = 0;
+        if(second_floor_delta_y!=0)
+        {
+            second_increment_y = second_floor_delta_y/abs(second_floor_delta_y);
+
+            for(int i = 1; i <= abs(second_floor_delta_y); i++)
+            {
+                inner_path.emplace_back(Point2D(floor[end_floor_index_offset].x, floor[end_floor_index_offset].y+(second_increment_y*i)));
+            }
+        }
+    }
+}
+
+std::deque<Point2D> WalkInsideCell(const CellGraph& cell_graph, int cell_index, const Point2D& start, const Point2D& end)
+{
+    std::deque<Point2D> inner_path;
+    AppendWalkInsideCell(cell_graph, cell_index, start, end, inner_path);
+    return inner_path;
+}
+
+// 连接路径分为当前cell内与下一个cell内两段, 分别接在两个容器的末尾; 两段先后写入, 传入同一个容器时即为整条连接路径
+template <typename Path>
+void AppendLinkingPath(const Point2D& curr_exit, Point2D& next_entrance, int& corner_indicator, const CellGraph& cell_graph, int curr_cell_index, int next_cell_index,
+                       Path& path_in_curr_cell, Path& path_in_next_cell)
+{
+    BCD_PROFILE_SCOPE("FindLinkingPath");
+
+    CellEdgeView curr_ceiling = cell_graph.Ceiling(curr_cell_index);
+    CellEdgeView curr_floor = cell_graph.Floor(curr_cell_index);
+
+    int exit_corner_indicator = INT_MAX;
+    Point2D exit = FindNextEntrance(next_entrance, cell_graph, curr_cell_index, exit_corner_indicator);
+    AppendWalkInsideCell(cell_graph, curr_cell_index, curr_exit, exit, path_in_curr_cell);
+
+    next_entrance = FindNextEntrance(exit, cell_graph, next_cell_index, corner_indicator);
+
+    int delta_x = next_entrance.x - exit.x;
+    int delta_y = next_entrance.y - exit.y;
+
+    int increment_x = 0;
+    int increment_y = 0;
+
+    if (delta_x != 0) {
+        increment_x = delta_x / std::abs(delta_x);
+    }
+    if (delta_y != 0) {
+        increment_y = delta_y / std::abs(delta_y);
+    }
+
+    int upper_bound = INT_MIN;
+    int lower_bound = INT_MAX;
+
+    if (exit.x >= curr_ceiling.back().x)
+    {
+        upper_bound = curr_ceiling.back().y;
+        lower_bound = curr_floor.back().y;
+    }
+    if (exit.x <= curr_ceiling.front().x)
+    {
+        upper_bound = curr_ceiling.front().y;
+        lower_bound = curr_floor.front().y;
+    }
+
+    if ((next_entrance.y >= upper_bound) && (next_entrance.y <= lower_bound))
+    {
+        for (int y = exit.y; y != next_entrance.y; y += increment_y) {
+            path_in_curr_cell.emplace_back(Point2D(exit.x, y));
+        }
+        for (int x = exit.x; x != next_entrance.x; x += increment_x) {
+            path_in_curr_cell.emplace_back(Point2D(x, next_entrance.y));
+        }
+    }
+    else
+    {
+        for (int x = exit.x; x != next_entrance.x; x += increment_x) {
+            path_in_curr_cell.emplace_back(Point2D(x, exit.y));
+        }
+        for (int y = exit.y; y != next_entrance.y; y += increment_y) {
+            path_in_next_cell.emplace_back(Point2D(next_entrance.x, y));
+        }
+    }
+
+}
+
+std::deque<std::deque<Point2D>> FindLinkingPath(const Point2D& curr_exit, Point2D& next_entrance, int& corner_indicator, const CellGraph& cell_graph, int curr_cell_index, int next_cell_index)
+{
+    std::deque<std::deque<Point2D>> path(2);
+    AppendLinkingPath(curr_exit, next_entrance, corner_indicator, cell_graph, curr_cell_index, next_cell_index, path.front(), path.back());
+    return path;
+}
+
+// 跨越cell_path中的各cell, 路径接在overall_path的末尾
+template <typename Path>
+void AppendWalkCrossCells(const CellGraph& cell_graph, const std::deque<int>& cell_path, const Point2D& start, const Point2D& end, int robot_radius, Path& overall_path)
+{
+    BCD_PROFILE_SCOPE("WalkCrossCells");
+
+    Point2D curr_exit, next_entrance;
+    int curr_corner_indicator, next_corner_indicator;
+
+    next_entrance = FindNextEntrance(start, cell_graph, cell_path[1], next_corner_indicator);
+    curr_exit = FindNextEntrance(next_entrance, cell_graph, cell_path[0], curr_corner_indicator);
+    AppendWalkInsideCell(cell_graph, cell_path[0], start, curr_exit, overall_path);
+
+    // 连接路径的两段先后写入, 直接接在overall_path上
+    AppendLinkingPath(curr_exit, next_entrance, next_corner_indicator, cell_graph, cell_path[0], cell_path[1], overall_path, overall_path);
+
+    curr_corner_indicator = next_corner_indicator;
+
+
+    for(int i = 1; i < cell_path.size()-1; i++)
+    {
+        AppendBoustrophedonPath(cell_graph, cell_path[i], curr_corner_indicator, robot_radius, overall_path);
+
+        curr_exit = overall_path.back();
+        next_entrance = FindNextEntrance(curr_exit, cell_graph, cell_path[i+1], next_corner_indicator);
+
+        AppendLinkingPath(curr_exit, next_entrance, next_corner_indicator, cell_graph, cell_path[i], cell_path[i+1], overall_path, overall_path);
+
+        curr_corner_indicator = next_corner_indicator;
+    }
+
+    AppendWalkInsideCell(cell_graph, cell_path.back(), next_entrance, end, overall_path);
+}
+
+std::deque<Point2D> WalkCrossCells(const CellGraph& cell_graph, const std::deque<int>& cell_path, const Point2D& start, const Point2D& end, int robot_radius)
+{
+    std::deque<Point2D> overall_path;
+    AppendWalkCrossCells(cell_graph, cell_path, start, end, robot_radius, overall_path);
+    return overall_path;
+}
+
+/** 广度优先搜索 **/
+std::deque<int> FindShortestPath(const CellGraph& cell_graph, const Point2D& start, const Point2D& end)
+{
+    BCD_PROFILE_SCOPE("FindShortestPath");
+
+    int start_cell_index = DetermineCellIndex(cell_graph, start).front();
+    int end_cell_index = DetermineCellIndex(cell_graph, end).front();
+
+    std::deque<int> cell_path = {end_cell_index};
+
+    if(start_cell_index == end_cell_index)
+    {
+        return cell_path;
+    }
+
+    // 搜索状态与cell graph中的规划状态分开存放
+    std::vector<char> visited(cell_graph.Size(), false);
+    std::vector<int> parent_indices(cell_graph.Size(), INT_MAX);
+
+    std::deque<int> search_queue = {start_cell_index};
+
+    int curr_cell_index;
+
+    while(!search_queue.empty())
+    {
+        curr_cell_index = search_queue.front();
+
+        visited[curr_cell_index] = true;
+        search_queue.pop_front();
+
+        for(int i = 0; i < cell_graph.NeighborCount(curr_cell_index); i++)
+        {
+            int neighbor_index = cell_graph.Neighbor(curr_cell_index, i);
+            if(neighbor_index == end_cell_index)
+            {
+                parent_indices[neighbor_index] = curr_cell_index;
+                search_queue.clear();
+                break;
+            }
+            else if(!visited[neighbor_index])
+            {
+                visited[neighbor_index] = true;
+                parent_indices[neighbor_index] = curr_cell_index;
+                search_queue.emplace_back(neighbor_index);
+            }
+        }
+
+    }
+
+    curr_cell_index = end_cell_index;
+
+    while(parent_indices[curr_cell_index] != INT_MAX)
+    {
+        curr_cell_index = parent_indices[curr_cell_index];
+        cell_path.emplace_front(curr_cell_index);
+    }
+
+    return cell_path;
+}
+
+
+
+
+/** 按转移代价优化cell的访问顺序 **/
+/** 先用最近邻构造每个cell只清扫一次的顺序, 再用2-opt与Or-opt改进, 最后用动态规划为每个cell选择入口corner **/
+
+
+namespace
+{
+
+// 非相邻cell之间需要穿过其他cell, 按曼哈顿距离的倍数估计绕行
+const int non_neighbor_detour_factor = 2;
+// 2-opt与Or-opt只在该窗口内搜索, 使改进的复杂度与cell数成线性关系
+const int sequence_search_window = 50;
+const int sequence_max_passes = 5;
+
+int ManhattanDistance(const Point2D& p1, const Point2D& p2)
+{
+    return std::abs(p1.x-p2.x) + std::abs(p1.y-p2.y);
+}
+
+bool IsNeighborCell(const CellGraph& cell_graph, int cell_index, int other_cell_index)
+{
+    for(int i = 0; i < cell_graph.NeighborCount(cell_index); i++)
+    {
+        if(cell_graph.Neighbor(cell_index, i) == other_cell_index)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 与cell顺序无关的距离, 取两个cell的corner之间的最小曼哈顿距离
+int CellDistance(const CellGraph& cell_graph, int cell_index, int other_cell_index)
+{
+    // 改进阶段会频繁调用, 不经过ComputeCellCornerPoints以免分配内存
+    CellEdgeView ceiling = cell_graph.Ceiling(cell_index);
+    CellEdgeView floor = cell_graph.Floor(cell_index);
+    CellEdgeView other_ceiling = cell_graph.Ceiling(other_cell_index);
+    CellEdgeView other_floor = cell_graph.Floor(other_cell_index);
+    Point2D corner_points[4] = {ceiling.front(), floor.front(), floor.back(), ceiling.back()};
+    Point2D other_corner_points[4] = {other_ceiling.front(), other_floor.front(), other_floor.back(), other_ceiling.back()};
+
+    int distance = INT_MAX;
+    for(const auto& corner : corner_points)
+    {
+        for(const auto& other_corner : other_corner_points)
+        {
+            distance = std::min(distance, ManhattanDistance(corner, other_corner));
+        }
+    }
+
+    if(!IsNeighborCell(cell_graph, cell_index, other_cell_index))
+    {
+        distance *= non_neighbor_detour_factor;
+    }
+    return distance;
+}
+
+// 广度优先搜索cell_index到target_cell_index经过的cell, 不含起点, 含终点
+std::vector<int> FindCellHopPath(const CellGraph& cell_graph, int cell_index, int target_cell_index)
+{
+    std::vector<int> parent_indices(cell_graph.Size(), INT_MAX);
+    std::deque<int> search_queue = {cell_index};
+    parent_indices[cell_index] = cell_index;
+
+    while(!search_queue.empty() && parent_indices[target_cell_index] == INT_MAX)
+    {
+        int curr_cell_index = search_queue.front();
+        search_queue.pop_front();
+
+        for(int i = 0; i < cell_graph.NeighborCount(curr_cell_index); i++)
+        {
+            int neighbor_index = cell_graph.Neighbor(curr_cell_index, i);
+            if(parent_indices[neighbor_index] == INT_MAX)
+            {
+                parent_indices[neighbor_index] = curr_cell_index;
+                search_queue.emplace_back(neighbor_index);
+            }
+        }
+    }
+
+    std::vector<int> hop_path;
+    if(parent_indices[target_cell_index] == INT_MAX)
+    {
+        return hop_path;
+    }
+    for(int curr_cell_index = target_cell_index; curr_cell_index != cell_index; curr_cell_index = parent_indices[curr_cell_index])
+    {
+        hop_path.emplace_back(curr_cell_index);
+    }
+    std::reverse(hop_path.begin(), hop_path.end());
+    return hop_path;
+}
+
+// 从离cell_index最近(按邻接跳数)的一层未访问cell中选出距离最小的
+// reached_stamps在多次调用间复用, 等于stamp的cell已在本次搜索中到达
+int FindNearestUnvisitedCell(const CellGraph& cell_graph, int cell_index, const std::vector<char>& sequenced, std::vector<int>& reached_stamps, int stamp)
+{
+    std::vector<int> curr_layer = {cell_index};
+    std::vector<int> next_layer;
+    reached_stamps[cell_index] = stamp;
+
+    while(!curr_layer.empty())
+    {
+        int nearest_cell_index = INT_MAX;
+        int nearest_distance = INT_MAX;
+        next_layer.clear();
+
+        for(const auto& layer_cell_index : curr_layer)
+        {
+            for(int i = 0; i < cell_graph.NeighborCount(layer_cell_index); i++)
+            {
+                int neighbor_index = cell_graph.Neighbor(layer_cell_index, i);
+                if(reached_stamps[neighbor_index] == stamp)
+                {
+                    continue;
+                }
+                reached_stamps[neighbor_index] = stamp;
+                next_layer.emplace_back(neighbor_index);
+
+                if(!sequenced[neighbor_index])
+                {
+                    int distance = CellDistance(cell_graph, cell_index, neighbor_index);
+                    if(distance < nearest_distance)
+                    {
+                        nearest_distance = distance;
+                        nearest_cell_index = neighbor_index;
+                    }
+                }
+            }
+        }
+
+        if(nearest_cell_index != INT_MAX)
+        {
+            return nearest_cell_index;
+        }
+        curr_layer.swap(next_layer);
+    }
+
+    return INT_MAX;
+}
+
+// 沿cell的ceiling或floor从start所在列走到end所在列, 相邻两列高度不同时先在内侧竖直移动
+std::deque<Point2D> WalkAlongEdge(const CellEdgeView& edge, const Point2D& start, const Point2D& end, bool along_ceiling)
+{
+    std::deque<Point2D> path = {start};
+    Point2D curr = start;
+    auto move_to_y = [&path, &curr](int y)
+    {
+        while(curr.y != y)
+        {
+            curr.y += (y > curr.y) ? 1 : -1;
+            path.emplace_back(curr);
+        }
+    };
+
+    int left_x = edge.front().x;
+    int increment_x = (end.x > start.x) ? 1 : -1;
+
+    move_to_y(edge[curr.x-left_x].y);
+    while(curr.x != end.x)
+    {
+        int curr_y = edge[curr.x-left_x].y;
+        int next_y = edge[curr.x+increment_x-left_x].y;
+        // ceiling一侧取两列中较低的点, floor一侧取较高的点
+        move_to_y(along_ceiling ? std::max(curr_y, next_y) : std::min(curr_y, next_y));
+        curr.x += increment_x;
+        path.emplace_back(curr);
+        move_to_y(next_y);
+    }
+    move_to_y(end.y);
+
+    return path;
+}
+
+// 估计从一个cell的出口走到下一个cell的指定corner的代价, 与FindLinkingPath的走法一致
+// next_corner_indicator为INT_MAX时不指定corner, 并输出FindLinkingPath自然到达的corner
+int EstimateTransitCost(const CellGraph& cell_graph, const Point2D& curr_exit, int curr_cell_index, int next_cell_index, int& next_corner_indicator)
+{
+    std::vector<Point2D> next_corner_points = ComputeCellCornerPoints(cell_graph, next_cell_index);
+
+    if(!IsNeighborCell(cell_graph, curr_cell_index, next_cell_index))
+    {
+        if(next_corner_indicator == INT_MAX)
+        {
+            FindNextEntrance(curr_exit, cell_graph, next_cell_index, next_corner_indicator);
+        }
+        return ManhattanDistance(curr_exit, next_corner_points[next_corner_indicator]) * non_neighbor_detour_factor;
+    }
+
+    int corner_indicator = INT_MAX;
+    int exit_corner_indicator = INT_MAX;
+    Point2D next_entrance = FindNextEntrance(curr_exit, cell_graph, next_cell_index, corner_indicator);
+    Point2D exit = FindNextEntrance(next_entrance, cell_graph, curr_cell_index, exit_corner_indicator);
+    next_entrance = FindNextEntrance(exit, cell_graph, next_cell_index, corner_indicator);
+
+    int cost = ManhattanDistance(curr_exit, exit) + ManhattanDistance(exit, next_entrance);
+    if(next_corner_indicator == INT_MAX)
+    {
+        next_corner_indicator = corner_indicator;
+    }
+    return cost + ManhattanDistance(next_entrance, next_corner_points[next_corner_indicator]);
+}
+
+// 按顺序为每个cell选择入口corner, 使转移代价之和最小, 返回总代价
+long long AssignEntryCorners(const CellGraph& cell_graph, const std::vector<int>& cell_sequence, const Point2D& start_point, int robot_radius, std::vector<int>& entry_corners)
+{
+    const int corner_num = 4;
+    std::vector<std::vector<long long>> costs(cell_sequence.size(), std::vector<long long>(corner_num, LLONG_MAX));
+    std::vector<std::vector<int>> prev_corners(cell_sequence.size(), std::vector<int>(corner_num, 0));
+
+    std::vector<Point2D> first_corner_points = ComputeCellCornerPoints(cell_graph, cell_sequence.front());
+    for(int corner = 0; corner < corner_num; corner++)
+    {
+        costs[0][corner] = ManhattanDistance(start_point, first_corner_points[corner]);
+    }
+
+    for(int i = 1; i < int(cell_sequence.size()); i++)
+    {
+        std::vector<Point2D> prev_corner_points = ComputeCellCornerPoints(cell_graph, cell_sequence[i-1]);
+        for(int prev_corner = 0; prev_corner < corner_num; prev_corner++)
+        {
+            Point2D prev_exit = prev_corner_points[ComputeExitCorner(cell_graph, cell_sequence[i-1], prev_corner, robot_radius)];
+            for(int corner = 0; corner < corner_num; corner++)
+            {
+                int entry_corner = corner;
+                long long cost = costs[i-1][prev_corner] + EstimateTransitCost(cell_graph, prev_exit, cell_sequence[i-1], cell_sequence[i], entry_corner);
+                if(cost < costs[i][corner])
+                {
+                    costs[i][corner] = cost;
+                    prev_corners[i][corner] = prev_corner;
+                }
+            }
+        }
+    }
+
+    int corner = int(std::min_element(costs.back().begin(), costs.back().end()) - costs.back().begin());
+    long long total_cost = costs.back()[corner];
+
+    entry_corners.assign(cell_sequence.size(), TOPLEFT);
+    for(int i = int(cell_sequence.size())-1; i >= 0; i--)
+    {
+        entry_corners[i] = corner;
+        corner = prev_corners[i][corner];
+    }
+    return total_cost;
+}
+
+bool ImproveByTwoOpt(const CellGraph& cell_graph, std::vector<int>& cell_sequence)
+{
+    bool improved = false;
+    int sequence_size = cell_sequence.size();
+
+    // 起始cell固定在首位
+    for(int i = 1; i < sequence_size-1; i++)
+    {
+        for(int j = i+1; j < std::min(sequence_size, i+sequence_search_window); j++)
+        {
+            long long delta = CellDistance(cell_graph, cell_sequence[i-1], cell_sequence[j])
+                            - CellDistance(cell_graph, cell_sequence[i-1], cell_sequence[i]);
+            if(j+1 < sequence_size)
+            {
+                delta += CellDistance(cell_graph, cell_sequence[i], cell_sequence[j+1])
+                       - CellDistance(cell_graph, cell_sequence[j], cell_sequence[j+1]);
+            }
+            if(delta < 0)
+            {
+                std::reverse(cell_sequence.begin()+i, cell_sequence.begin()+j+1);
+                improved = true;
+            }
+        }
+    }
+    return improved;
+}
+
+bool ImproveByOrOpt(const CellGraph& cell_graph, std::vector<int>& cell_sequence)
+{
+    bool improved = false;
+    int sequence_size = cell_sequence.size();
+
+    // 把长度为1到3的一段移到窗口内的其他位置
+    for(int segment_length = 1; segment_length <= 3; segment_length++)
+    {
+        for(int i = 1; i+segment_length <= sequence_size; i++)
+        {
+            int first = cell_sequence[i];
+            int last = cell_sequence[i+segment_length-1];
+            int prev = cell_sequence[i-1];
+            bool has_next = i+segment_length < sequence_size;
+            int next = has_next ? cell_sequence[i+segment_length] : INT_MAX;
+
+            long long removal_gain = CellDistance(cell_graph, prev, first);
+            if(has_next)
+            {
+                removal_gain += CellDistance(cell_graph, last, next) - CellDistance(cell_graph, prev, next);
+            }
+
+            int best_position = INT_MAX;
+            long long best_delta = 0;
+            for(int p = std::max(0, i-sequence_search_window); p < std::min(sequence_size, i+segment_length+sequence_search_window); p++)
+            {
+                // 插入到cell_sequence[p]之后, p不能落在该段及其前一位
+                if(p >= i-1 && p < i+segment_length)
+                {
+                    continue;
+                }
+                int before = cell_sequence[p];
+                bool has_after = p+1 < sequence_size;
+                int after = has_after ? cell_sequence[p+1] : INT_MAX;
+
+                long long insertion_cost = CellDistance(cell_graph, before, first);
+                if(has_after)
+                {
+                    insertion_cost += CellDistance(cell_graph, last, after) - CellDistance(cell_graph, before, after);
+                }
+
+                long long delta = insertion_cost - removal_gain;
+                if(delta < best_delta)
+                {
+                    best_delta = delta;
+                    best_position = p;
+                }
+            }
+
+            if(best_position != INT_MAX)
+            {
+                std::vector<int> segment(cell_sequence.begin()+i, cell_sequence.begin()+i+segment_length);
+                cell_sequence.erase(cell_sequence.begin()+i, cell_sequence.begin()+i+segment_length);
+                int insert_position = best_position < i ? best_position+1 : best_position+1-segment_length;
+                cell_sequence.insert(cell_sequence.begin()+insert_position, segment.begin(), segment.end());
+                improved = true;
+            }
+        }
+    }
+    return improved;
+}
+
+}
+
+// 在cell内从一个corner走到另一个corner: 在同一列时竖直走, 否则沿ceiling和floor中较短的一侧走
+std::deque<Point2D> WalkBetweenCorners(const CellGraph& cell_graph, int cell_index, int start_corner, int end_corner)
+{
+    std::vector<Point2D> corner_points = ComputeCellCornerPoints(cell_graph, cell_index);
+    Point2D start = corner_points[start_corner];
+    Point2D end = corner_points[end_corner];
+
+    if(start.x == end.x)
+    {
+        std::deque<Point2D> path = {start};
+        int increment_y = (end.y > start.y) ? 1 : -1;
+        for(int y = start.y; y != end.y; )
+        {
+            y += increment_y;
+            path.emplace_back(Point2D(start.x, y));
+        }
+        return path;
+    }
+
+    std::deque<Point2D> ceiling_path = WalkAlongEdge(cell_graph.Ceiling(cell_index), start, end, true);
+    std::deque<Point2D> floor_path = WalkAlongEdge(cell_graph.Floor(cell_index), start, end, false);
+    return (ceiling_path.size() <= floor_path.size()) ? ceiling_path : floor_path;
+}
+
+int ComputeExitCorner(const CellGraph& cell_graph, int cell_index, int corner_indicator, int robot_radius)
+{
+    // 与GetBoustrophedonPath一致: 每隔robot_radius+1列往返一次, 最后一次落在另一端的列上
+    int width = cell_graph.Width(cell_index);
+    int sweep_num = 1;
+    for(int i = 0; i < width-1; i = std::min(i+robot_radius+1, width-1))
+    {
+        sweep_num++;
+    }
+    bool odd_sweeps = (sweep_num%2 == 1);
+
+    if(corner_indicator == TOPLEFT)
+    {
+        return odd_sweeps ? BOTTOMRIGHT : TOPRIGHT;
+    }
+    if(corner_indicator == BOTTOMLEFT)
+    {
+        return odd_sweeps ? TOPRIGHT : BOTTOMRIGHT;
+    }
+    if(corner_indicator == TOPRIGHT)
+    {
+        return odd_sweeps ? BOTTOMLEFT : TOPLEFT;
+    }
+    return odd_sweeps ? TOPLEFT : BOTTOMLEFT;
+}
+
+std::vector<int> SequenceCells(const CellGraph& cell_graph, int first_cell_index, const Point2D& start_point, int robot_radius, std::vector<int>& entry_corners)
+{
+    BCD_PROFILE_SCOPE("SequenceCells");
+
+    std::vector<int> cell_sequence = {first_cell_index};
+    std::vector<char> sequenced(cell_graph.Size(), false);
+    sequenced[first_cell_index] = true;
+
+    // 最近邻构造, 只考虑连通的cell
+    std::vector<int> reached_stamps(cell_graph.Size(), -1);
+    int curr_cell_index = first_cell_index;
+    while(true)
+    {
+        int next_cell_index = FindNearestUnvisitedCell(cell_graph, curr_cell_index, sequenced, reached_stamps, int(cell_sequence.size()));
+        if(next_cell_index == INT_MAX)
+        {
+            break;
+        }
+        sequenced[next_cell_index] = true;
+        cell_sequence.emplace_back(next_cell_index);
+        curr_cell_index = next_cell_index;
+    }
+
+    for(int pass = 0; pass < sequence_max_passes; pass++)
+    {
+        bool improved = ImproveByTwoOpt(cell_graph, cell_sequence);
+        improved = ImproveByOrOpt(cell_graph, cell_sequence) || improved;
+        if(!improved)
+        {
+            break;
+        }
+    }
+
+#ifdef BCD_PROFILING
+    long long cost = AssignEntryCorners(cell_graph, cell_sequence, start_point, robot_radius, entry_corners);
+    BCD_PROFILE_COUNT("SequenceCells.cost", cost);
+#else
+    AssignEntryCorners(cell_graph, cell_sequence, start_point, robot_radius, entry_corners);
+#endif
+
+    return cell_sequence;
+}
+
+
+
+
+/** 静态路径规划流程 **/
+
+
+int ComputeRobotRadius(const double& meters_per_pix, const double& robot_size_in_meters)
+{
+    int robot_radius = int(robot_size_in_meters / meters_per_pix);
+    return robot_radius;
+}
+
+cv::Mat1b ReadMap(const std::string& map_file_path)
+{
+    cv::Mat1b original_map = cv::imread(map_file_path, CV_8U);
+    return original_map;
+}
+
+cv::Mat1b PreprocessMap(const cv::Mat1b& original_map)
+{
+    cv::Mat1b map;
+    cv::threshold(original_map, map, 128, 255, cv::THRESH_BINARY);
+    return map;
+}
+
+void ExtractRawContours(const cv::Mat& original_map, std::vector<std::vector<cv::Point>>& raw_wall_contours, std::vector<std::vector<cv::Point>>& raw_obstacle_contours)
+{
+    std::vector<std::vector<cv::Point>> contours;
+    cv::findContours(original_map.clone(), contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_NONE);
+
+    // 地图中没有空闲区域
+    if(contours.empty())
+    {
+        raw_wall_contours.clear();
+        raw_obstacle_contours.clear();
+        return;
+    }
+
+    std::vector<int> wall_cnt_indices(contours.size());
+    std::iota(wall_cnt_indices.begin(), wall_cnt_indices.end(), 0);
+
+//    std::sort(wall_cnt_indices.begin(), wall_cnt_indices.end(), [&contours](int lhs, int rhs){return contours[lhs].size() > contours[rhs].size();});
+    std::sort(wall_cnt_indices.begin(), wall_cnt_indices.end(), [&contours](int lhs, int rhs){return cv::contourArea(contours[lhs]) > cv::contourArea(contours[rhs]);});
+
+    std::vector<cv::Point> raw_wall_contour = contours[wall_cnt_indices.front()];
+    raw_wall_contours = {raw_wall_contour};
+
+    cv::Mat mask = cv::Mat(original_map.size(), original_map.type(), 255);
+    cv::fillPoly(mask, raw_wall_contours, 0);
+
+    cv::Mat base = original_map.clone();
+    base += mask;
+    cv::threshold(base, base, 128, 255, cv::THRESH_BINARY_INV);
+
+    cv::findContours(base, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_NONE);
+
+    raw_obstacle_contours = contours;
+}
+
+cv::Mat1f ComputeObstacleDistanceField(const cv::Mat& original_map, const std::vector<std::vector<cv::Point>>& wall_contours, const std::vector<std::vector<cv::Point>>& obstacle_contours)
+{
+    BCD_PROFILE_SCOPE("ComputeObstacleDistanceField");
+
+    // 墙内为空闲; 墙的轮廓点本身在空闲区域的边界上, 也作为障碍, 与在轮廓点上画圆的膨胀一致
+    cv::Mat1b free_space(original_map.size(), uchar(0));
+    cv::fillPoly(free_space, wall_contours, cv::Scalar(255));
+    cv::polylines(free_space, wall_contours, true, cv::Scalar(0));
+    cv::fillPoly(free_space, obstacle_contours, cv::Scalar(0));
+
+    cv::Mat1f distance_field;
+    cv::distanceTransform(free_space, distance_field, cv::DIST_L2, cv::DIST_MASK_PRECISE);
+    return distance_field;
+}
+
+cv::Mat1b InflateObstacles(const cv::Mat1f& distance_field, int robot_radius)
+{
+    BCD_PROFILE_SCOPE("InflateObstacles");
+
+    // 距离是整数平方和的平方根, 阈值取在r*r与r*r+1之间, 不受平方根舍入的影响(启用IPP的OpenCV在整数距离上会多出1ulp)
+    cv::Mat1b free_space;
+    cv::Mat inflated;
+    cv::threshold(distance_field, inflated, std::sqrt(double(robot_radius)*robot_radius + 0.5), 255, cv::THRESH_BINARY);
+    inflated.convertTo(free_space, CV_8U);
+    return free_space;
+}
+
+void ExtractInflatedContours(const cv::Mat1f& distance_field, int robot_radius, std::vector<std::vector<cv::Point>>& wall_contours, std::vector<std::vector<cv::Point>>& obstacle_contours)
+{
+    cv::Mat1b canvas_ = InflateObstacles(distance_field, robot_radius);
+
+    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(robot_radius,robot_radius), cv::Point(-1,-1));
+    cv::morphologyEx(canvas_, canvas_, cv::MORPH_OPEN, kernel);
+
+    ExtractRawContours(canvas_, wall_contours, obstacle_contours);
+    // 半径过大时没有剩余的空闲区域
+    if(wall_contours.empty())
+    {
+        return;
+    }
+
+
+
+    std::vector<cv::Point> processed_wall_contour;
+    cv::approxPolyDP(cv::Mat(wall_contours.front()), processed_wall_contour, 1, true);
+
+    std::vector<std::vector<cv::Point>> processed_obstacle_contours(obstacle_contours.size());
+    for(int i = 0; i < int(obstacle_contours.size()); i++)
+    {
+        cv::approxPolyDP(cv::Mat(obstacle_contours[i]), processed_obstacle_contours[i], 1, true);
+    }
+
+    wall_contours = {processed_wall_contour};
+    obstacle_contours = processed_obstacle_contours;
+}
+
+void ExtractContours(const cv::Mat& original_map, std::vector<std::vector<cv::Point>>& wall_contours, std::vector<std::vector<cv::Point>>& obstacle_contours, int robot_radius)
+{
+    BCD_PROFILE_SCOPE("ExtractContours");
+
+    ExtractRawContours(original_map, wall_contours, obstacle_contours);
+
+    if(robot_radius != 0 && !wall_contours.empty())
+    {
+        ExtractInflatedContours(ComputeObstacleDistanceField(original_map, wall_contours, obstacle_contours), robot_radius, wall_contours, obstacle_contours);
+    }
+}
+
+PolygonList ConstructObstacles(const cv::Mat& original_map, const std::vector<std::vector<cv::Point>>& obstacle_contours)
+{
+    BCD_PROFILE_SCOPE("ConstructObstacles");
+
+    PolygonList obstacles;
+    Polygon obstacle;
+
+    for(const auto& obstacle_contour : obstacle_contours)
+    {
+        for(int j = 0; j < obstacle_contour.size()-1; j++)
+        {
+            cv::LineIterator line(original_map, obstacle_contour[j], obstacle_contour[j+1]);
+            for(int k = 0; k < line.count-1; k++)
+            {
+                obstacle.emplace_back(Point2D(line.pos().x, line.pos().y));
+                line++;
+            }
+        }
+        cv::LineIterator line(original_map, obstacle_contour[obstacle_contour.size()-1], obstacle_contour[0]);
+        for(int j = 0; j < line.count-1; j++)
+        {
+            obstacle.emplace_back(Point2D(line.pos().x, line.pos().y));
+            line++;
+        }
+
+        obstacles.emplace_back(obstacle);
+        obstacle.clear();
+    }
+
+    return obstacles;
+}
+
+Polygon ConstructDefaultWall(const cv::Mat& original_map)
+{
+    std::vector<cv::Point> default_wall_contour = {cv::Point(0, 0), cv::Point(0, original_map.rows-1), cv::Point(original_map.cols-1, original_map.rows-1), cv::Point(original_map.cols-1, 0)};
+    std::vector<std::vector<cv::Point>>default_wall_contours = {default_wall_contour};
+
+    Polygon default_wall = ConstructObstacles(original_map, default_wall_contours).front();
+
+    return default_wall;
+}
+
+Polygon ConstructWall(const cv::Mat& original_map, std::vector<cv::Point>& wall_contour)
+{
+    BCD_PROFILE_SCOPE("ConstructWall");
+
+    Polygon wall;
+
+    if(!wall_contour.empty())
+    {
+        for(int i = 0; i < wall_contour.size()-1; i++)
+        {
+            cv::LineIterator line(original_map, wall_contour[i], wall_contour[i+1]);
+            for(int j = 0; j < line.count-1; j++)
+            {
+                wall.emplace_back(Point2D(line.pos().x, line.pos().y));
+                line++;
+            }
+        }
+        cv::LineIterator line(original_map, wall_contour.back(), wall_contour.front());
+        for(int i = 0; i < line.count-1; i++)
+        {
+            wall.emplace_back(Point2D(line.pos().x, line.pos().y));
+            line++;
+        }
+
+        return wall;
+    }
+    else
+    {
+        wall = ConstructDefaultWall(original_map);
+
+        for(const auto& point : wall)
+        {
+            wall_contour.emplace_back(cv::Point(point.x, point.y));
+        }
+
+        return wall;
+    }
+}
+
+cv::Mat3b ConstructFreeSpaceMap(const cv::Mat& original_map, const std::vector<std::vector<cv::Point>>& wall_contours, const std::vector<std::vector<cv::Point>>& obstacle_contours)
+{
+    BCD_PROFILE_SCOPE("ConstructFreeSpaceMap");
+
+    cv::Mat3b map = cv::Mat3b(original_map.size());
+    map.setTo(cv::Scalar(0, 0, 0));
+
+    cv::fillPoly(map, wall_contours, cv::Scalar(255, 255, 255));
+    cv::fillPoly(map, obstacle_contours, cv::Scalar(0, 0, 0));
+
+    return map;
+}
+
+std::vector<CellNode> ConstructCellGraph(const cv::Mat& original_map, const std::vector<std::vector<cv::Point>>& wall_contours, const std::vector<std::vector<cv::Point>>& obstacle_contours, const Polygon& wall, const PolygonList& obstacles)
+{
+    cv::Mat3b map = ConstructFreeSpaceMap(original_map, wall_contours, obstacle_contours);
+
+    std::vector<Event> wall_event_list = GenerateWallEventList(map, wall);
+    std::vector<Event> obstacle_event_list = GenerateObstacleEventList(map, obstacles);
+    SliceList slice_list = SliceListGenerator(wall_event_list, obstacle_event_list);
+
+    std::vector<CellNode> cell_graph;
+    std::vector<int> cell_index_slice;
+    std::vector<int> original_cell_index_slice;
+    ExecuteCellDecomposition(cell_graph, cell_index_slice, original_cell_index_slice, slice_list);
+
+    return cell_graph;
+}
+
+/** 顶点级分解 **/
+/** 不再把轮廓逐像素展开: 每个多边形按x相同的连续顶点做游程编码, 在左右极值游程处切成x单调的边界链, 事件只在极值处产生; **/
+/** 扫描线上的活动链按y排列, 相邻两条链(第2k与2k+1条)之间为自由区间, 两侧的链不变时属于同一个cell; **/
+/** cell每列的ceiling/floor在生成cell时由链上的边插值得到 **/
+
+namespace
+{
+// x单调的边界链, 点的x不减, x相同的相邻点为竖直边
+class BoundaryChain
+{
+public:
+    int Left() const
+    {
+        return points.front().x;
+    }
+    int Right() const
+    {
+        return points.back().x;
+    }
+    std::vector<Point2D> points;
+};
+
+// 极值游程: 两侧相邻的顶点都在右边(左极值)或都在左边(右极值)
+class ExtremeRun
+{
+public:
+    int x;
+    int top_y;
+    int bottom_y;
+    bool is_left;
+    bool is_wall;
+    int polygon_index;
+    // 在此相交的两条链, 排序后[0]在上
+    int chains[2];
+    int chain_num;
+};
+
+// 下标依次为[是否为墙][是否为inner][是否为右极值][单点/竖直边的上端/竖直边的下端]
+const EventType critical_event_types[2][2][2][3] =
+{
+    {
+        {{IN, IN_TOP, IN_BOTTOM}, {OUT, OUT_TOP, OUT_BOTTOM}},
+        {{INNER_IN, INNER_IN_TOP, INNER_IN_BOTTOM}, {INNER_OUT, INNER_OUT_TOP, INNER_OUT_BOTTOM}}
+    },
+    {
+        {{IN_EX, IN_TOP_EX, IN_BOTTOM_EX}, {OUT_EX, OUT_TOP_EX, OUT_BOTTOM_EX}},
+        {{INNER_IN_EX, INNER_IN_TOP_EX, INNER_IN_BOTTOM_EX}, {INNER_OUT_EX, INNER_OUT_TOP_EX, INNER_OUT_BOTTOM_EX}}
+    }
+};
+
+// x须严格位于链的左右端之间且不落在顶点上
+double ChainY(const BoundaryChain& chain, double x)
+{
+    auto next = std::upper_bound(chain.points.begin(), chain.points.end(), x, [](double value, const Point2D& point){ return value < point.x; });
+    const Point2D& p1 = *(next-1);
+    const Point2D& p2 = *next;
+    return p1.y + double(p2.y - p1.y) * (x - p1.x) / double(p2.x - p1.x);
+}
+
+// 链在第x列覆盖的行范围, 即链在[x-0.5, x+0.5]内的y范围, 平缓的边取四舍五入后的一行
+void ChainExtent(const BoundaryChain& chain, int x, int& top_y, int& bottom_y)
+{
+    double min_y = DBL_MAX;
+    double max_y = -DBL_MAX;
+
+    auto first = std::lower_bound(chain.points.begin(), chain.points.end(), x, [](const Point2D& point, int value){ return point.x < value; });
+    for(auto iter = first; iter != chain.points.end() && iter->x == x; ++iter)
+    {
+        min_y = std::min(min_y, double(iter->y));
+        max_y = std::max(max_y, double(iter->y));
+    }
+    if(x > chain.Left())
+    {
+        double y = ChainY(chain, x-0.5);
+        min_y = std::min(min_y, y);
+        max_y = std::max(max_y, y);
+    }
+    if(x < chain.Right())
+    {
+        double y = ChainY(chain, x+0.5);
+        min_y = std::min(min_y, y);
+        max_y = std::max(max_y, y);
+    }
+
+    top_y = int(std::ceil(min_y - 1e-9));
+    bottom_y = int(std::floor(max_y + 1e-9));
+    if(top_y > bottom_y)
+    {
+        top_y = bottom_y = int(std::lround(ChainY(chain, x)));
+    }
+}
+
+// 上方链的最低行为ceiling, 下方链的最高行为floor
+void ChainPairColumn(const std::vector<BoundaryChain>& chains, int ceiling_chain, int floor_chain, int x, int& ceiling_y, int& floor_y)
+{
+    int top_y, bottom_y;
+    ChainExtent(chains[ceiling_chain], x, top_y, bottom_y);
+    ceiling_y = bottom_y;
+    ChainExtent(chains[floor_chain], x, top_y, bottom_y);
+    floor_y = top_y;
+
+    // 尖角处两条链在同一列内交错
+    if(ceiling_y > floor_y)
+    {
+        ceiling_y = floor_y = (ceiling_y + floor_y) / 2;
+    }
+}
+
+// 同一极值游程上的两条链, 判断chain1是否在chain2之上
+bool IsUpperChain(const BoundaryChain& chain1, const BoundaryChain& chain2, bool is_left_run)
+{
+    const Point2D& end1 = is_left_run ? chain1.points.front() : chain1.points.back();
+    const Point2D& end2 = is_left_run ? chain2.points.front() : chain2.points.back();
+    if(end1.y != end2.y)
+    {
+        return end1.y < end2.y;
+    }
+    double x = is_left_run ? end1.x + 0.5 : end1.x - 0.5;
+    return ChainY(chain1, x) < ChainY(chain2, x);
+}
+
+// 把轮廓切成边界链, 并记录极值游程
+void AppendPolygonChains(const std::vector<cv::Point>& contour, bool is_wall, int polygon_index, std::vector<BoundaryChain>& chains, std::vector<ExtremeRun>& runs)
+{
+    std::vector<Point2D> vertices;
+    for(const auto& point : contour)
+    {
+        if(vertices.empty() || vertices.back().x != point.x || vertices.back().y != point.y)
+        {
+            vertices.emplace_back(Point2D(point.x, point.y));
+        }
+    }
+    while(vertices.size() > 1 && vertices.back() == vertices.front())
+    {
+        vertices.pop_back();
+    }
+
+    int N = vertices.size();
+    int run_start = 0;
+    while(run_start < N && vertices[run_start].x == vertices[(run_start+N-1)%N].x)
+    {
+        run_start++;
+    }
+    // 所有顶点x相同, 不占据任何面积
+    if(N < 2 || run_start == N)
+    {
+        return;
+    }
+
+    std::vector<int> run_firsts;
+    std::vector<int> run_lengths;
+    for(int offset = 0; offset < N; )
+    {
+        int first = (run_start + offset) % N;
+        int length = 1;
+        while(vertices[(first+length)%N].x == vertices[first].x)
+        {
+            length++;
+        }
+        run_firsts.emplace_back(first);
+        run_lengths.emplace_back(length);
+        offset += length;
+    }
+
+    int R = run_firsts.size();
+    std::vector<int> run_ids(R, -1);
+    for(int r = 0; r < R; r++)
+    {
+        int first = run_firsts[r];
+        int x = vertices[first].x;
+        bool entry_right = vertices[(first+N-1)%N].x > x;
+        bool exit_right = vertices[(first+run_lengths[r])%N].x > x;
+        if(entry_right != exit_right)
+        {
+            continue;
+        }
+
+        ExtremeRun run;
+        run.x = x;
+        run.top_y = INT_MAX;
+        run.bottom_y = INT_MIN;
+        for(int i = 0; i < run_lengths[r]; i++)
+        {
+            run.top_y = std::min(run.top_y, vertices[(first+i)%N].y);
+            run.bottom_y = std::max(run.bottom_y, vertices[(first+i)%N].y);
+        }
+        run.is_left = entry_right;
+        run.is_wall = is_wall;
+        run.polygon_index = polygon_index;
+        run.chain_num = 0;
+
+        run_ids[r] = runs.size();
+        runs.emplace_back(run);
+    }
+
+    int first_extreme = 0;
+    while(run_ids[first_extreme] < 0)
+    {
+        first_extreme++;
+    }
+
+    // 从一个极值游程的末点出发, 经过中间的游程, 到下一个极值游程的首点为一条链
+    int from_run = first_extreme;
+    std::vector<Point2D> points = {vertices[(run_firsts[from_run]+run_lengths[from_run]-1)%N]};
+    for(int k = 1; k <= R; k++)
+    {
+        int r = (first_extreme + k) % R;
+        if(run_ids[r] < 0)
+        {
+            for(int i = 0; i < run_lengths[r]; i++)
+            {
+                points.emplace_back(vertices[(run_firsts[r]+i)%N]);
+            }
+            continue;
+        }
+
+        points.emplace_back(vertices[run_firsts[r]]);
+
+        BoundaryChain chain;
+        chain.points = points;
+        if(!runs[run_ids[from_run]].is_left)
+        {
+            std::reverse(chain.points.begin(), chain.points.end());
+        }
+        int chain_index = chains.size();
+        chains.emplace_back(chain);
+
+        ExtremeRun& from = runs[run_ids[from_run]];
+        ExtremeRun& to = runs[run_ids[r]];
+        from.chains[from.chain_num++] = chain_index;
+        to.chains[to.chain_num++] = chain_index;
+
+        from_run = r;
+        points = {vertices[(run_firsts[r]+run_lengths[r]-1)%N]};
+    }
+}
+
+// 活动链chain_index在第x列是否整体位于新插入的游程之上
+bool IsChainAboveRun(const std::vector<BoundaryChain>& chains, int chain_index, const ExtremeRun& run)
+{
+    const BoundaryChain& chain = chains[chain_index];
+
+    int top_y, bottom_y;
+    ChainExtent(chain, run.x, top_y, bottom_y);
+    if(bottom_y < run.top_y)
+    {
+        return true;
+    }
+    if(top_y > run.top_y)
+    {
+        return false;
+    }
+
+    // 相切时比较右侧半列的位置
+    if(chain.Right() > run.x)
+    {
+        return ChainY(chain, run.x+0.5) < ChainY(chains[run.chains[0]], run.x+0.5);
+    }
+    return top_y + bottom_y < 2 * run.top_y;
+}
+
+class VertexCell
+{
+public:
+    int ceiling_chain;
+    int floor_chain;
+    int left;
+    int right;
+    std::deque<int> neighbor_indices;
+};
+}
+
+std::vector<CellNode> ConstructCellGraphFromVertices(const cv::Mat& original_map, const std::vector<std::vector<cv::Point>>& wall_contours, const std::vector<std::vector<cv::Point>>& obstacle_contours, std::vector<Event>& wall_event_list, std::vector<Event>& obstacle_event_list)
+{
+    BCD_PROFILE_SCOPE("ConstructCellGraphFromVertices");
+
+    wall_event_list.clear();
+    obstacle_event_list.clear();
+
+    // 半径为0时轮廓未经简化, 每个像素都是顶点, 先做与ExtractContours相同的简化
+    auto simplify = [](const std::vector<cv::Point>& contour)
+    {
+        for(int i = 1; i < int(contour.size()); i++)
+        {
+            if(abs(contour[i].x - contour[i-1].x) > 1 || abs(contour[i].y - contour[i-1].y) > 1)
+            {
+                return contour;
+            }
+        }
+        std::vector<cv::Point> approx_contour;
+        cv::approxPolyDP(contour, approx_contour, 1, true);
+        return approx_contour;
+    };
+
+    std::vector<BoundaryChain> chains;
+    std::vector<ExtremeRun> runs;
+
+    if(wall_contours.empty() || wall_contours.front().empty())
+    {
+        std::vector<cv::Point> default_wall_contour = {cv::Point(0, 0), cv::Point(0, original_map.rows-1), cv::Point(original_map.cols-1, original_map.rows-1), cv::Point(original_map.cols-1, 0)};
+        AppendPolygonChains(default_wall_contour, true, INT_MAX, chains, runs);
+    }
+    else
+    {
+        AppendPolygonChains(simplify(wall_contours.front()), true, INT_MAX, chains, runs);
+    }
+    for(int i = 0; i < int(obstacle_contours.size()); i++)
+    {
+        AppendPolygonChains(simplify(obstacle_contours[i]), false, i, chains, runs);
+    }
+
+    for(auto& run : runs)
+    {
+        if(run.chain_num == 2 && !IsUpperChain(chains[run.chains[0]], chains[run.chains[1]], run.is_left))
+        {
+            std::swap(run.chains[0], run.chains[1]);
+        }
+    }
+
+    // 左极值在x-0.5处插入两条链, 右极值在x+0.5处移除; 同一位置先移除后插入
+    auto run_key = [](const ExtremeRun& run)
+    {
+        return run.is_left ? 2*run.x-1 : 2*run.x+1;
+    };
+    std::vector<int> run_order(runs.size());
+    std::iota(run_order.begin(), run_order.end(), 0);
+    std::sort(run_order.begin(), run_order.end(), [&](int lhs, int rhs)
+    {
+        int lhs_key = run_key(runs[lhs]);
+        int rhs_key = run_key(runs[rhs]);
+        if(lhs_key != rhs_key)
+        {
+            return lhs_key < rhs_key;
+        }
+        if(runs[lhs].is_left != runs[rhs].is_left)
+        {
+            return !runs[lhs].is_left;
+        }
+        return runs[lhs].top_y < runs[rhs].top_y;
+    });
+
+    std::vector<int> active_chains;
+    std::vector<VertexCell> cells;
+    std::vector<int> open_cell_by_ceiling(chains.size(), -1);
+    std::vector<int> closed_cells;
+    std::vector<int> opened_cells;
+    std::vector<int> cells_before;
+    std::vector<int> continued_stamps;
+
+    auto emit_events = [&](const ExtremeRun& run, bool is_inner)
+    {
+        std::vector<Event>& event_list = run.is_wall ? wall_event_list : obstacle_event_list;
+        const EventType (&types)[3] = critical_event_types[run.is_wall][is_inner][!run.is_left];
+        if(run.top_y == run.bottom_y)
+        {
+            event_list.emplace_back(Event(run.polygon_index, run.x, run.top_y, types[0]));
+        }
+        else
+        {
+            event_list.emplace_back(Event(run.polygon_index, run.x, run.top_y, types[1]));
+            event_list.emplace_back(Event(run.polygon_index, run.x, run.bottom_y, types[2]));
+        }
+    };
+
+    for(int begin = 0; begin < int(run_order.size()); )
+    {
+        int key = run_key(runs[run_order[begin]]);
+        int end = begin;
+        while(end < int(run_order.size()) && run_key(runs[run_order[end]]) == key)
+        {
+            end++;
+        }
+
+        cells_before.clear();
+        for(int k = 0; k+1 < int(active_chains.size()); k += 2)
+        {
+            cells_before.emplace_back(open_cell_by_ceiling[active_chains[k]]);
+        }
+
+        for(int i = begin; i < end; i++)
+        {
+            const ExtremeRun& run = runs[run_order[i]];
+            if(run.chain_num != 2)
+            {
+                continue;
+            }
+
+            if(run.is_left)
+            {
+                int position = 0;
+                int count = active_chains.size();
+                while(count > 0)
+                {
+                    int step = count / 2;
+                    if(IsChainAboveRun(chains, active_chains[position+step], run))
+                    {
+                        position += step + 1;
+                        count -= step + 1;
+                    }
+                    else
+                    {
+                        count = step;
+                    }
+                }
+                active_chains.insert(active_chains.begin()+position, run.chains, run.chains+2);
+                // 插入位置为偶数时两条链之间是自由区间, 即新的cell从这里出现, 否则是原有的cell被分开
+                emit_events(run, run.is_wall != (position % 2 == 0));
+            }
+            else
+            {
+                int position = std::find(active_chains.begin(), active_chains.end(), run.chains[0]) - active_chains.begin();
+                // 同理, 偶数位置表示有cell在这里结束, 否则是两个cell在这里合并
+                emit_events(run, run.is_wall != (position % 2 == 0));
+                for(int c = 0; c < 2; c++)
+                {
+                    auto iter = std::find(active_chains.begin(), active_chains.end(), run.chains[c]);
+                    if(iter != active_chains.end())
+                    {
+                        active_chains.erase(iter);
+                    }
+                }
+            }
+        }
+
+        // 两侧的链都没变的cell继续延伸, 其余的在此结束, 新出现的区间开始新的cell
+        int first_x = (key + 1) / 2;
+        int last_x = (key - 1) / 2;
+        continued_stamps.resize(cells.size(), -1);
+        opened_cells.clear();
+        for(int k = 0; k+1 < int(active_chains.size()); k += 2)
+        {
+            int cell_index = open_cell_by_ceiling[active_chains[k]];
+            if(cell_index >= 0 && cells[cell_index].floor_chain == active_chains[k+1])
+            {
+                continued_stamps[cell_index] = key;
+                continue;
+            }
+
+            VertexCell cell;
+            cell.ceiling_chain = active_chains[k];
+            cell.floor_chain = active_chains[k+1];
+            cell.left = first_x;
+            cell.right = INT_MAX;
+            opened_cells.emplace_back(cells.size());
+            cells.emplace_back(cell);
+        }
+        continued_stamps.resize(cells.size(), -1);
+
+        closed_cells.clear();
+        for(auto cell_index : cells_before)
+        {
+            if(cell_index >= 0 && continued_stamps[cell_index] != key)
+            {
+                cells[cell_index].right = last_x;
+                open_cell_by_ceiling[cells[cell_index].ceiling_chain] = -1;
+                closed_cells.emplace_back(cell_index);
+            }
+        }
+        for(auto cell_index : opened_cells)
+        {
+            open_cell_by_ceiling[cells[cell_index].ceiling_chain] = cell_index;
+        }
+
+        // 结束的cell与新cell在交界处的y范围重叠时相邻, 按从上到下的顺序记录
+        for(auto closed_index : closed_cells)
+        {
+            int closed_ceiling, closed_floor;
+            ChainPairColumn(chains, cells[closed_index].ceiling_chain, cells[closed_index].floor_chain, last_x, closed_ceiling, closed_floor);
+            for(auto opened_index : opened_cells)
+            {
+                int opened_ceiling, opened_floor;
+                ChainPairColumn(chains, cells[opened_index].ceiling_chain, cells[opened_index].floor_chain, first_x, opened_ceiling, opened_floor);
+                if(std::max(closed_ceiling, opened_ceiling) <= std::min(closed_floor, opened_floor))
+                {
+                    cells[closed_index].neighbor_indices.emplace_front(opened_index);
+                    cells[opened_index].neighbor_indices.emplace_back(closed_index);
+                }
+            }
+        }
+
+        begin = end;
+    }
+
+    std::sort(wall_event_list.begin(), wall_event_list.end());
+    std::sort(obstacle_event_list.begin(), obstacle_event_list.end());
+    BCD_PROFILE_COUNT("critical_events", wall_event_list.size()+obstacle_event_list.size());
+
+    std::vector<CellNode> cell_graph(cells.size());
+    for(int i = 0; i < int(cells.size()); i++)
+    {
+        const VertexCell& cell = cells[i];
+        CellNode& cell_node = cell_graph[i];
+        cell_node.cellIndex = i;
+        cell_node.neighbor_indices = cell.neighbor_indices;
+
+        int right = cell.right == INT_MAX ? cell.left : cell.right;
+        for(int x = cell.left; x <= right; x++)
+        {
+            int ceiling_y, floor_y;
+            ChainPairColumn(chains, cell.ceiling_chain, cell.floor_chain, x, ceiling_y, floor_y);
+            cell_node.ceiling.emplace_back(Point2D(x, ceiling_y));
+            cell_node.floor.emplace_back(Point2D(x, floor_y));
+        }
+    }
+    BCD_PROFILE_COUNT("cells", cell_graph.size());
+
+    return cell_graph;
+}
+
+/** 规划中的一步: 清扫一个cell, 或者只是从中经过 **/
+class CellVisit
+{
+public:
+    CellVisit(int index, bool sweep_cell, int corner_indicator=INT_MAX)
+    {
+        cell_index = index;
+        sweep = sweep_cell;
+        entry_corner = corner_indicator;
+    }
+    int cell_index;
+    bool sweep;
+    // 指定的入口corner, INT_MAX表示沿用FindLinkingPath到达的corner
+    int entry_corner;
+};
+
+// 按与PlanStaticPath相同的走法估计各步之间的转移代价之和
+long long EstimateVisitsCost(const CellGraph& cell_graph, const std::vector<CellVisit>& visits, const Point2D& start_point, int robot_radius)
+{
+    std::vector<char> cleaned(cell_graph.Size(), false);
+    int corner_indicator = visits.front().entry_corner == INT_MAX ? TOPLEFT : visits.front().entry_corner;
+    long long cost = ManhattanDistance(start_point, ComputeCellCornerPoint(cell_graph, visits.front().cell_index, corner_indicator));
+
+    for(int i = 0; i+1 < int(visits.size()); i++)
+    {
+        int cell_index = visits[i].cell_index;
+        Point2D curr_exit = ComputeCellCornerPoint(cell_graph, cell_index, corner_indicator);
+        if(visits[i].sweep && !cleaned[cell_index])
+        {
+            curr_exit = ComputeCellCornerPoint(cell_graph, cell_index, ComputeExitCorner(cell_graph, cell_index, corner_indicator, robot_radius));
+            cleaned[cell_index] = true;
+        }
+
+        corner_indicator = visits[i+1].entry_corner;
+        cost += EstimateTransitCost(cell_graph, curr_exit, cell_index, visits[i+1].cell_index, corner_indicator);
+    }
+    return cost;
+}
+
+// 深度优先的访问顺序, 回溯时经过的cell已清扫过, 只会走到其corner
+std::vector<CellVisit> GetDepthFirstVisits(CellGraph& cell_graph, int start_cell_index)
+{
+    std::vector<CellVisit> visits;
+    for(const auto& cell_index : GetVisittingPath(cell_graph, start_cell_index))
+    {
+        visits.emplace_back(CellVisit(cell_index, true));
+    }
+    return visits;
+}
+
+// 优化后的顺序中相邻两项可能不相邻, 中间插入只经过不清扫的cell
+std::vector<CellVisit> GetSequencedVisits(const CellGraph& cell_graph, int start_cell_index, const Point2D& start_point, int robot_radius)
+{
+    std::vector<int> entry_corners;
+    std::vector<int> cell_sequence = SequenceCells(cell_graph, start_cell_index, start_point, robot_radius, entry_corners);
+
+    std::vector<CellVisit> visits = {CellVisit(cell_sequence.front(), true, entry_corners.front())};
+    for(int i = 1; i < int(cell_sequence.size()); i++)
+    {
+        if(!IsNeighborCell(cell_graph, cell_sequence[i-1], cell_sequence[i]))
+        {
+            std::vector<int> hop_path = FindCellHopPath(cell_graph, cell_sequence[i-1], cell_sequence[i]);
+            for(int j = 0; j+1 < int(hop_path.size()); j++)
+            {
+                visits.emplace_back(CellVisit(hop_path[j], false));
+            }
+        }
+        visits.emplace_back(CellVisit(cell_sequence[i], true, entry_corners[i]));
+    }
+    return visits;
+}
+
+// 往返清扫一个cell; cell graph挂有SweepCache时先查缓存, 已清扫的cell只走到corner, 不经过缓存
+std::shared_ptr<const std::deque<Point2D>> SweepCell(const CellGraph& cell_graph, int cell_index, int corner_indicator, int robot_radius)
+{
+    const std::shared_ptr<SweepCache>& sweep_cache = cell_graph.GetSweepCache();
+    if(sweep_cache == nullptr || cell_graph.IsCleaned(cell_index))
+    {
+        return std::make_shared<const std::deque<Point2D>>(GetBoustrophedonPath(cell_graph, cell_index, corner_indicator, robot_radius));
+    }
+
+    std::shared_ptr<const std::deque<Point2D>> sweep = sweep_cache->Find(cell_graph, cell_index, corner_indicator, robot_radius);
+    if(sweep == nullptr)
+    {
+        sweep = std::make_shared<const std::deque<Point2D>>(GetBoustrophedonPath(cell_graph, cell_index, corner_indicator, robot_radius));
+        sweep_cache->Insert(cell_graph, cell_index, corner_indicator, robot_radius, sweep);
+    }
+    return sweep;
+}
+
+// 与SweepCell相同, 结果接在path的末尾; 不经过缓存时直接写入path, 不生成中间的deque
+template <typename Path>
+void AppendSweep(const CellGraph& cell_graph, int cell_index, int corner_indicator, int robot_radius, Path& path)
+{
+    if(cell_graph.GetSweepCache() == nullptr || cell_graph.IsCleaned(cell_index))
+    {
+        AppendBoustrophedonPath(cell_graph, cell_index, corner_indicator, robot_radius, path);
+        return;
+    }
+
+    std::shared_ptr<const std::deque<Point2D>> sweep = SweepCell(cell_graph, cell_index, corner_indicator, robot_radius);
+    path.insert(path.end(), sweep->begin(), sweep->end());
+}
+
+// 进程内累计的退回次数, 不依赖BCD_PROFILING
+std::atomic<long long> parallel_sweep_fallback_count(0);
+
+long long ParallelSweepFallbackCount()
+{
+    return parallel_sweep_fallback_count.load();
+}
+
+/** 两阶段生成: 第一阶段只用cell的角点推出每一步的入口corner, 出口与连接路径(往返路径的出口由ComputeExitCorner给出), **/
+/** 第二阶段在线程池中并行生成各cell的往返路径, 写入预先分好的位置, 再按顺序与连接路径拼接, 结果与逐个生成相同 **/
+/** 某条往返路径的终点与推出的出口不一致时不调用sub_path_handler, 返回false, 由调用者逐个生成 **/
+/** 临时数据从arena分配; arena不加锁, 工作线程内只读这些数据, 往返路径仍在堆上生成 **/
+template <typename SubPathHandler>
+bool PlanSweepsInParallel(CellGraph& cell_graph, const std::vector<CellVisit>& visits, int corner_indicator, int robot_radius, MonotonicArena& arena,
+                          ArenaVector<Point2D>& local_path, SubPathHandler& sub_path_handler)
+{
+    BCD_PROFILE_SCOPE("PlanSweepsInParallel");
+
+    class VisitStep
+    {
+    public:
+        int corner_indicator;
+        // 需要往返清扫时为sweeps中的下标, 否则为-1(只经过该cell的corner)
+        int sweep_slot;
+        Point2D exit;
+        int linking_length;
+        // 连接路径在link_points中的位置: [link_begin, link_split)在当前cell内, [link_split, link_end)在下一个cell内
+        int link_begin;
+        int link_split;
+        int link_end;
+    };
+
+    ArenaAllocator<Point2D> allocator(&arena);
+    ArenaVector<VisitStep> steps(visits.size(), VisitStep(), allocator);
+    ArenaVector<int> sweep_visits(allocator);
+    ArenaVector<char> cleaned(cell_graph.Size(), false, allocator);
+    for(int i = 0; i < cell_graph.Size(); i++)
+    {
+        cleaned[i] = cell_graph.IsCleaned(i);
+    }
+    // 所有连接路径首尾相接存放
+    ArenaVector<Point2D> link_points(allocator);
+    ArenaVector<Point2D> path_in_next_cell(allocator);
+
+    // 第一阶段: 与逐个生成时的顺序相同地推进corner, 已清扫的cell只走到corner
+    for(int i = 0; i < int(visits.size()); i++)
+    {
+        int cell_index = visits[i].cell_index;
+
+        steps[i].corner_indicator = corner_indicator;
+        steps[i].sweep_slot = -1;
+        steps[i].exit = ComputeCellCornerPoint(cell_graph, cell_index, corner_indicator);
+        steps[i].linking_length = 0;
+        steps[i].link_begin = int(link_points.size());
+        steps[i].link_split = int(link_points.size());
+        steps[i].link_end = int(link_points.size());
+        if(visits[i].sweep && !cleaned[cell_index])
+        {
+            steps[i].sweep_slot = int(sweep_visits.size());
+            steps[i].exit = ComputeCellCornerPoint(cell_graph, cell_index, ComputeExitCorner(cell_graph, cell_index, corner_indicator, robot_radius));
+            sweep_visits.emplace_back(i);
+            cleaned[cell_index] = true;
+        }
+
+        if(i < int(visits.size())-1)
+        {
+            int next_cell_index = visits[i+1].cell_index;
+            Point2D next_entrance = FindNextEntrance(steps[i].exit, cell_graph, next_cell_index, corner_indicator);
+            path_in_next_cell.clear();
+            AppendLinkingPath(steps[i].exit, next_entrance, corner_indicator, cell_graph, cell_index, next_cell_index, link_points, path_in_next_cell);
+            steps[i].link_split = int(link_points.size());
+            link_points.insert(link_points.end(), path_in_next_cell.begin(), path_in_next_cell.end());
+            steps[i].linking_length = int(link_points.size()) - steps[i].link_begin;
+
+            if(visits[i+1].entry_corner != INT_MAX && visits[i+1].entry_corner != corner_indicator)
+            {
+                std::deque<Point2D> corner_path = WalkBetweenCorners(cell_graph, next_cell_index, corner_indicator, visits[i+1].entry_corner);
+                link_points.insert(link_points.end(), corner_path.begin(), corner_path.end()-1);
+                corner_indicator = visits[i+1].entry_corner;
+            }
+            steps[i].link_end = int(link_points.size());
+        }
+    }
+
+    // 第二阶段: 各往返路径只依赖自己的cell与入口corner, 生成期间cell graph不被修改
+    std::vector<std::shared_ptr<const std::deque<Point2D>>> sweeps(sweep_visits.size());
+    DefaultThreadPool().ParallelFor(int(sweep_visits.size()), [&](int slot)
+    {
+        const VisitStep& step = steps[sweep_visits[slot]];
+        sweeps[slot] = SweepCell(cell_graph, visits[sweep_visits[slot]].cell_index, step.corner_indicator, robot_radius);
+    });
+
+    for(int slot = 0; slot < int(sweeps.size()); slot++)
+    {
+        const Point2D& exit = steps[sweep_visits[slot]].exit;
+        if(sweeps[slot]->empty() || sweeps[slot]->back().x != exit.x || sweeps[slot]->back().y != exit.y)
+        {
+            BCD_PROFILE_COUNT("parallel_sweep_fallbacks", 1);
+            parallel_sweep_fallback_count++;
+            return false;
+        }
+    }
+
+    for(int i = 0; i < int(visits.size()); i++)
+    {
+        int cell_index = visits[i].cell_index;
+        if(steps[i].sweep_slot >= 0)
+        {
+            const std::deque<Point2D>& sweep = *sweeps[steps[i].sweep_slot];
+            BCD_PROFILE_SAMPLE("boustrophedon_points_per_cell", sweep.size());
+            local_path.insert(local_path.end(), sweep.begin(), sweep.end());
+        }
+        else
+        {
+            if(visits[i].sweep)
+            {
+                BCD_PROFILE_SAMPLE("boustrophedon_points_per_cell", 1);
+            }
+            local_path.emplace_back(steps[i].exit);
+        }
+        if(visits[i].sweep)
+        {
+            cell_graph.SetCleaned(cell_index, true);
+        }
+
+        if(i < int(visits.size())-1)
+        {
+            BCD_PROFILE_SAMPLE("linking_path_length", steps[i].linking_length);
+            local_path.insert(local_path.end(), link_points.begin()+steps[i].link_begin, link_points.begin()+steps[i].link_split);
+            sub_path_handler(PathView(local_path.data(), int(local_path.size())));
+            local_path.clear();
+            local_path.insert(local_path.end(), link_points.begin()+steps[i].link_split, link_points.begin()+steps[i].link_end);
+        }
+    }
+    sub_path_handler(PathView(local_path.data(), int(local_path.size())));
+
+    return true;
+}
+
+/** 依次生成每段子路径(覆盖一个cell并走到下一个cell的入口), 以PathView交给sub_path_handler处理 **/
+/** 规划过程中的临时路径都从本次规划的arena分配, 子路径是否复制由sub_path_handler决定, 返回时arena整块归还 **/
+template <typename SubPathHandler>
+void PlanStaticPath(CellGraph& cell_graph, const Point2D& start_point, int robot_radius, bool sequence_cells, bool parallel_sweeps, SubPathHandler& sub_path_handler)
+{
+    MonotonicArena arena;
+    ArenaAllocator<Point2D> allocator(&arena);
+    ArenaVector<Point2D> local_path(allocator);
+
+    int start_cell_index = DetermineCellIndex(cell_graph, start_point).front();
+
+    std::vector<CellVisit> visits = GetDepthFirstVisits(cell_graph, start_cell_index);
+    if(sequence_cells && cell_graph.Size() > 1)
+    {
+        // 优化后的顺序估计代价不比深度优先低时, 仍按深度优先的顺序
+        std::vector<CellVisit> sequenced_visits = GetSequencedVisits(cell_graph, start_cell_index, start_point, robot_radius);
+        if(EstimateVisitsCost(cell_graph, sequenced_visits, start_point, robot_radius) < EstimateVisitsCost(cell_graph, visits, start_point, robot_radius))
+        {
+            visits.swap(sequenced_visits);
+        }
+    }
+
+    int corner_indicator = visits.front().entry_corner == INT_MAX ? TOPLEFT : visits.front().entry_corner;
+
+    AppendWalkInsideCell(cell_graph, start_cell_index, start_point, ComputeCellCornerPoint(cell_graph, start_cell_index, corner_indicator), local_path);
+
+    if(parallel_sweeps && visits.size() > 1 && PlanSweepsInParallel(cell_graph, visits, corner_indicator, robot_radius, arena, local_path, sub_path_handler))
+    {
+        BCD_PROFILE_COUNT("plan_arena_blocks", arena.GetBlockCount());
+        return;
+    }
+
+    // 下一个cell内的连接路径, 交出当前子路径后与local_path交换
+    ArenaVector<Point2D> path_in_next_cell(allocator);
+    Point2D curr_exit;
+    Point2D next_entrance;
+
+    for(int i = 0; i < int(visits.size()); i++)
+    {
+        int cell_index = visits[i].cell_index;
+        if(visits[i].sweep)
+        {
+#ifdef BCD_PROFILING
+            size_t sweep_begin = local_path.size();
+#endif
+            AppendSweep(cell_graph, cell_index, corner_indicator, robot_radius, local_path);
+            BCD_PROFILE_SAMPLE("boustrophedon_points_per_cell", local_path.size()-sweep_begin);
+            cell_graph.SetCleaned(cell_index, true);
+        }
+        else
+        {
+            local_path.emplace_back(ComputeCellCornerPoint(cell_graph, cell_index, corner_indicator));
+        }
+
+        if(i < int(visits.size())-1)
+        {
+            int next_cell_index = visits[i+1].cell_index;
+            curr_exit = local_path.back();
+            next_entrance = FindNextEntrance(curr_exit, cell_graph, next_cell_index, corner_indicator);
+#ifdef BCD_PROFILING
+            size_t link_begin = local_path.size();
+#endif
+            path_in_next_cell.clear();
+            AppendLinkingPath(curr_exit, next_entrance, corner_indicator, cell_graph, cell_index, next_cell_index, local_path, path_in_next_cell);
+            BCD_PROFILE_SAMPLE("linking_path_length", local_path.size()-link_begin+path_in_next_cell.size());
+
+            // 指定了入口时, 从到达的corner走到指定的corner
+            if(visits[i+1].entry_corner != INT_MAX && visits[i+1].entry_corner != corner_indicator)
+            {
+                std::deque<Point2D> corner_path = WalkBetweenCorners(cell_graph, next_cell_index, corner_indicator, visits[i+1].entry_corner);
+                path_in_next_cell.insert(path_in_next_cell.end(), corner_path.begin(), corner_path.end()-1);
+                corner_indicator = visits[i+1].entry_corner;
+            }
+
+            sub_path_handler(PathView(local_path.data(), int(local_path.size())));
+            local_path.swap(path_in_next_cell);
+        }
+    }
+    sub_path_handler(PathView(local_path.data(), int(local_path.size())));
+    BCD_PROFILE_COUNT("plan_arena_blocks", arena.GetBlockCount());
+}
+
+std::deque<std::deque<Point2D>> StaticPathPlanning(CellGraph& cell_graph, const Point2D& start_point, int robot_radius, bool sequence_cells, bool parallel_sweeps)
+{
+    BCD_PROFILE_SCOPE("StaticPathPlanning");
+
+    std::deque<std::deque<Point2D>> global_path;
+    auto sub_path_handler = [&global_path](const PathView& sub_path)
+    {
+        global_path.emplace_back(sub_path.begin(), sub_path.end());
+    };
+    PlanStaticPath(cell_graph, start_point, robot_radius, sequence_cells, parallel_sweeps, sub_path_handler);
+
+    return global_path;
+}
+
+void StaticPathPlanning(CellGraph& cell_graph, const Point2D& start_point, int robot_radius, bool sequence_cells, bool parallel_sweeps, const SubPathSink& sub_path_sink)
+{
+    BCD_PROFILE_SCOPE("StaticPathPlanning");
+
+    PlanStaticPath(cell_graph, start_point, robot_radius, sequence_cells, parallel_sweeps, sub_path_sink);
+}
+
+std::deque<std::deque<Point2D>> StaticPathPlanning(std::vector<CellNode>& cell_graph, const Point2D& start_point, int robot_radius)
+{
+    CellGraph flat_cell_graph(cell_graph);
+    std::deque<std::deque<Point2D>> global_path = StaticPathPlanning(flat_cell_graph, start_point, robot_radius);
+    flat_cell_graph.CopyStatesTo(cell_graph);
+
+    return global_path;
+}
+
+std::deque<SegmentPath> StaticSegmentPathPlanning(CellGraph& cell_graph, const Point2D& start_point, int robot_radius, bool sequence_cells, bool parallel_sweeps)
+{
+    BCD_PROFILE_SCOPE("StaticSegmentPathPlanning");
+
+    std::deque<SegmentPath> global_path;
+    auto sub_path_handler = [&global_path](const PathView& sub_path)
+    {
+        global_path.emplace_back(SegmentPath());
+        global_path.back().Append(sub_path);
+    };
+    PlanStaticPath(cell_graph, start_point, robot_radius, sequence_cells, parallel_sweeps, sub_path_handler);
+
+    return global_path;
+}
+
+std::deque<SegmentPath> StaticSegmentPathPlanning(std::vector<CellNode>& cell_graph, const Point2D& start_point, int robot_radius)
+{
+    CellGraph flat_cell_graph(cell_graph);
+    std::deque<SegmentPath> global_path = StaticSegmentPathPlanning(flat_cell_graph, start_point, robot_radius);
+    flat_cell_graph.CopyStatesTo(cell_graph);
+
+    return global_path;
+}
+
+std::deque<Point2D> ReturningPathPlanning(const CellGraph& cell_graph, const Point2D& curr_pos, const Point2D& original_pos, int robot_radius)
+{
+    BCD_PROFILE_SCOPE("ReturningPathPlanning");
+
+    std::deque<int> return_cell_path = FindShortestPath(cell_graph, curr_pos, original_pos);
+    std::deque<Point2D> returning_path;
+
+    if(return_cell_path.size() == 1)
+    {
+        AppendWalkInsideCell(cell_graph, return_cell_path.front(), curr_pos, original_pos, returning_path);
+    }
+    else
+    {
+        AppendWalkCrossCells(cell_graph, return_cell_path, curr_pos, original_pos, robot_radius, returning_path);
+    }
+
+    return returning_path;
+}
+
+std::deque<Point2D> ReturningPathPlanning(std::vector<CellNode>& cell_graph, const Point2D& curr_pos, const Point2D& original_pos, int robot_radius)
+{
+    return ReturningPathPlanning(CellGraph(cell_graph), curr_pos, original_pos, robot_radius);
+}
+
+std::deque<Point2D> FilterTrajectory(const std::deque<std::deque<Point2D>>& raw_trajectory)
+{
+    BCD_PROFILE_SCOPE("FilterTrajectory");
+
+    std::deque<Point2D> trajectory;
+
+    for(const auto& sub_trajectory : raw_trajectory)
+    {
+        for(const auto& position : sub_trajectory)
+        {
+            if(!trajectory.empty())
+            {
+                if(position != trajectory.back())
+                {
+                    trajectory.emplace_back(position);
+                }
+            }
+            else
+            {
+                trajectory.emplace_back(position);
+            }
+        }
+    }
+
+    return trajectory;
+}
+
+SegmentPath FilterTrajectory(const std::deque<SegmentPath>& raw_trajectory)
+{
+    BCD_PROFILE_SCOPE("FilterTrajectory");
+
+    SegmentPath trajectory;
+
+    for(const auto& sub_trajectory : raw_trajectory)
+    {
+        trajectory.Append(sub_trajectory);
+    }
+
+    return trajectory;
+}
+
+
+
+
+/** 扁平cell graph **/
+
+
+CellGraph::CellGraph()
+{
+    min_column_x = 0;
+}
+
+CellGraph::CellGraph(const std::vector<CellNode>& cell_graph)
+{
+    min_column_x = 0;
+    Assign(cell_graph);
+}
+
+void CellGraph::Assign(const std::vector<CellNode>& cell_graph)
+{
+    Clear();
+
+    size_t column_num = 0;
+    size_t neighbor_num = 0;
+    for(const auto& cell : cell_graph)
+    {
+        column_num += std::min(cell.ceiling.size(), cell.floor.size());
+        neighbor_num += cell.neighbor_indices.size();
+    }
+
+    left_x.reserve(cell_graph.size());
+    column_offsets.reserve(cell_graph.size()+1);
+    ceiling_y.reserve(column_num);
+    floor_y.reserve(column_num);
+    neighbor_offsets.reserve(cell_graph.size()+1);
+    neighbor_list.reserve(neighbor_num);
+
+    column_offsets.emplace_back(0);
+    neighbor_offsets.emplace_back(0);
+
+    for(const auto& cell : cell_graph)
+    {
+        // 分解得到的cell每列恰好有一个ceiling点和一个floor点, 且列号连续
+        size_t width = std::min(cell.ceiling.size(), cell.floor.size());
+        left_x.emplace_back(width > 0 ? cell.ceiling.front().x : 0);
+        for(size_t i = 0; i < width; i++)
+        {
+            ceiling_y.emplace_back(cell.ceiling[i].y);
+            floor_y.emplace_back(cell.floor[i].y);
+        }
+        column_offsets.emplace_back(int(ceiling_y.size()));
+
+        neighbor_list.insert(neighbor_list.end(), cell.neighbor_indices.begin(), cell.neighbor_indices.end());
+        neighbor_offsets.emplace_back(int(neighbor_list.size()));
+
+        visited_flags.emplace_back(cell.isVisited);
+        cleaned_flags.emplace_back(cell.isCleaned);
+        parent_indices.emplace_back(cell.parentIndex);
+    }
+
+    BuildColumnIndex();
+}
+
+void CellGraph::BuildColumnIndex()
+{
+    int max_column_x = INT_MIN;
+    min_column_x = INT_MAX;
+    for(int i = 0; i < Size(); i++)
+    {
+        if(Width(i) > 0)
+        {
+            min_column_x = std::min(min_column_x, Left(i));
+            max_column_x = std::max(max_column_x, Right(i));
+        }
+    }
+    if(max_column_x < min_column_x)
+    {
+        min_column_x = 0;
+        return;
+    }
+
+    // 先统计每列的区间数, 再按列放置
+    interval_offsets.assign(max_column_x-min_column_x+2, 0);
+    for(int i = 0; i < Size(); i++)
+    {
+        for(int x = Left(i); x <= Right(i); x++)
+        {
+            interval_offsets[x-min_column_x+1]++;
+        }
+    }
+    std::partial_sum(interval_offsets.begin(), interval_offsets.end(), interval_offsets.begin());
+
+    column_intervals.resize(interval_offsets.back());
+    std::vector<int> fill_positions(interval_offsets.begin(), interval_offsets.end()-1);
+    for(int i = 0; i < Size(); i++)
+    {
+        CellEdgeView ceiling = Ceiling(i);
+        CellEdgeView floor = Floor(i);
+        for(int j = 0; j < Width(i); j++)
+        {
+            ColumnInterval& interval = column_intervals[fill_positions[ceiling[j].x-min_column_x]++];
+            interval.ceiling_y = ceiling[j].y;
+            interval.floor_y = floor[j].y;
+            interval.cell_index = i;
+        }
+    }
+
+    for(int x = 0; x+1 < int(interval_offsets.size()); x++)
+    {
+        auto begin = column_intervals.begin()+interval_offsets[x];
+        auto end = column_intervals.begin()+interval_offsets[x+1];
+        std::sort(begin, end, [](const ColumnInterval& a, const ColumnInterval& b)
+        {
+            return a.ceiling_y < b.ceiling_y || (a.ceiling_y == b.ceiling_y && a.cell_index < b.cell_index);
+        });
+
+        int max_floor_y = INT_MIN;
+        for(auto iter = begin; iter != end; ++iter)
+        {
+            max_floor_y = std::max(max_floor_y, iter->floor_y);
+            iter->max_floor_y = max_floor_y;
+        }
+    }
+}
+
+void CellGraph::Locate(const Point2D& point, std::vector<int>& cell_indices) const
+{
+    cell_indices.clear();
+
+    int column = point.x - min_column_x;
+    if(interval_offsets.empty() || point.x < min_column_x || column+1 >= int(interval_offsets.size()))
+    {
+        return;
+    }
+
+    auto begin = column_intervals.begin()+interval_offsets[column];
+    auto end = column_intervals.begin()+interval_offsets[column+1];
+
+    // ceiling_y大于y的区间都不可能包含该点
+    end = std::upper_bound(begin, end, point.y, [](int y, const ColumnInterval& interval)
+    {
+        return y < interval.ceiling_y;
+    });
+    // max_floor_y单调不减, 之前的区间都在该点上方
+    begin = std::lower_bound(begin, end, point.y, [](const ColumnInterval& interval, int y)
+    {
+        return interval.max_floor_y < y;
+    });
+
+    for(auto iter = begin; iter != end; ++iter)
+    {
+        if(point.y <= iter->floor_y)
+        {
+            cell_indices.emplace_back(iter->cell_index);
+        }
+    }
+    std::sort(cell_indices.begin(), cell_indices.end());
+}
+
+void CellGraph::Clear()
+{
+    left_x.clear();
+    column_offsets.clear();
+    ceiling_y.clear();
+    floor_y.clear();
+    neighbor_offsets.clear();
+    neighbor_list.clear();
+    visited_flags.clear();
+    cleaned_flags.clear();
+    parent_indices.clear();
+    min_column_x = 0;
+    interval_offsets.clear();
+    column_intervals.clear();
+}
+
+void CellGraph::ResetStates()
+{
+    std::fill(visited_flags.begin(), visited_flags.end(), false);
+    std::fill(cleaned_flags.begin(), cleaned_flags.end(), false);
+    std::fill(parent_indices.begin(), parent_indices.end(), INT_MAX);
+}
+
+void CellGraph::CopyStatesTo(std::vector<CellNode>& cell_graph) const
+{
+    for(int i = 0; i < Size() && i < int(cell_graph.size()); i++)
+    {
+        cell_graph[i].isVisited = IsVisited(i);
+        cell_graph[i].isCleaned = IsCleaned(i);
+        cell_graph[i].parentIndex = ParentIndex(i);
+    }
+}
+
+void CellGraph::CopyTo(std::vector<CellNode>& cell_graph) const
+{
+    cell_graph.assign(Size(), CellNode());
+    for(int i = 0; i < Size(); i++)
+    {
+        CellEdgeView ceiling = Ceiling(i);
+        CellEdgeView floor = Floor(i);
+        for(int j = 0; j < Width(i); j++)
+        {
+            cell_graph[i].ceiling.emplace_back(ceiling[j]);
+            cell_graph[i].floor.emplace_back(floor[j]);
+        }
+        for(int j = 0; j < NeighborCount(i); j++)
+        {
+            cell_graph[i].neighbor_indices.emplace_back(Neighbor(i, j));
+        }
+        cell_graph[i].cellIndex = i;
+    }
+    CopyStatesTo(cell_graph);
+}
+
+
+
+
+/** 游程路径 **/
+
+
+void SegmentPath::Append(const Point2D& point)
+{
+    if(segments.empty())
+    {
+        segments.emplace_back(PathSegment(point, 0, 0, 1));
+        point_num = 1;
+        return;
+    }
+
+    PathSegment& last_segment = segments.back();
+    Point2D last_point = last_segment.End();
+    if(point == last_point)
+    {
+        return;
+    }
+
+    int dx = point.x - last_point.x;
+    int dy = point.y - last_point.y;
+
+    if(std::abs(dx) <= 1 && std::abs(dy) <= 1)
+    {
+        if(last_segment.length == 1)
+        {
+            last_segment.dx = dx;
+            last_segment.dy = dy;
+            last_segment.length = 2;
+            point_num++;
+            return;
+        }
+        if(dx == last_segment.dx && dy == last_segment.dy)
+        {
+            last_segment.length++;
+            point_num++;
+            return;
+        }
+    }
+
+    // 转弯或跳跃, 开始新的一段
+    segments.emplace_back(PathSegment(point, 0, 0, 1));
+    point_num++;
+}
+
+void SegmentPath::Append(const std::deque<Point2D>& path)
+{
+    for(const auto& point : path)
+    {
+        Append(point);
+    }
+}
+
+void SegmentPath::Append(const PathView& path)
+{
+    for(const auto& point : path)
+    {
+        Append(point);
+    }
+}
+
+void SegmentPath::Append(const SegmentPath& path)
+{
+    for(const auto& segment : path.segments)
+    {
+        Append(segment.start);
+        if(segment.length < 2)
+        {
+            continue;
+        }
+
+        // 此时最后一段以segment.start结尾
+        PathSegment& last_segment = segments.back();
+        if(last_segment.length == 1)
+        {
+            last_segment.dx = segment.dx;
+            last_segment.dy = segment.dy;
+            last_segment.length = segment.length;
+        }
+        else if(last_segment.dx == segment.dx && last_segment.dy == segment.dy)
+        {
+            last_segment.length += segment.length-1;
+        }
+        else
+        {
+            segments.emplace_back(PathSegment(segment.At(1), segment.dx, segment.dy, segment.length-1));
+        }
+        point_num += segment.length-1;
+    }
+}
+
+void SegmentPath::Clear()
+{
+    segments.clear();
+    point_num = 0;
+}
+
+std::deque<Point2D> SegmentPath::ToPoints() const
+{
+    std::deque<Point2D> points(begin(), end());
+    return points;
+}
+
+
+
+
+
+/** 生成运动指令 **/
+
+
+/** 两个输入参数都需要是单位向量, 输出的偏航角为正，则是顺时针旋转，为负则是逆时针旋转 **/
+double ComputeYaw(Eigen::Vector2d curr_direction, Eigen::Vector2d base_direction)
+{
+    double yaw = std::atan2(curr_direction[1], curr_direction[0]) - std::atan2(base_direction[1], base_direction[0]);
+
+    if(yaw > M_PI)
+    {
+        yaw -= 2*M_PI;
+    }
+    if(yaw < (-M_PI))
+    {
+        yaw += 2*M_PI;
+    }
+
+    yaw = yaw / M_PI * 180.0;
+
+    return yaw;
+}
+
+/** 单位为米 **/
+double ComputeDistance(const Point2D& start, const Point2D& end, double meters_per_pix)
+{
+    double dist = std::sqrt(std::pow((end.x-start.x),2)+std::pow((end.y-start.y),2));
+    dist = dist * meters_per_pix;
+    return dist;
+}
+
+
+/** 逐步累积运动指令, 方向不变的连续步合并为一条指令 **/
+class NavigationMessageBuilder
+{
+public:
+    NavigationMessageBuilder(const Eigen::Vector2d& curr_direction, double meters_per_pix)
+    {
+        global_base_direction = {0, -1}; // {x, y}
+        local_base_direction = curr_direction;
+        pix_size = meters_per_pix;
+
+        distance = 0.0;
+        prev_global_yaw = ComputeYaw(curr_direction, global_base_direction);
+
+        message.SetGlobalYaw(DBL_MAX);
+        message.SetLocalYaw(DBL_MAX);
+    }
+
+    // 从from到to走repeats次相同的一步
+    void AddStep(const Point2D& from, const Point2D& to, int repeats=1)
+    {
+        if(to == from || repeats <= 0)
+        {
+            return;
+        }
+
+        Eigen::Vector2d curr_local_direction = {to.x-from.x, to.y-from.y};
+        curr_local_direction.normalize();
+
+        double curr_global_yaw = ComputeYaw(curr_local_direction, global_base_direction);
+        double curr_local_yaw = ComputeYaw(curr_local_direction, local_base_direction);
+
+        if(message.GetGlobalYaw()==DBL_MAX) // initialization
+        {
+            message.SetGlobalYaw(curr_global_yaw);
+        }
+
+        if(message.GetLocalYaw()==DBL_MAX) // initialization
+        {
+            message.SetLocalYaw(curr_local_yaw);
+        }
+
+        double step_distance = ComputeDistance(to, from, pix_size);
+
+        if(curr_global_yaw != prev_global_yaw)
+        {
+            message.SetDistance(distance);
+            message_queue.emplace_back(message);
+
+            message.Reset();
+            message.SetGlobalYaw(curr_global_yaw);
+            message.SetLocalYaw(curr_local_yaw);
+
+            distance = 0.0;
+        }
+        distance += step_distance * repeats;
+
+        prev_global_yaw = curr_global_yaw;
+        local_base_direction = curr_local_direction;
+    }
+
+    std::vector<NavigationMessage> Finish()
+    {
+        message.SetDistance(distance);
+        message_queue.emplace_back(message);
+        return std::move(message_queue);
+    }
+
+private:
+    Eigen::Vector2d global_base_direction;
+    Eigen::Vector2d local_base_direction;
+    double pix_size;
+
+    NavigationMessage message;
+    std::vector<NavigationMessage> message_queue;
+
+    double distance;
+    double prev_global_yaw;
+};
+
+std::vector<NavigationMessage> GetNavigationMessage(const Eigen::Vector2d& curr_direction, const std::deque<Point2D>& pos_path, double meters_per_pix)
+{
+    BCD_PROFILE_SCOPE("GetNavigationMessage");
+
+    NavigationMessageBuilder builder(curr_direction, meters_per_pix);
+
+    for(int i = 0; i+1 < int(pos_path.size()); i++)
+    {
+        builder.AddStep(pos_path[i], pos_path[i+1]);
+    }
+
+    return builder.Finish();
+}
+
+std::vector<NavigationMessage> GetNavigationMessage(const Eigen::Vector2d& curr_direction, const SegmentPath& pos_path, double meters_per_pix)
+{
+    BCD_PROFILE_SCOPE("GetNavigationMessage");
+
+    NavigationMessageBuilder builder(curr_direction, meters_per_pix);
+
+    const std::vector<PathSegment>& segments = pos_path.GetSegments();
+    for(int i = 0; i < int(segments.size()); i++)
+    {
+        // 上一段的终点到本段起点
+        if(i > 0)
+        {
+            builder.AddStep(segments[i-1].End(), segments[i].start);
+        }
+        // 段内的每一步方向相同
+        if(segments[i].length > 1)
+        {
+            builder.AddStep(segments[i].start, segments[i].At(1), segments[i].length-1);
+        }
+    }
+
+    return builder.Finish();
+}
+
+std::vector<NavigationMessage> StaticNavigationPlanning(CellGraph& cell_graph, const Point2D& start_point, int robot_radius, const Eigen::Vector2d& curr_direction, double meters_per_pix,
+                                                       bool sequence_cells, bool parallel_sweeps)
+{
+    BCD_PROFILE_SCOPE("StaticNavigationPlanning");
+
+    NavigationMessageBuilder builder(curr_direction, meters_per_pix);
+
+    // 与FilterTrajectory相同, 跨子路径连续重复的点只算一次
+    bool has_prev_point = false;
+    Point2D prev_point;
+    auto sub_path_sink = [&](const PathView& sub_path)
+    {
+        for(const auto& point : sub_path)
+        {
+            if(has_prev_point && point != prev_point)
+            {
+                builder.AddStep(prev_point, point);
+            }
+            prev_point = point;
+            has_prev_point = true;
+        }
+    };
+    StaticPathPlanning(cell_graph, start_point, robot_radius, sequence_cells, parallel_sweeps, sub_path_sink);
+
+    return builder.Finish();
+}
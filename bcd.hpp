@@ -0,0 +1,739 @@
+#ifndef BCD_PLANNER_BCD_H
+#define BCD_PLANNER_BCD_H
+
+#include <climits>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <functional>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <Eigen/Core>
+
+
+/** 地图默认是空闲区域为白色，障碍物为黑色 **/
+
+enum EventType
+{
+    IN,
+    IN_TOP,
+    IN_BOTTOM,
+    OUT,
+    OUT_TOP,
+    OUT_BOTTOM,
+    INNER_IN,
+    INNER_IN_TOP,
+    INNER_IN_BOTTOM,
+    INNER_OUT,
+    INNER_OUT_TOP,
+    INNER_OUT_BOTTOM,
+
+    IN_EX,
+    IN_TOP_EX,
+    IN_BOTTOM_EX,
+    OUT_EX,
+    OUT_TOP_EX,
+    OUT_BOTTOM_EX,
+    INNER_IN_EX,
+    INNER_IN_TOP_EX,
+    INNER_IN_BOTTOM_EX,
+    INNER_OUT_EX,
+    INNER_OUT_TOP_EX,
+    INNER_OUT_BOTTOM_EX,
+
+    MIDDLE,
+    CEILING,
+    FLOOR,
+    UNALLOCATED
+};
+
+const int TOPLEFT = 0;
+const int BOTTOMLEFT = 1;
+const int BOTTOMRIGHT = 2;
+const int TOPRIGHT = 3;
+
+class Point2D
+{
+public:
+    Point2D()
+    {
+        x = INT_MAX;
+        y = INT_MAX;
+    }
+    Point2D(int x_pos, int y_pos)
+    {
+        x = x_pos;
+        y = y_pos;
+    }
+    Point2D(const Point2D& point)
+    {
+        x = point.x;
+        y = point.y;
+    }
+    int x;
+    int y;
+};
+
+/** 多边形顶点按照逆时针旋转排序 **/
+typedef std::vector<Point2D> Polygon;
+typedef std::vector<Polygon> PolygonList;
+typedef std::deque<Point2D> Edge;
+
+class Event
+{
+public:
+    Event(int obstacle_idx, int x_pos, int y_pos, EventType type=UNALLOCATED)
+    {
+        obstacle_index = obstacle_idx;
+        x = x_pos;
+        y = y_pos;
+        event_type = type;
+        original_index_in_slice = INT_MAX;
+        isUsed = false;
+    }
+
+    int x;
+    int y;
+    int original_index_in_slice;
+    int obstacle_index;
+    EventType event_type;
+
+    bool isUsed;
+};
+
+/** 同一x上的事件的只读视图, 指向SliceList中连续存放的事件 **/
+class SliceView
+{
+public:
+    SliceView(const Event* first_event, int event_num)
+    {
+        events = first_event;
+        num = event_num;
+    }
+    const Event& operator[](int index) const
+    {
+        return events[index];
+    }
+    const Event& front() const
+    {
+        return events[0];
+    }
+    const Event& back() const
+    {
+        return events[num-1];
+    }
+    const Event* begin() const
+    {
+        return events;
+    }
+    const Event* end() const
+    {
+        return events + num;
+    }
+    int size() const
+    {
+        return num;
+    }
+    bool empty() const
+    {
+        return num == 0;
+    }
+
+private:
+    const Event* events;
+    int num;
+};
+
+/** 按x分组的事件表: 过滤掉MIDDLE与UNALLOCATED后的事件按(x, y)顺序存放在同一数组中, **/
+/** 第i个slice为[slice_offsets[i], slice_offsets[i+1]) **/
+class SliceList
+{
+public:
+    SliceList()
+    {
+        slice_offsets.emplace_back(0);
+    }
+
+    void Clear()
+    {
+        events.clear();
+        slice_offsets.assign(1, 0);
+    }
+    int size() const
+    {
+        return int(slice_offsets.size()) - 1;
+    }
+    bool empty() const
+    {
+        return size() == 0;
+    }
+    SliceView operator[](int slice_index) const
+    {
+        return SliceView(events.data()+slice_offsets[slice_index], slice_offsets[slice_index+1]-slice_offsets[slice_index]);
+    }
+
+    std::vector<Event> events;
+    std::vector<int> slice_offsets;
+};
+
+class CellNode
+{
+public:
+    CellNode()
+    {
+        isVisited = false;
+        isCleaned = false;
+        parentIndex = INT_MAX;
+        cellIndex = INT_MAX;
+    }
+    bool isVisited;
+    bool isCleaned;
+    Edge ceiling;
+    Edge floor;
+
+    int parentIndex;
+    std::deque<int> neighbor_indices;
+
+    int cellIndex;
+};
+
+/** cell的ceiling或floor的只读视图, 第i个点的x为left+i, y取自扁平数组 **/
+class CellEdgeView
+{
+public:
+    CellEdgeView(int left_x, const int* y_list, int point_num)
+    {
+        left = left_x;
+        y_values = y_list;
+        num = point_num;
+    }
+    Point2D operator[](int index) const
+    {
+        return Point2D(left + index, y_values[index]);
+    }
+    Point2D front() const
+    {
+        return (*this)[0];
+    }
+    Point2D back() const
+    {
+        return (*this)[num-1];
+    }
+    int size() const
+    {
+        return num;
+    }
+
+private:
+    int left;
+    const int* y_values;
+    int num;
+};
+
+class SweepCache;
+
+/** 扁平存储的cell graph **/
+/** 每个cell占据连续的若干列, 每列只有一个ceiling点和一个floor点, 因此只需存储最左列的x与各列的y; **/
+/** 所有cell的y值首尾相接存放在同一数组中, 邻接关系按CSR格式存放; cell的下标即cellIndex **/
+class CellGraph
+{
+public:
+    CellGraph();
+    explicit CellGraph(const std::vector<CellNode>& cell_graph);
+
+    void Assign(const std::vector<CellNode>& cell_graph);
+    void Clear();
+
+    int Size() const
+    {
+        return int(left_x.size());
+    }
+    bool Empty() const
+    {
+        return left_x.empty();
+    }
+
+    int Left(int cell_index) const
+    {
+        return left_x[cell_index];
+    }
+    int Right(int cell_index) const
+    {
+        return left_x[cell_index] + Width(cell_index) - 1;
+    }
+    int Width(int cell_index) const
+    {
+        return column_offsets[cell_index+1] - column_offsets[cell_index];
+    }
+    CellEdgeView Ceiling(int cell_index) const
+    {
+        return CellEdgeView(left_x[cell_index], ceiling_y.data()+column_offsets[cell_index], Width(cell_index));
+    }
+    CellEdgeView Floor(int cell_index) const
+    {
+        return CellEdgeView(left_x[cell_index], floor_y.data()+column_offsets[cell_index], Width(cell_index));
+    }
+
+    int NeighborCount(int cell_index) const
+    {
+        return neighbor_offsets[cell_index+1] - neighbor_offsets[cell_index];
+    }
+    int Neighbor(int cell_index, int i) const
+    {
+        return neighbor_list[neighbor_offsets[cell_index]+i];
+    }
+
+    // 规划过程中的状态
+    bool IsVisited(int cell_index) const
+    {
+        return visited_flags[cell_index] != 0;
+    }
+    void SetVisited(int cell_index, bool visited)
+    {
+        visited_flags[cell_index] = visited;
+    }
+    bool IsCleaned(int cell_index) const
+    {
+        return cleaned_flags[cell_index] != 0;
+    }
+    void SetCleaned(int cell_index, bool cleaned)
+    {
+        cleaned_flags[cell_index] = cleaned;
+    }
+    int ParentIndex(int cell_index) const
+    {
+        return parent_indices[cell_index];
+    }
+    void SetParentIndex(int cell_index, int parent_index)
+    {
+        parent_indices[cell_index] = parent_index;
+    }
+    void ResetStates();
+    // 把规划状态写回CellNode形式的graph
+    void CopyStatesTo(std::vector<CellNode>& cell_graph) const;
+    // 还原为CellNode形式的graph(含规划状态)
+    void CopyTo(std::vector<CellNode>& cell_graph) const;
+
+    // 查找包含point的所有cell, 按下标从小到大输出, 复杂度为O(log k), k为该列上的cell数
+    void Locate(const Point2D& point, std::vector<int>& cell_indices) const;
+
+    // 规划时往返路径先查这个缓存; 拷贝CellGraph时共享同一个缓存, Assign/Clear不会去掉它
+    void SetSweepCache(const std::shared_ptr<SweepCache>& sweep_cache)
+    {
+        this->sweep_cache = sweep_cache;
+    }
+    const std::shared_ptr<SweepCache>& GetSweepCache() const
+    {
+        return sweep_cache;
+    }
+
+private:
+    // 二进制文件直接读写下面的数组, 包括按列的区间索引
+    friend class CellGraphFile;
+
+    void BuildColumnIndex();
+
+    /** 按列索引的区间: 每列上各cell占据的[ceiling_y, floor_y]按ceiling_y排序 **/
+    /** 相邻cell在事件列上会重叠, 因此额外记录到当前区间为止floor_y的最大值, 用于二分查找 **/
+    class ColumnInterval
+    {
+    public:
+        int ceiling_y;
+        int floor_y;
+        int max_floor_y;
+        int cell_index;
+    };
+
+    std::vector<int> left_x;
+    // 第i个cell的列在ceiling_y/floor_y中的范围为[column_offsets[i], column_offsets[i+1])
+    std::vector<int> column_offsets;
+    std::vector<int> ceiling_y;
+    std::vector<int> floor_y;
+    // 第i个cell的邻居为neighbor_list[neighbor_offsets[i]]到neighbor_list[neighbor_offsets[i+1]-1]
+    std::vector<int> neighbor_offsets;
+    std::vector<int> neighbor_list;
+
+    std::vector<char> visited_flags;
+    std::vector<char> cleaned_flags;
+    std::vector<int> parent_indices;
+
+    // 第x列的区间为column_intervals[interval_offsets[x-min_column_x]]起的若干个
+    int min_column_x;
+    std::vector<int> interval_offsets;
+    std::vector<ColumnInterval> column_intervals;
+
+    std::shared_ptr<SweepCache> sweep_cache;
+};
+
+/** 连续存放的一段路径的只读视图, 不拥有数据, 只在产生它的调用期间有效 **/
+class PathView
+{
+public:
+    PathView(const Point2D* first_point, int point_num)
+    {
+        points = first_point;
+        num = point_num;
+    }
+    const Point2D& operator[](int index) const
+    {
+        return points[index];
+    }
+    const Point2D& front() const
+    {
+        return points[0];
+    }
+    const Point2D& back() const
+    {
+        return points[num-1];
+    }
+    const Point2D* begin() const
+    {
+        return points;
+    }
+    const Point2D* end() const
+    {
+        return points + num;
+    }
+    int size() const
+    {
+        return num;
+    }
+    bool empty() const
+    {
+        return num == 0;
+    }
+
+private:
+    const Point2D* points;
+    int num;
+};
+
+/** 路径的游程表示: 每段为从start出发沿(dx, dy)方向的length个像素, 方向为水平、竖直或对角 **/
+class PathSegment
+{
+public:
+    PathSegment()
+    {
+        dx = 0;
+        dy = 0;
+        length = 0;
+    }
+    PathSegment(const Point2D& start_point, int x_step, int y_step, int segment_length)
+    {
+        start = start_point;
+        dx = x_step;
+        dy = y_step;
+        length = segment_length;
+    }
+    Point2D At(int step) const
+    {
+        return Point2D(start.x + dx*step, start.y + dy*step);
+    }
+    Point2D End() const
+    {
+        return At(length-1);
+    }
+
+    Point2D start;
+    int dx;
+    int dy;
+    int length;
+};
+
+/** 连续重复的点只保留一个, 逐像素的展开通过迭代器惰性完成 **/
+class SegmentPath
+{
+public:
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Point2D value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Point2D* pointer;
+        typedef Point2D reference;
+
+        const_iterator()
+        {
+            segments = nullptr;
+            segment_index = 0;
+            step = 0;
+        }
+        const_iterator(const std::vector<PathSegment>* segment_list, size_t index)
+        {
+            segments = segment_list;
+            segment_index = index;
+            step = 0;
+        }
+
+        Point2D operator*() const
+        {
+            return (*segments)[segment_index].At(step);
+        }
+        const_iterator& operator++()
+        {
+            step++;
+            if(step >= (*segments)[segment_index].length)
+            {
+                segment_index++;
+                step = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator iter = *this;
+            ++(*this);
+            return iter;
+        }
+        bool operator==(const const_iterator& iter) const
+        {
+            return segment_index == iter.segment_index && step == iter.step;
+        }
+        bool operator!=(const const_iterator& iter) const
+        {
+            return !(*this == iter);
+        }
+
+    private:
+        const std::vector<PathSegment>* segments;
+        size_t segment_index;
+        int step;
+    };
+
+    SegmentPath()
+    {
+        point_num = 0;
+    }
+    explicit SegmentPath(const std::deque<Point2D>& path)
+    {
+        point_num = 0;
+        Append(path);
+    }
+
+    void Append(const Point2D& point);
+    void Append(const std::deque<Point2D>& path);
+    void Append(const PathView& path);
+    void Append(const SegmentPath& path);
+    void Clear();
+
+    bool Empty() const
+    {
+        return segments.empty();
+    }
+    // 展开后的像素数
+    size_t Size() const
+    {
+        return point_num;
+    }
+    Point2D Front() const
+    {
+        return segments.front().start;
+    }
+    Point2D Back() const
+    {
+        return segments.back().End();
+    }
+    const std::vector<PathSegment>& GetSegments() const
+    {
+        return segments;
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(&segments, 0);
+    }
+    const_iterator end() const
+    {
+        return const_iterator(&segments, segments.size());
+    }
+
+    std::deque<Point2D> ToPoints() const;
+
+private:
+    std::vector<PathSegment> segments;
+    size_t point_num;
+};
+
+inline bool operator<(const Point2D& p1, const Point2D& p2)
+{
+    return (p1.x < p2.x || (p1.x == p2.x && p1.y < p2.y));
+}
+
+inline bool operator<(const Event& e1, const Event& e2)
+{
+    return (e1.x < e2.x || (e1.x == e2.x && e1.y < e2.y) || (e1.x == e2.x && e1.y == e2.y && e1.obstacle_index < e2.obstacle_index));
+}
+
+inline bool operator==(const Point2D& p1, const Point2D& p2)
+{
+    return (p1.x==p2.x && p1.y==p2.y);
+}
+
+inline bool operator!=(const Point2D& p1, const Point2D& p2)
+{
+    return !(p1==p2);
+}
+
+
+
+
+/** 路径规划功能函数 **/
+
+
+int WrappedIndex(int index, int list_length);
+
+std::vector<int> GetVisittingPath(CellGraph& cell_graph, int first_cell_index);
+std::vector<Point2D> ComputeCellCornerPoints(const CellNode& cell);
+std::vector<Point2D> ComputeCellCornerPoints(const CellGraph& cell_graph, int cell_index);
+std::vector<int> DetermineCellIndex(const std::vector<CellNode>& cell_graph, const Point2D& point);
+std::vector<int> DetermineCellIndex(const CellGraph& cell_graph, const Point2D& point);
+std::deque<Point2D> GetBoustrophedonPath(const CellGraph& cell_graph, int cell_index, int corner_indicator, int robot_radius);
+
+std::vector<Event> InitializeEventList(const Polygon& polygon, int polygon_index);
+void AllocateObstacleEventType(const cv::Mat& map, std::vector<Event>& event_list);
+void AllocateWallEventType(const cv::Mat& map, std::vector<Event>& event_list);
+std::vector<Event> MergeEventLists(const std::vector<std::vector<Event>>& event_lists);
+std::vector<Event> GenerateObstacleEventList(const cv::Mat& map, const PolygonList& polygons);
+std::vector<Event> GenerateWallEventList(const cv::Mat& map, const Polygon& external_contour);
+SliceList SliceListGenerator(const std::vector<Event>& wall_event_list, const std::vector<Event>& obstacle_event_list);
+
+void ExecuteCellDecomposition(std::vector<CellNode>& cell_graph, std::vector<int>& cell_index_slice, std::vector<int>& original_cell_index_slice, const SliceList& slice_list);
+// 同时生成扁平的cell graph及其按列的区间索引, 供规划时O(log k)地查找点所在的cell
+void ExecuteCellDecomposition(std::vector<CellNode>& cell_graph, CellGraph& flat_cell_graph, std::vector<int>& cell_index_slice, std::vector<int>& original_cell_index_slice, const SliceList& slice_list);
+// 把slice切成竖直条带并行扫描, 在接缝处合并跨条带的cell, 结果与单线程扫描相同; stripe_num<=0时按线程池大小切分
+void ExecuteStripedCellDecomposition(std::vector<CellNode>& cell_graph, const SliceList& slice_list, int stripe_num=0);
+void ExecuteStripedCellDecomposition(std::vector<CellNode>& cell_graph, CellGraph& flat_cell_graph, const SliceList& slice_list, int stripe_num=0);
+
+Point2D FindNextEntrance(const Point2D& curr_point, const CellGraph& cell_graph, int next_cell_index, int& corner_indicator);
+std::deque<Point2D> WalkInsideCell(const CellGraph& cell_graph, int cell_index, const Point2D& start, const Point2D& end);
+std::deque<std::deque<Point2D>> FindLinkingPath(const Point2D& curr_exit, Point2D& next_entrance, int& corner_indicator, const CellGraph& cell_graph, int curr_cell_index, int next_cell_index);
+std::deque<Point2D> WalkCrossCells(const CellGraph& cell_graph, const std::deque<int>& cell_path, const Point2D& start, const Point2D& end, int robot_radius);
+std::deque<int> FindShortestPath(const CellGraph& cell_graph, const Point2D& start, const Point2D& end);
+
+// 按GetBoustrophedonPath的走法, 从corner_indicator进入cell后离开时所在的corner
+int ComputeExitCorner(const CellGraph& cell_graph, int cell_index, int corner_indicator, int robot_radius);
+// 以转移代价优化的访问顺序, 每个cell只出现一次, entry_corners为对应cell的入口corner
+std::vector<int> SequenceCells(const CellGraph& cell_graph, int first_cell_index, const Point2D& start_point, int robot_radius, std::vector<int>& entry_corners);
+
+
+
+
+/** 静态路径规划流程 **/
+
+
+int ComputeRobotRadius(const double& meters_per_pix, const double& robot_size_in_meters);
+cv::Mat1b ReadMap(const std::string& map_file_path);
+cv::Mat1b PreprocessMap(const cv::Mat1b& original_map);
+void ExtractRawContours(const cv::Mat& original_map, std::vector<std::vector<cv::Point>>& raw_wall_contours, std::vector<std::vector<cv::Point>>& raw_obstacle_contours);
+// 墙内每个空闲点到最近的障碍(含墙的轮廓点)的欧氏距离, 障碍上为0
+cv::Mat1f ComputeObstacleDistanceField(const cv::Mat& original_map, const std::vector<std::vector<cv::Point>>& wall_contours, const std::vector<std::vector<cv::Point>>& obstacle_contours);
+// 距离大于robot_radius的点为空闲(255), 即配置空间
+cv::Mat1b InflateObstacles(const cv::Mat1f& distance_field, int robot_radius);
+// 从距离场得到膨胀后的墙与障碍物轮廓, 没有剩余的空闲区域时轮廓为空
+void ExtractInflatedContours(const cv::Mat1f& distance_field, int robot_radius, std::vector<std::vector<cv::Point>>& wall_contours, std::vector<std::vector<cv::Point>>& obstacle_contours);
+void ExtractContours(const cv::Mat& original_map, std::vector<std::vector<cv::Point>>& wall_contours, std::vector<std::vector<cv::Point>>& obstacle_contours, int robot_radius=0);
+PolygonList ConstructObstacles(const cv::Mat& original_map, const std::vector<std::vector<cv::Point>>& obstacle_contours);
+Polygon ConstructDefaultWall(const cv::Mat& original_map);
+Polygon ConstructWall(const cv::Mat& original_map, std::vector<cv::Point>& wall_contour);
+cv::Mat3b ConstructFreeSpaceMap(const cv::Mat& original_map, const std::vector<std::vector<cv::Point>>& wall_contours, const std::vector<std::vector<cv::Point>>& obstacle_contours);
+std::vector<CellNode> ConstructCellGraph(const cv::Mat& original_map, const std::vector<std::vector<cv::Point>>& wall_contours, const std::vector<std::vector<cv::Point>>& obstacle_contours, const Polygon& wall, const PolygonList& obstacles);
+// 顶点级分解, 不需要逐像素展开的多边形; 事件表中只有极值处的事件
+std::vector<CellNode> ConstructCellGraphFromVertices(const cv::Mat& original_map, const std::vector<std::vector<cv::Point>>& wall_contours, const std::vector<std::vector<cv::Point>>& obstacle_contours, std::vector<Event>& wall_event_list, std::vector<Event>& obstacle_event_list);
+
+// CellNode版本先转换为扁平的CellGraph再规划, 规划状态会写回cell_graph
+std::deque<std::deque<Point2D>> StaticPathPlanning(std::vector<CellNode>& cell_graph, const Point2D& start_point, int robot_radius);
+// sequence_cells为true时用SequenceCells优化cell的访问顺序, 否则按深度优先顺序
+// parallel_sweeps为true时先定出各cell的入口corner, 再在线程池中并行生成各cell的往返路径, 结果相同
+std::deque<std::deque<Point2D>> StaticPathPlanning(CellGraph& cell_graph, const Point2D& start_point, int robot_radius, bool sequence_cells=false, bool parallel_sweeps=false);
+// parallel_sweeps时某条往返路径的终点与推出的出口不一致, 退回逐个生成的累计次数(整个进程, 所有线程)
+long long ParallelSweepFallbackCount();
+// 每生成一段子路径就交给sub_path_sink, 不保存整条路径; 子路径的视图只在回调期间有效, 依次拼接即为上面返回的路径
+typedef std::function<void(const PathView&)> SubPathSink;
+void StaticPathPlanning(CellGraph& cell_graph, const Point2D& start_point, int robot_radius, bool sequence_cells, bool parallel_sweeps, const SubPathSink& sub_path_sink);
+// 与上面相同的规划, 每段子路径生成后立即压缩成游程表示
+std::deque<SegmentPath> StaticSegmentPathPlanning(std::vector<CellNode>& cell_graph, const Point2D& start_point, int robot_radius);
+std::deque<SegmentPath> StaticSegmentPathPlanning(CellGraph& cell_graph, const Point2D& start_point, int robot_radius, bool sequence_cells=false, bool parallel_sweeps=false);
+std::deque<Point2D> ReturningPathPlanning(std::vector<CellNode>& cell_graph, const Point2D& curr_pos, const Point2D& original_pos, int robot_radius);
+std::deque<Point2D> ReturningPathPlanning(const CellGraph& cell_graph, const Point2D& curr_pos, const Point2D& original_pos, int robot_radius);
+std::deque<Point2D> FilterTrajectory(const std::deque<std::deque<Point2D>>& raw_trajectory);
+SegmentPath FilterTrajectory(const std::deque<SegmentPath>& raw_trajectory);
+
+
+
+
+/** 生成运动指令 **/
+
+
+class NavigationMessage
+{
+public:
+    NavigationMessage()
+    {
+        foward_distance = 0.0;
+        global_yaw_angle = 0.0;
+        local_yaw_angle = 0.0;
+    }
+    void SetDistance(double dist)
+    {
+        foward_distance = dist;
+    }
+    void SetGlobalYaw(double global_yaw)
+    {
+        global_yaw_angle = global_yaw;
+    }
+    void SetLocalYaw(double local_yaw)
+    {
+        local_yaw_angle = local_yaw;
+    }
+
+    double GetDistance()
+    {
+        return foward_distance;
+    }
+
+    double GetGlobalYaw()
+    {
+        return global_yaw_angle;
+    }
+
+    double GetLocalYaw()
+    {
+        return local_yaw_angle;
+    }
+
+    void GetMotion(double& dist, double& global_yaw, double& local_yaw)
+    {
+        dist = foward_distance;
+        global_yaw = global_yaw_angle;
+        local_yaw = local_yaw_angle;
+    }
+    void Reset()
+    {
+        foward_distance = 0.0;
+        global_yaw_angle = 0.0;
+        local_yaw_angle = 0.0;
+    }
+
+private:
+    double foward_distance;
+    // 欧拉角表示，逆时针为正，顺时针为负
+    double global_yaw_angle;
+    double local_yaw_angle;
+};
+
+double ComputeYaw(Eigen::Vector2d curr_direction, Eigen::Vector2d base_direction);
+double ComputeDistance(const Point2D& start, const Point2D& end, double meters_per_pix);
+std::vector<NavigationMessage> GetNavigationMessage(const Eigen::Vector2d& curr_direction, const std::deque<Point2D>& pos_path, double meters_per_pix);
+// 逐段计算, 不展开成像素
+std::vector<NavigationMessage> GetNavigationMessage(const Eigen::Vector2d& curr_direction, const SegmentPath& pos_path, double meters_per_pix);
+// 边规划边生成运动指令, 不保存路径, 结果与GetNavigationMessage(curr_direction, FilterTrajectory(StaticPathPlanning(...)), meters_per_pix)相同
+std::vector<NavigationMessage> StaticNavigationPlanning(CellGraph& cell_graph, const Point2D& start_point, int robot_radius, const Eigen::Vector2d& curr_direction, double meters_per_pix,
+                                                       bool sequence_cells=false, bool parallel_sweeps=false);
+
+#endif //BCD_PLANNER_BCD_H
@@ -0,0 +1,1178 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include <climits>
+#include <functional>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgcodecs/imgcodecs.hpp>
+
+#include <Eigen/Core>
+
+#include "bcd.hpp"
+#include "planner.hpp"
+#include "planner_daemon.hpp"
+#include "test_data.hpp"
+#include "profiler.hpp"
+#include "streaming.hpp"
+#include "cell_graph_file.hpp"
+#include "plan_cache.hpp"
+#include "sweep_cache.hpp"
+
+
+/** 分阶段计时的基准测试, 结果写入csv文件 **/
+
+
+class BenchScene
+{
+public:
+    std::string name;
+    cv::Mat1b map;
+    // 提取轮廓时的膨胀半径与规划时的清扫半径, 与main.cpp中的用例保持一致
+    int inflation_radius;
+    int robot_radius;
+    // 合成地图的障碍物数量, 其余场景为-1
+    int obstacle_num;
+    bool center_start;
+};
+
+class StageRecord
+{
+public:
+    std::string scene;
+    int width;
+    int height;
+    int obstacle_num;
+    int robot_radius;
+    std::string stage;
+    int run;
+    double milliseconds;
+    // 该阶段产出的数量: 轮廓数, 事件数, slice数, cell数, 路径点数, 指令数
+    size_t items;
+};
+
+class BenchOptions
+{
+public:
+    BenchOptions()
+    {
+        map_dir = "..";
+        output_path = "bcd_bench.csv";
+        profile_dir = "";
+        sizes = {500, 1000, 2000, 5000, 10000, 20000};
+        obstacle_nums = {1, 10, 100, 1000, 10000};
+        repeats = 3;
+        robot_radius = 5;
+        seed = 0;
+        inflation_sweep = 50;
+        run_bundled = true;
+        run_synthetic = true;
+        event_check_path = "";
+        write_events = false;
+    }
+
+    std::string map_dir;
+    std::string output_path;
+    // 非空时把每个场景第一轮的profile写到该目录下
+    std::string profile_dir;
+    std::vector<int> sizes;
+    std::vector<int> obstacle_nums;
+    int repeats;
+    int robot_radius;
+    unsigned int seed;
+    // 在内置地图上对半径1..inflation_sweep比较两种膨胀方法, 不同的像素须在1像素之内, 0为不比较
+    int inflation_sweep;
+    bool run_bundled;
+    bool run_synthetic;
+    // 非空时只做事件分类的回归检查(RunEventCheck), 不计时; write_events为true时改为重新生成期望输出
+    std::string event_check_path;
+    bool write_events;
+};
+
+typedef std::chrono::steady_clock BenchClock;
+
+double ElapsedMilliseconds(const BenchClock::time_point& start)
+{
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+std::vector<int> ParseIntList(const std::string& text)
+{
+    std::vector<int> values;
+    std::stringstream stream(text);
+    std::string item;
+    while(std::getline(stream, item, ','))
+    {
+        if(!item.empty())
+        {
+            values.emplace_back(std::atoi(item.c_str()));
+        }
+    }
+    return values;
+}
+
+bool ParseOptions(int argc, char** argv, BenchOptions& options)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool has_value = (i+1 < argc);
+
+        if(arg == "--map-dir" && has_value)
+        {
+            options.map_dir = argv[++i];
+        }
+        else if(arg == "--output" && has_value)
+        {
+            options.output_path = argv[++i];
+        }
+        else if(arg == "--profile" && has_value)
+        {
+            options.profile_dir = argv[++i];
+        }
+        else if(arg == "--sizes" && has_value)
+        {
+            options.sizes = ParseIntList(argv[++i]);
+        }
+        else if(arg == "--obstacles" && has_value)
+        {
+            options.obstacle_nums = ParseIntList(argv[++i]);
+        }
+        else if(arg == "--repeat" && has_value)
+        {
+            options.repeats = std::max(1, std::atoi(argv[++i]));
+        }
+        else if(arg == "--radius" && has_value)
+        {
+            options.robot_radius = std::max(0, std::atoi(argv[++i]));
+        }
+        else if(arg == "--seed" && has_value)
+        {
+            options.seed = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if(arg == "--inflation-sweep" && has_value)
+        {
+            options.inflation_sweep = std::max(0, std::atoi(argv[++i]));
+        }
+        else if(arg == "--no-bundled")
+        {
+            options.run_bundled = false;
+        }
+        else if(arg == "--no-synthetic")
+        {
+            options.run_synthetic = false;
+        }
+        else if(arg == "--check-events" && has_value)
+        {
+            options.event_check_path = argv[++i];
+            options.write_events = false;
+        }
+        else if(arg == "--write-events" && has_value)
+        {
+            options.event_check_path = argv[++i];
+            options.write_events = true;
+        }
+        else
+        {
+            std::cerr<<"usage: bcd_bench [--map-dir dir] [--output file.csv] [--sizes 500,1000,...] [--obstacles 1,10,...]"<<std::endl;
+            std::cerr<<"                 [--repeat n] [--radius r] [--seed s] [--profile dir] [--inflation-sweep max_r] [--no-bundled] [--no-synthetic]"<<std::endl;
+            std::cerr<<"       bcd_bench --check-events expected.txt | --write-events expected.txt [--map-dir dir]"<<std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<BenchScene> ConstructBundledScenes(const BenchOptions& options)
+{
+    std::vector<BenchScene> scenes;
+
+    BenchScene scene;
+
+    // 与StaticPathPlanningExample1相同的参数
+    scene.name = "map";
+    scene.map = ReadMap(options.map_dir + "/map.png");
+    scene.robot_radius = ComputeRobotRadius(0.02, 0.15);
+    scene.inflation_radius = scene.robot_radius;
+    scene.obstacle_num = -1;
+    scene.center_start = true;
+    if(!scene.map.empty())
+    {
+        scene.map = PreprocessMap(scene.map);
+        scenes.emplace_back(scene);
+    }
+    else
+    {
+        std::cerr<<"skip map: cannot read "<<options.map_dir<<"/map.png"<<std::endl;
+    }
+
+    scene.name = "complicate_map";
+    scene.map = ReadMap(options.map_dir + "/complicate_map.png");
+    scene.robot_radius = 5;
+    scene.inflation_radius = 0;
+    scene.center_start = false;
+    if(!scene.map.empty())
+    {
+        scene.map = PreprocessMap(scene.map);
+        scenes.emplace_back(scene);
+    }
+    else
+    {
+        std::cerr<<"skip complicate_map: cannot read "<<options.map_dir<<"/complicate_map.png"<<std::endl;
+    }
+
+    for(int i = 1; i <= 5; i++)
+    {
+        scene.name = "handcrafted_" + std::to_string(i);
+        scene.map = ConstructHandcraftedMap(i);
+        scene.robot_radius = 5;
+        scene.inflation_radius = 0;
+        scene.center_start = false;
+        scenes.emplace_back(scene);
+    }
+
+    return scenes;
+}
+
+void RecordStage(std::vector<StageRecord>& records, const BenchScene& scene, const std::string& stage, int run, double milliseconds, size_t items)
+{
+    StageRecord record;
+    record.scene = scene.name;
+    record.width = scene.map.cols;
+    record.height = scene.map.rows;
+    record.obstacle_num = scene.obstacle_num;
+    record.robot_radius = scene.robot_radius;
+    record.stage = stage;
+    record.run = run;
+    record.milliseconds = milliseconds;
+    record.items = items;
+    records.emplace_back(record);
+
+    std::cout<<scene.name<<" run "<<run<<" "<<stage<<": "<<milliseconds<<" ms ("<<items<<")"<<std::endl;
+}
+
+// 依次执行规划流程中的每个阶段并单独计时, 失败时返回false
+bool RunScene(const BenchScene& scene, int run, std::vector<StageRecord>& records)
+{
+    const cv::Mat1b& map = scene.map;
+    BenchClock::time_point start;
+
+    std::vector<std::vector<cv::Point>> wall_contours;
+    std::vector<std::vector<cv::Point>> obstacle_contours;
+    start = BenchClock::now();
+    ExtractContours(map, wall_contours, obstacle_contours, scene.inflation_radius);
+    RecordStage(records, scene, "ExtractContours", run, ElapsedMilliseconds(start), wall_contours.size()+obstacle_contours.size());
+    if(wall_contours.empty())
+    {
+        return false;
+    }
+
+    start = BenchClock::now();
+    Polygon wall = ConstructWall(map, wall_contours.front());
+    RecordStage(records, scene, "ConstructWall", run, ElapsedMilliseconds(start), wall.size());
+
+    start = BenchClock::now();
+    PolygonList obstacles = ConstructObstacles(map, obstacle_contours);
+    RecordStage(records, scene, "ConstructObstacles", run, ElapsedMilliseconds(start), obstacles.size());
+
+    start = BenchClock::now();
+    cv::Mat3b free_space_map = ConstructFreeSpaceMap(map, wall_contours, obstacle_contours);
+    RecordStage(records, scene, "ConstructFreeSpaceMap", run, ElapsedMilliseconds(start), size_t(free_space_map.total()));
+
+    start = BenchClock::now();
+    std::vector<Event> wall_event_list = GenerateWallEventList(free_space_map, wall);
+    RecordStage(records, scene, "GenerateWallEventList", run, ElapsedMilliseconds(start), wall_event_list.size());
+
+    start = BenchClock::now();
+    std::vector<Event> obstacle_event_list = GenerateObstacleEventList(free_space_map, obstacles);
+    RecordStage(records, scene, "GenerateObstacleEventList", run, ElapsedMilliseconds(start), obstacle_event_list.size());
+
+    start = BenchClock::now();
+    SliceList slice_list = SliceListGenerator(wall_event_list, obstacle_event_list);
+    RecordStage(records, scene, "SliceListGenerator", run, ElapsedMilliseconds(start), slice_list.size());
+
+    std::vector<CellNode> cell_graph;
+    std::vector<int> cell_index_slice;
+    std::vector<int> original_cell_index_slice;
+    start = BenchClock::now();
+    ExecuteCellDecomposition(cell_graph, cell_index_slice, original_cell_index_slice, slice_list);
+    RecordStage(records, scene, "ExecuteCellDecomposition", run, ElapsedMilliseconds(start), cell_graph.size());
+    if(cell_graph.empty() || cell_graph.front().ceiling.empty())
+    {
+        return false;
+    }
+
+    // 按线程池大小切分条带, 结果与上面相同
+    std::vector<CellNode> striped_cell_graph;
+    start = BenchClock::now();
+    ExecuteStripedCellDecomposition(striped_cell_graph, slice_list);
+    RecordStage(records, scene, "ExecuteStripedCellDecomposition", run, ElapsedMilliseconds(start), striped_cell_graph.size());
+
+    start = BenchClock::now();
+    CellGraph flat_cell_graph(cell_graph);
+    RecordStage(records, scene, "BuildCellGraph", run, ElapsedMilliseconds(start), flat_cell_graph.Size());
+
+    // 二进制文件的写入与启动时的读取(mmap, 检查, 拷贝进CellGraph), items为文件中的cell数
+    std::string cell_graph_file_path = scene.name + ".bcdgraph";
+    start = BenchClock::now();
+    bool cell_graph_file_written = CellGraphFile::Write(cell_graph_file_path, map, scene.inflation_radius, false, flat_cell_graph, wall_contours, obstacle_contours);
+    RecordStage(records, scene, "CellGraphFile::Write", run, ElapsedMilliseconds(start), flat_cell_graph.Size());
+    if(cell_graph_file_written)
+    {
+        CellGraph loaded_cell_graph;
+        std::vector<std::vector<cv::Point>> loaded_wall_contours;
+        std::vector<std::vector<cv::Point>> loaded_obstacle_contours;
+        start = BenchClock::now();
+        CellGraphFile cell_graph_file;
+        if(cell_graph_file.Open(cell_graph_file_path))
+        {
+            cell_graph_file.Load(loaded_cell_graph, loaded_wall_contours, loaded_obstacle_contours);
+        }
+        RecordStage(records, scene, "CellGraphFile::Load", run, ElapsedMilliseconds(start), loaded_cell_graph.Size());
+        cell_graph_file.Close();
+        std::remove(cell_graph_file_path.c_str());
+    }
+
+    // 顶点级分解走完整个分解流程(不含ExtractContours), items为极值事件数, 与上面逐像素的事件数比较
+    std::vector<Event> critical_wall_events;
+    std::vector<Event> critical_obstacle_events;
+    start = BenchClock::now();
+    std::vector<CellNode> vertex_cell_graph = ConstructCellGraphFromVertices(map, wall_contours, obstacle_contours, critical_wall_events, critical_obstacle_events);
+    RecordStage(records, scene, "ConstructCellGraphFromVertices", run, ElapsedMilliseconds(start), critical_wall_events.size()+critical_obstacle_events.size());
+
+    // 近似流式分解从PGM文件按512列的列带读取, 写文件不计时, cell只计数不落盘
+    std::string stream_map_path = scene.name + ".stream.pgm";
+    if(cv::imwrite(stream_map_path, map))
+    {
+        size_t streamed_cell_num = 0;
+        start = BenchClock::now();
+        ApproximateStreamingDecomposition(stream_map_path, scene.inflation_radius, 512, [&streamed_cell_num](const CellNode&){ streamed_cell_num++; });
+        RecordStage(records, scene, "ApproximateStreamingDecomposition", run, ElapsedMilliseconds(start), streamed_cell_num);
+        std::remove(stream_map_path.c_str());
+    }
+
+    Point2D start_point = cell_graph.front().ceiling.front();
+    if(scene.center_start && !DetermineCellIndex(flat_cell_graph, Point2D(map.cols/2, map.rows/2)).empty())
+    {
+        start_point = Point2D(map.cols/2, map.rows/2);
+    }
+
+    // 规划会修改cell graph的状态, 游程版本使用一份副本
+    std::vector<CellNode> segment_cell_graph = cell_graph;
+
+    start = BenchClock::now();
+    std::deque<std::deque<Point2D>> original_planning_path = StaticPathPlanning(cell_graph, start_point, scene.robot_radius);
+    size_t raw_point_num = 0;
+    for(const auto& sub_path : original_planning_path)
+    {
+        raw_point_num += sub_path.size();
+    }
+    RecordStage(records, scene, "StaticPathPlanning", run, ElapsedMilliseconds(start), raw_point_num);
+
+    start = BenchClock::now();
+    std::deque<Point2D> path = FilterTrajectory(original_planning_path);
+    RecordStage(records, scene, "FilterTrajectory", run, ElapsedMilliseconds(start), path.size());
+
+    Eigen::Vector2d curr_direction = {0, -1};
+    start = BenchClock::now();
+    std::vector<NavigationMessage> messages = GetNavigationMessage(curr_direction, path, 0.02);
+    RecordStage(records, scene, "GetNavigationMessage", run, ElapsedMilliseconds(start), messages.size());
+
+    // 游程表示的路径, items为段数
+    start = BenchClock::now();
+    std::deque<SegmentPath> original_segment_path = StaticSegmentPathPlanning(segment_cell_graph, start_point, scene.robot_radius);
+    size_t raw_segment_num = 0;
+    for(const auto& sub_path : original_segment_path)
+    {
+        raw_segment_num += sub_path.GetSegments().size();
+    }
+    RecordStage(records, scene, "StaticSegmentPathPlanning", run, ElapsedMilliseconds(start), raw_segment_num);
+
+    start = BenchClock::now();
+    SegmentPath segment_path = FilterTrajectory(original_segment_path);
+    RecordStage(records, scene, "FilterTrajectory(SegmentPath)", run, ElapsedMilliseconds(start), segment_path.GetSegments().size());
+
+    start = BenchClock::now();
+    std::vector<NavigationMessage> segment_messages = GetNavigationMessage(curr_direction, segment_path, 0.02);
+    RecordStage(records, scene, "GetNavigationMessage(SegmentPath)", run, ElapsedMilliseconds(start), segment_messages.size());
+
+    // 优化访问顺序后的路径, items为去重后的路径点数, 与FilterTrajectory的items比较即为空驶的减少量
+    CellGraph sequenced_cell_graph = flat_cell_graph;
+    start = BenchClock::now();
+    std::deque<std::deque<Point2D>> sequenced_planning_path = StaticPathPlanning(sequenced_cell_graph, start_point, scene.robot_radius, true);
+    double sequenced_milliseconds = ElapsedMilliseconds(start);
+    RecordStage(records, scene, "StaticPathPlanning(sequenced)", run, sequenced_milliseconds, FilterTrajectory(sequenced_planning_path).size());
+
+    // 各cell的往返路径并行生成, items与StaticPathPlanning相同
+    CellGraph parallel_cell_graph = flat_cell_graph;
+    start = BenchClock::now();
+    std::deque<std::deque<Point2D>> parallel_planning_path = StaticPathPlanning(parallel_cell_graph, start_point, scene.robot_radius, false, true);
+    double parallel_milliseconds = ElapsedMilliseconds(start);
+    size_t parallel_point_num = 0;
+    for(const auto& sub_path : parallel_planning_path)
+    {
+        parallel_point_num += sub_path.size();
+    }
+    RecordStage(records, scene, "StaticPathPlanning(parallel sweeps)", run, parallel_milliseconds, parallel_point_num);
+
+    // 往返路径缓存预热一遍后再规划, 各cell的往返路径都从缓存取得, items与StaticPathPlanning相同
+    CellGraph sweep_cached_cell_graph = flat_cell_graph;
+    sweep_cached_cell_graph.SetSweepCache(std::make_shared<SweepCache>());
+    CellGraph warming_cell_graph = sweep_cached_cell_graph;
+    StaticPathPlanning(warming_cell_graph, start_point, scene.robot_radius);
+    start = BenchClock::now();
+    std::deque<std::deque<Point2D>> sweep_cached_planning_path = StaticPathPlanning(sweep_cached_cell_graph, start_point, scene.robot_radius);
+    double sweep_cached_milliseconds = ElapsedMilliseconds(start);
+    size_t sweep_cached_point_num = 0;
+    for(const auto& sub_path : sweep_cached_planning_path)
+    {
+        sweep_cached_point_num += sub_path.size();
+    }
+    RecordStage(records, scene, "StaticPathPlanning(sweep cache)", run, sweep_cached_milliseconds, sweep_cached_point_num);
+
+    // 重复的规划请求只查缓存(含拷贝出路径), 与上面StaticPathPlanning的耗时比较, items为路径点数
+    PlanCache plan_cache;
+    PlanKey plan_key;
+    plan_key.map_digest = ComputeMapDigest(map);
+    plan_key.cell_graph_digest = ComputeCellGraphDigest(flat_cell_graph);
+    plan_key.robot_radius = scene.robot_radius;
+    plan_key.start_cell_index = DetermineCellIndex(flat_cell_graph, start_point).front();
+    std::shared_ptr<CachedPlan> cached_plan = std::make_shared<CachedPlan>();
+    cached_plan->start_point = start_point;
+    cached_plan->global_path = original_planning_path;
+    plan_cache.Insert(plan_key, cached_plan);
+    start = BenchClock::now();
+    std::shared_ptr<const CachedPlan> found_plan = plan_cache.Find(plan_key);
+    std::deque<std::deque<Point2D>> cached_planning_path = found_plan->global_path;
+    RecordStage(records, scene, "PlanCache::Find", run, ElapsedMilliseconds(start), raw_point_num);
+
+    return true;
+}
+
+bool WriteRecords(const std::string& output_path, const std::vector<StageRecord>& records)
+{
+    std::ofstream output(output_path);
+    if(!output.is_open())
+    {
+        return false;
+    }
+
+    output<<"scene,width,height,obstacles,robot_radius,stage,run,milliseconds,items"<<std::endl;
+    for(const auto& record : records)
+    {
+        output<<record.scene<<","<<record.width<<","<<record.height<<","<<record.obstacle_num<<","<<record.robot_radius<<","
+              <<record.stage<<","<<record.run<<","<<record.milliseconds<<","<<record.items<<std::endl;
+    }
+    return true;
+}
+
+// 原来的膨胀方法: 在三通道画布上给每个轮廓点画一个半径为robot_radius的实心圆, 只作为比较的基准
+cv::Mat1b InflateObstaclesWithCircles(const cv::Mat& original_map, const std::vector<std::vector<cv::Point>>& wall_contours, const std::vector<std::vector<cv::Point>>& obstacle_contours, int robot_radius)
+{
+    cv::Mat3b canvas = cv::Mat3b(original_map.size(), CV_8U);
+    canvas.setTo(cv::Scalar(255, 255, 255));
+
+    cv::fillPoly(canvas, wall_contours, cv::Scalar(0, 0, 0));
+    for(const auto& point:wall_contours.front())
+    {
+        cv::circle(canvas, point, robot_radius, cv::Scalar(255, 255, 255), -1);
+    }
+
+    cv::fillPoly(canvas, obstacle_contours, cv::Scalar(255, 255, 255));
+    for(const auto& obstacle_contour:obstacle_contours)
+    {
+        for(const auto& point:obstacle_contour)
+        {
+            cv::circle(canvas, point, robot_radius, cv::Scalar(255, 255, 255), -1);
+        }
+    }
+
+    cv::Mat canvas_;
+    cv::cvtColor(canvas, canvas_, cv::COLOR_BGR2GRAY);
+    cv::threshold(canvas_, canvas_, 200, 255, cv::THRESH_BINARY_INV);
+    return canvas_;
+}
+
+// 两种膨胀结果不同的像素都在另一方的边界1像素之内: 每一方3x3膨胀后包含另一方, 3x3腐蚀后被另一方包含
+bool IsWithinOnePixel(const cv::Mat1b& free_space, const cv::Mat1b& other_free_space)
+{
+    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
+    cv::Mat1b dilated, eroded, other_dilated, other_eroded;
+    cv::dilate(free_space, dilated, kernel);
+    cv::erode(free_space, eroded, kernel);
+    cv::dilate(other_free_space, other_dilated, kernel);
+    cv::erode(other_free_space, other_eroded, kernel);
+
+    // 二值图上a > b的像素即a中有而b中没有的像素
+    return cv::countNonZero(other_free_space > dilated) == 0 && cv::countNonZero(eroded > other_free_space) == 0
+        && cv::countNonZero(free_space > other_dilated) == 0 && cv::countNonZero(other_eroded > free_space) == 0;
+}
+
+// 半径1..max_radius逐个比较, 记录中的robot_radius为膨胀半径, items为两种方法结果不同的像素数
+// 每个半径输出不同的像素是否都在1像素之内(IsWithinOnePixel), 有半径不满足时返回false
+bool BenchmarkInflation(const BenchScene& scene, int max_radius, int repeats, std::vector<StageRecord>& records)
+{
+    std::vector<std::vector<cv::Point>> wall_contours;
+    std::vector<std::vector<cv::Point>> obstacle_contours;
+    ExtractRawContours(scene.map, wall_contours, obstacle_contours);
+    if(wall_contours.empty())
+    {
+        return true;
+    }
+
+    bool all_within = true;
+    BenchScene radius_scene = scene;
+    for(int radius = 1; radius <= max_radius; radius++)
+    {
+        radius_scene.robot_radius = radius;
+        for(int run = 0; run < repeats; run++)
+        {
+            BenchClock::time_point start = BenchClock::now();
+            cv::Mat1b circle_free_space = InflateObstaclesWithCircles(scene.map, wall_contours, obstacle_contours, radius);
+            double circle_milliseconds = ElapsedMilliseconds(start);
+
+            start = BenchClock::now();
+            cv::Mat1f distance_field = ComputeObstacleDistanceField(scene.map, wall_contours, obstacle_contours);
+            double distance_milliseconds = ElapsedMilliseconds(start);
+
+            start = BenchClock::now();
+            cv::Mat1b free_space = InflateObstacles(distance_field, radius);
+            double threshold_milliseconds = ElapsedMilliseconds(start);
+
+            size_t different_pixels = size_t(cv::countNonZero(circle_free_space != free_space));
+            RecordStage(records, radius_scene, "InflateObstacles(circles)", run, circle_milliseconds, different_pixels);
+            RecordStage(records, radius_scene, "ComputeObstacleDistanceField", run, distance_milliseconds, different_pixels);
+            RecordStage(records, radius_scene, "InflateObstacles", run, threshold_milliseconds, different_pixels);
+
+            if(run == 0)
+            {
+                bool within = IsWithinOnePixel(circle_free_space, free_space);
+                std::cout<<scene.name<<" radius "<<radius<<" inflation within 1 px of circles: "<<(within ? "pass" : "FAIL")<<std::endl;
+                all_within = all_within && within;
+            }
+        }
+    }
+    return all_within;
+}
+
+// 一次完整规划(提取轮廓到运动指令)及其中各规划环节的堆分配次数, items为分配次数; 需要以BCD_ENABLE_PROFILING编译, 否则恒为0
+void BenchmarkPlanAllocations(const BenchScene& scene, int repeats, std::vector<StageRecord>& records)
+{
+    if(!Profiler::IsEnabled())
+    {
+        std::cerr<<"allocation counts of "<<scene.name<<" are 0: build with BCD_ENABLE_PROFILING"<<std::endl;
+    }
+
+    const cv::Mat1b& map = scene.map;
+    Eigen::Vector2d curr_direction = {0, -1};
+
+    for(int run = 0; run < repeats; run++)
+    {
+        long long allocations = AllocationCount();
+        BenchClock::time_point start = BenchClock::now();
+
+        std::vector<std::vector<cv::Point>> wall_contours;
+        std::vector<std::vector<cv::Point>> obstacle_contours;
+        ExtractContours(map, wall_contours, obstacle_contours, scene.inflation_radius);
+        if(wall_contours.empty())
+        {
+            return;
+        }
+        Polygon wall = ConstructWall(map, wall_contours.front());
+        PolygonList obstacles = ConstructObstacles(map, obstacle_contours);
+        std::vector<CellNode> cell_graph = ConstructCellGraph(map, wall_contours, obstacle_contours, wall, obstacles);
+        if(cell_graph.empty() || cell_graph.front().ceiling.empty())
+        {
+            return;
+        }
+        CellGraph flat_cell_graph(cell_graph);
+        Point2D start_point = cell_graph.front().ceiling.front();
+        CellGraph working_cell_graph = flat_cell_graph;
+        std::vector<NavigationMessage> full_plan_messages = StaticNavigationPlanning(working_cell_graph, start_point, scene.robot_radius, curr_direction, 0.02);
+        RecordStage(records, scene, "FullPlan(allocations)", run, ElapsedMilliseconds(start), size_t(AllocationCount()-allocations));
+
+        // 以下各环节都在cell graph的副本上规划, 副本的拷贝不计入
+        working_cell_graph = flat_cell_graph;
+        allocations = AllocationCount();
+        start = BenchClock::now();
+        std::deque<std::deque<Point2D>> global_path = StaticPathPlanning(working_cell_graph, start_point, scene.robot_radius);
+        RecordStage(records, scene, "StaticPathPlanning(allocations)", run, ElapsedMilliseconds(start), size_t(AllocationCount()-allocations));
+
+        // 子路径交给sink只计数, 不保存路径
+        working_cell_graph = flat_cell_graph;
+        size_t point_num = 0;
+        SubPathSink sub_path_sink = [&point_num](const PathView& sub_path)
+        {
+            point_num += sub_path.size();
+        };
+        allocations = AllocationCount();
+        start = BenchClock::now();
+        StaticPathPlanning(working_cell_graph, start_point, scene.robot_radius, false, false, sub_path_sink);
+        RecordStage(records, scene, "StaticPathPlanning(sink, allocations)", run, ElapsedMilliseconds(start), size_t(AllocationCount()-allocations));
+
+        allocations = AllocationCount();
+        start = BenchClock::now();
+        std::vector<NavigationMessage> messages = GetNavigationMessage(curr_direction, FilterTrajectory(global_path), 0.02);
+        RecordStage(records, scene, "GetNavigationMessage(FilterTrajectory, allocations)", run, ElapsedMilliseconds(start), size_t(AllocationCount()-allocations));
+
+        working_cell_graph = flat_cell_graph;
+        allocations = AllocationCount();
+        start = BenchClock::now();
+        std::vector<NavigationMessage> streamed_messages = StaticNavigationPlanning(working_cell_graph, start_point, scene.robot_radius, curr_direction, 0.02);
+        RecordStage(records, scene, "StaticNavigationPlanning(allocations)", run, ElapsedMilliseconds(start), size_t(AllocationCount()-allocations));
+
+        // 从覆盖路径的终点返回起点
+        allocations = AllocationCount();
+        start = BenchClock::now();
+        std::deque<Point2D> returning_path = ReturningPathPlanning(working_cell_graph, global_path.back().back(), start_point, scene.robot_radius);
+        RecordStage(records, scene, "ReturningPathPlanning(allocations)", run, ElapsedMilliseconds(start), size_t(AllocationCount()-allocations));
+    }
+}
+
+void BenchmarkScene(const BenchScene& scene, const BenchOptions& options, std::vector<StageRecord>& records)
+{
+    for(int run = 0; run < options.repeats; run++)
+    {
+        Profiler profiler;
+        bool succeeded;
+        {
+            ProfileSession session((run == 0 && !options.profile_dir.empty()) ? &profiler : nullptr);
+            succeeded = RunScene(scene, run, records);
+        }
+
+        if(!succeeded)
+        {
+            std::cerr<<"scene "<<scene.name<<" failed to decompose, skipped"<<std::endl;
+            return;
+        }
+
+        if(run == 0 && !options.profile_dir.empty() && !profiler.WriteJson(options.profile_dir + "/" + scene.name + ".json"))
+        {
+            std::cerr<<"cannot write profile of "<<scene.name<<" to "<<options.profile_dir<<std::endl;
+        }
+    }
+}
+
+
+/** 事件分类的回归检查: 在内置地图, 手工地图与固定种子的合成地图上生成事件, 分解并规划, 与检入的期望输出逐行比较 **/
+/** 期望输出由查表分类之前的实现生成, 每个场景记录地图摘要, 两类事件的数量与摘要, 各类型的事件数, cell数与路径摘要, **/
+/** 以及顶点级分解的cell数, 事件数与面积, 分条带扫描的cell摘要, 并行生成的覆盖路径与覆盖完成后的返回路径 **/
+
+void MixDigest(uint64_t& digest, int value)
+{
+    for(int i = 0; i < 4; i++)
+    {
+        digest ^= uint8_t(uint32_t(value) >> (8*i));
+        digest *= 1099511628211ULL;
+    }
+}
+
+std::string FormatDigest(uint64_t digest)
+{
+    std::ostringstream text;
+    text<<std::hex<<digest;
+    return text.str();
+}
+
+std::string DescribeEvents(const std::string& label, const std::vector<Event>& event_list)
+{
+    uint64_t digest = 14695981039346656037ULL;
+    for(const auto& event : event_list)
+    {
+        MixDigest(digest, event.x);
+        MixDigest(digest, event.y);
+        MixDigest(digest, event.obstacle_index);
+        MixDigest(digest, int(event.event_type));
+    }
+    return label + " " + std::to_string(event_list.size()) + " " + FormatDigest(digest);
+}
+
+// 内置地图读取失败时返回空
+std::vector<BenchScene> ConstructCheckScenes(const std::string& map_dir)
+{
+    std::vector<BenchScene> scenes;
+
+    BenchScene scene;
+    scene.robot_radius = 5;
+    scene.inflation_radius = 0;
+    scene.obstacle_num = -1;
+    scene.center_start = false;
+
+    // 内置地图与ConstructBundledScenes的参数相同, map按StaticPathPlanningExample1膨胀
+    scene.name = "map";
+    scene.map = ReadMap(map_dir + "/map.png");
+    scene.robot_radius = ComputeRobotRadius(0.02, 0.15);
+    scene.inflation_radius = scene.robot_radius;
+    if(scene.map.empty())
+    {
+        std::cerr<<"cannot read "<<map_dir<<"/map.png, set --map-dir to the source directory"<<std::endl;
+        return {};
+    }
+    scene.map = PreprocessMap(scene.map);
+    scenes.emplace_back(scene);
+
+    scene.name = "complicate_map";
+    scene.map = ReadMap(map_dir + "/complicate_map.png");
+    scene.robot_radius = 5;
+    scene.inflation_radius = 0;
+    if(scene.map.empty())
+    {
+        std::cerr<<"cannot read "<<map_dir<<"/complicate_map.png, set --map-dir to the source directory"<<std::endl;
+        return {};
+    }
+    scene.map = PreprocessMap(scene.map);
+    scenes.emplace_back(scene);
+
+    for(int i = 1; i <= 5; i++)
+    {
+        scene.name = "handcrafted_" + std::to_string(i);
+        scene.map = ConstructHandcraftedMap(i);
+        scenes.emplace_back(scene);
+    }
+
+    // 合成地图由std::mt19937与标准库的分布生成, 换用其它标准库时地图本身可能不同, 由map一行区分
+    for(int size : {500, 1000})
+    {
+        for(int obstacle_num : {1, 10, 100})
+        {
+            scene.name = "synthetic_" + std::to_string(size) + "_" + std::to_string(obstacle_num);
+            scene.map = GenerateSyntheticMap(size, obstacle_num, 0);
+            scene.obstacle_num = obstacle_num;
+            scenes.emplace_back(scene);
+        }
+    }
+
+    return scenes;
+}
+
+uint64_t DigestPoints(const std::deque<Point2D>& points)
+{
+    uint64_t digest = 14695981039346656037ULL;
+    for(const auto& point : points)
+    {
+        MixDigest(digest, point.x);
+        MixDigest(digest, point.y);
+    }
+    return digest;
+}
+
+// 与path一行相同: 混入各子路径的点数与各点
+uint64_t DigestSubPaths(const std::deque<std::deque<Point2D>>& path)
+{
+    uint64_t digest = 14695981039346656037ULL;
+    for(const auto& sub_path : path)
+    {
+        MixDigest(digest, int(sub_path.size()));
+        for(const auto& point : sub_path)
+        {
+            MixDigest(digest, point.x);
+            MixDigest(digest, point.y);
+        }
+    }
+    return digest;
+}
+
+// 各cell覆盖的空闲像素数; 相邻cell在事件列上会重叠, 重叠的像素只计一次
+// 竖直的边界上一列有多个ceiling或floor点, 每列取最高的ceiling到最低的floor; 事件列会跨过障碍物, 障碍物上的像素不计
+long long ComputeCoveredArea(const std::vector<CellNode>& cell_graph, const cv::Mat1b& map)
+{
+    cv::Mat1b covered(map.size(), uchar(0));
+    std::vector<int> top_y(map.cols);
+    std::vector<int> bottom_y(map.cols);
+    for(const auto& cell : cell_graph)
+    {
+        std::fill(top_y.begin(), top_y.end(), INT_MAX);
+        std::fill(bottom_y.begin(), bottom_y.end(), INT_MIN);
+        for(const auto& point : cell.ceiling)
+        {
+            top_y[point.x] = std::min(top_y[point.x], point.y);
+        }
+        for(const auto& point : cell.floor)
+        {
+            bottom_y[point.x] = std::max(bottom_y[point.x], point.y);
+        }
+        for(int x = 0; x < map.cols; x++)
+        {
+            for(int y = std::max(top_y[x], 0); y <= std::min(bottom_y[x], map.rows-1); y++)
+            {
+                if(map(y, x) > 0)
+                {
+                    covered(y, x) = 255;
+                }
+            }
+        }
+    }
+    return cv::countNonZero(covered);
+}
+
+// 按顺序混入各cell的编号, ceiling与floor的点和邻居的顺序
+uint64_t DigestCells(const std::vector<CellNode>& cell_graph)
+{
+    uint64_t digest = 14695981039346656037ULL;
+    for(const auto& cell : cell_graph)
+    {
+        MixDigest(digest, cell.cellIndex);
+        MixDigest(digest, int(cell.ceiling.size()));
+        for(int i = 0; i < int(cell.ceiling.size()); i++)
+        {
+            MixDigest(digest, cell.ceiling[i].x);
+            MixDigest(digest, cell.ceiling[i].y);
+            MixDigest(digest, cell.floor[i].x);
+            MixDigest(digest, cell.floor[i].y);
+        }
+        MixDigest(digest, int(cell.neighbor_indices.size()));
+        for(int neighbor_index : cell.neighbor_indices)
+        {
+            MixDigest(digest, neighbor_index);
+        }
+    }
+    return digest;
+}
+
+std::string FormatJsonPath(const std::deque<Point2D>& path)
+{
+    std::ostringstream text;
+    text<<"\"path\":[";
+    for(size_t i = 0; i < path.size(); i++)
+    {
+        text<<(i > 0 ? ",[" : "[")<<path[i].x<<","<<path[i].y<<"]";
+    }
+    text<<"]";
+    return text.str();
+}
+
+// 经PlannerService按请求行加载地图并请求plan_return, 返回回复中的"path"字段, 失败时返回空
+std::string DaemonReturnPath(const BenchScene& scene, const Point2D& curr_pos, const Point2D& original_pos)
+{
+    std::string map_path = scene.name + ".check.pgm";
+    if(!cv::imwrite(map_path, scene.map))
+    {
+        return "";
+    }
+
+    PlannerService service;
+    std::string reply_line;
+    auto reply = [&reply_line](const std::string& line){ reply_line = line; };
+    bool stop_requested = false;
+    service.Dispatch("{\"id\":1,\"op\":\"load_map\",\"map\":\"check\",\"path\":\"" + map_path + "\",\"radius\":" + std::to_string(scene.inflation_radius) + "}", reply, stop_requested);
+    std::remove(map_path.c_str());
+
+    std::function<void()> task = service.Dispatch("{\"id\":2,\"op\":\"plan_return\",\"map\":\"check\",\"x\":" + std::to_string(curr_pos.x) + ",\"y\":" + std::to_string(curr_pos.y)
+                                                  + ",\"home_x\":" + std::to_string(original_pos.x) + ",\"home_y\":" + std::to_string(original_pos.y) + "}", reply, stop_requested);
+    if(!task)
+    {
+        return "";
+    }
+    task();
+
+    size_t path_begin = reply_line.find("\"path\":");
+    if(path_begin == std::string::npos)
+    {
+        return "";
+    }
+    size_t path_end = reply_line.find("]]", path_begin);
+    return path_end == std::string::npos ? "" : reply_line.substr(path_begin, path_end+2-path_begin);
+}
+
+// 覆盖完成后从路径终点返回起点: Planner::PlanReturning须与在全部标记为已清扫的cell graph上的ReturningPathPlanning相同,
+// 且途经的cell只经过角点, 路径长度(逐点的切比雪夫距离之和)不超过途经各cell外接矩形的周长之和, 否则记为long;
+// 常驻服务的plan_return回复的路径也须与之相同
+void DescribeReturning(const BenchScene& scene, const std::vector<CellNode>& cell_graph, const Point2D& curr_pos, const Point2D& original_pos, std::vector<std::string>& lines)
+{
+    CellGraph cleaned_graph(cell_graph);
+    for(int i = 0; i < cleaned_graph.Size(); i++)
+    {
+        cleaned_graph.SetCleaned(i, true);
+    }
+    std::deque<Point2D> returning_path = ReturningPathPlanning(cleaned_graph, curr_pos, original_pos, 0);
+
+    long long bound = 0;
+    std::deque<int> cell_path = FindShortestPath(cleaned_graph, curr_pos, original_pos);
+    for(int cell_index : cell_path)
+    {
+        CellEdgeView ceiling = cleaned_graph.Ceiling(cell_index);
+        CellEdgeView floor = cleaned_graph.Floor(cell_index);
+        int top = ceiling[0].y, bottom = floor[0].y;
+        for(int i = 1; i < ceiling.size(); i++)
+        {
+            top = std::min(top, ceiling[i].y);
+            bottom = std::max(bottom, floor[i].y);
+        }
+        bound += 2*(cleaned_graph.Width(cell_index) + bottom - top);
+    }
+    long long length = 0;
+    for(size_t i = 1; i < returning_path.size(); i++)
+    {
+        length += std::max(std::abs(returning_path[i].x-returning_path[i-1].x), std::abs(returning_path[i].y-returning_path[i-1].y));
+    }
+
+    // 轮廓不膨胀时Planner的分解与上面的cell graph相同
+    Planner planner;
+    planner.SetMap(scene.map);
+    planner.SetRobotRadius(scene.inflation_radius);
+    std::deque<Point2D> planner_path;
+    if(planner.Decompose())
+    {
+        planner_path = planner.PlanReturning(curr_pos, original_pos);
+    }
+
+    lines.emplace_back("returning " + std::to_string(cell_path.size()) + " " + std::to_string(returning_path.size()) + " " + FormatDigest(DigestPoints(returning_path))
+                       + (length <= bound ? " short" : " long") + (planner_path == returning_path ? " planner_same" : " planner_differs")
+                       + (DaemonReturnPath(scene, curr_pos, original_pos) == FormatJsonPath(returning_path) ? " daemon_same" : " daemon_differs"));
+}
+
+void DescribeCheckScene(const BenchScene& scene, std::vector<std::string>& lines)
+{
+    const cv::Mat1b& map = scene.map;
+    lines.emplace_back("scene " + scene.name);
+    lines.emplace_back("map " + std::to_string(map.cols) + "x" + std::to_string(map.rows) + " " + FormatDigest(ComputeMapDigest(map)));
+
+    std::vector<std::vector<cv::Point>> wall_contours;
+    std::vector<std::vector<cv::Point>> obstacle_contours;
+    ExtractContours(map, wall_contours, obstacle_contours, scene.inflation_radius);
+    if(wall_contours.empty())
+    {
+        lines.emplace_back("no contours");
+        return;
+    }
+
+    Polygon wall = ConstructWall(map, wall_contours.front());
+    PolygonList obstacles = ConstructObstacles(map, obstacle_contours);
+    cv::Mat3b free_space_map = ConstructFreeSpaceMap(map, wall_contours, obstacle_contours);
+    std::vector<Event> wall_event_list = GenerateWallEventList(free_space_map, wall);
+    std::vector<Event> obstacle_event_list = GenerateObstacleEventList(free_space_map, obstacles);
+    lines.emplace_back(DescribeEvents("wall_events", wall_event_list));
+    lines.emplace_back(DescribeEvents("obstacle_events", obstacle_event_list));
+
+    std::vector<size_t> type_counts(UNALLOCATED+1, 0);
+    for(const auto* event_list : {&wall_event_list, &obstacle_event_list})
+    {
+        for(const auto& event : *event_list)
+        {
+            type_counts[event.event_type]++;
+        }
+    }
+    std::string type_line = "event_types";
+    for(size_t i = 0; i < type_counts.size(); i++)
+    {
+        if(type_counts[i] > 0)
+        {
+            type_line += " " + std::to_string(i) + ":" + std::to_string(type_counts[i]);
+        }
+    }
+    lines.emplace_back(type_line);
+
+    SliceList slice_list = SliceListGenerator(wall_event_list, obstacle_event_list);
+    std::vector<CellNode> cell_graph;
+    std::vector<int> cell_index_slice;
+    std::vector<int> original_cell_index_slice;
+    ExecuteCellDecomposition(cell_graph, cell_index_slice, original_cell_index_slice, slice_list);
+    lines.emplace_back("cells " + std::to_string(cell_graph.size()));
+    if(cell_graph.empty() || cell_graph.front().ceiling.empty())
+    {
+        return;
+    }
+
+    // 顶点级分解: cell数须与逐像素分解相同, 极值事件少于逐像素的事件, 覆盖的空闲面积相差不超过1%
+    std::vector<Event> critical_wall_events;
+    std::vector<Event> critical_obstacle_events;
+    std::vector<CellNode> vertex_cell_graph = ConstructCellGraphFromVertices(map, wall_contours, obstacle_contours, critical_wall_events, critical_obstacle_events);
+    size_t critical_event_num = critical_wall_events.size() + critical_obstacle_events.size();
+    long long pixel_area = ComputeCoveredArea(cell_graph, map);
+    long long vertex_area = ComputeCoveredArea(vertex_cell_graph, map);
+    lines.emplace_back("vertex cells " + std::to_string(vertex_cell_graph.size()) + (vertex_cell_graph.size() == cell_graph.size() ? " same" : " differs")
+                       + " events " + std::to_string(critical_event_num) + (critical_event_num < wall_event_list.size()+obstacle_event_list.size() ? " fewer" : " not_fewer")
+                       + " area " + std::to_string(vertex_area) + " " + std::to_string(pixel_area)
+                       + (std::abs(vertex_area-pixel_area)*100 <= pixel_area ? " within_1%" : " outside_1%"));
+
+    // 分条带并行扫描并在接缝处拼接, 须与单线程扫描的cell, 点与邻居顺序完全相同
+    uint64_t cells_digest = DigestCells(cell_graph);
+    for(int stripe_num : {2, 4, 16})
+    {
+        std::vector<CellNode> striped_cell_graph;
+        ExecuteStripedCellDecomposition(striped_cell_graph, slice_list, stripe_num);
+        uint64_t striped_digest = DigestCells(striped_cell_graph);
+        lines.emplace_back("stripes " + std::to_string(stripe_num) + " " + std::to_string(striped_cell_graph.size()) + " " + FormatDigest(striped_digest)
+                           + (striped_digest == cells_digest ? " same" : " differs"));
+    }
+
+    Point2D start_point = cell_graph.front().ceiling.front();
+    std::deque<std::deque<Point2D>> path = StaticPathPlanning(cell_graph, start_point, scene.robot_radius);
+    size_t point_num = 0;
+    for(const auto& sub_path : path)
+    {
+        point_num += sub_path.size();
+    }
+    lines.emplace_back("path " + std::to_string(path.size()) + " " + std::to_string(point_num) + " " + FormatDigest(DigestSubPaths(path)));
+
+    // 并行生成往返路径须与逐个生成的路径逐点相同(分别在按深度优先与按SequenceCells的访问顺序下), 且不能靠退回逐个生成得到
+    CellGraph flat_cell_graph(cell_graph);
+    flat_cell_graph.ResetStates();
+    for(bool sequence_cells : {false, true})
+    {
+        CellGraph serial_graph = flat_cell_graph;
+        uint64_t serial_digest = DigestSubPaths(StaticPathPlanning(serial_graph, start_point, scene.robot_radius, sequence_cells, false));
+        CellGraph parallel_graph = flat_cell_graph;
+        long long fallbacks = ParallelSweepFallbackCount();
+        std::deque<std::deque<Point2D>> parallel_path = StaticPathPlanning(parallel_graph, start_point, scene.robot_radius, sequence_cells, true);
+        fallbacks = ParallelSweepFallbackCount() - fallbacks;
+        uint64_t parallel_digest = DigestSubPaths(parallel_path);
+        lines.emplace_back(std::string(sequence_cells ? "parallel_sequenced_path " : "parallel_path ") + std::to_string(parallel_path.size()) + " " + FormatDigest(parallel_digest)
+                           + (parallel_digest == serial_digest ? " same" : " differs") + " fallbacks " + std::to_string(fallbacks));
+    }
+
+    DescribeReturning(scene, cell_graph, path.back().back(), start_point, lines);
+}
+
+// write_expected为true时重新生成期望输出, 否则与之比较, 不一致的行输出到std::cerr
+bool RunEventCheck(const std::string& expected_path, const std::string& map_dir, bool write_expected)
+{
+    std::vector<BenchScene> scenes = ConstructCheckScenes(map_dir);
+    if(scenes.empty())
+    {
+        return false;
+    }
+
+    std::vector<std::string> lines;
+    for(const auto& scene : scenes)
+    {
+        DescribeCheckScene(scene, lines);
+    }
+
+    if(write_expected)
+    {
+        std::ofstream output(expected_path);
+        if(!output.is_open())
+        {
+            std::cerr<<"cannot write "<<expected_path<<std::endl;
+            return false;
+        }
+        output<<"# bcd_bench --check-events: event lists, event type counts, cell counts, vertex and striped decompositions, serial and parallel coverage paths and returning paths of the check scenes"<<std::endl;
+        output<<"# regenerate with bcd_bench --write-events only when a change is meant to alter them"<<std::endl;
+        for(const auto& line : lines)
+        {
+            output<<line<<std::endl;
+        }
+        std::cout<<lines.size()<<" lines written to "<<expected_path<<std::endl;
+        return true;
+    }
+
+    std::ifstream input(expected_path);
+    if(!input.is_open())
+    {
+        std::cerr<<"cannot read "<<expected_path<<std::endl;
+        return false;
+    }
+    std::vector<std::string> expected_lines;
+    std::string line;
+    while(std::getline(input, line))
+    {
+        if(!line.empty() && line[0] != '#')
+        {
+            expected_lines.emplace_back(line);
+        }
+    }
+
+    int mismatch_num = 0;
+    std::string scene_name;
+    for(size_t i = 0; i < std::max(lines.size(), expected_lines.size()); i++)
+    {
+        const std::string& actual = i < lines.size() ? lines[i] : std::string();
+        const std::string& expected = i < expected_lines.size() ? expected_lines[i] : std::string();
+        if(actual.compare(0, 6, "scene ") == 0)
+        {
+            scene_name = actual.substr(6);
+        }
+        if(actual != expected)
+        {
+            std::cerr<<scene_name<<": expected \""<<expected<<"\", got \""<<actual<<"\""<<std::endl;
+            mismatch_num++;
+        }
+    }
+
+    std::cout<<(mismatch_num == 0 ? "event check passed" : "event check FAILED")<<" ("<<lines.size()<<" lines, "<<mismatch_num<<" mismatched)"<<std::endl;
+    return mismatch_num == 0;
+}
+
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    if(!ParseOptions(argc, argv, options))
+    {
+        return 1;
+    }
+
+    if(!options.event_check_path.empty())
+    {
+        return RunEventCheck(options.event_check_path, options.map_dir, options.write_events) ? 0 : 1;
+    }
+
+    std::vector<StageRecord> records;
+    bool inflation_within = true;
+
+    if(options.run_bundled)
+    {
+        std::vector<BenchScene> scenes = ConstructBundledScenes(options);
+        for(const auto& scene : scenes)
+        {
+            BenchmarkScene(scene, options, records);
+            if(scene.name == "complicate_map")
+            {
+                BenchmarkPlanAllocations(scene, options.repeats, records);
+            }
+        }
+        if(options.inflation_sweep > 0)
+        {
+            for(const auto& scene : scenes)
+            {
+                inflation_within = BenchmarkInflation(scene, options.inflation_sweep, options.repeats, records) && inflation_within;
+            }
+        }
+    }
+
+    if(options.run_synthetic)
+    {
+        for(const auto& size : options.sizes)
+        {
+            for(const auto& obstacle_num : options.obstacle_nums)
+            {
+                BenchScene scene;
+                scene.name = "synthetic_" + std::to_string(size) + "_" + std::to_string(obstacle_num);
+                scene.map = GenerateSyntheticMap(size, obstacle_num, options.seed);
+                scene.robot_radius = options.robot_radius;
+                scene.inflation_radius = 0;
+                scene.obstacle_num = obstacle_num;
+                scene.center_start = false;
+                if(scene.map.empty())
+                {
+                    std::cerr<<"skip "<<scene.name<<": too many obstacles for the map size"<<std::endl;
+                    continue;
+                }
+                BenchmarkScene(scene, options, records);
+            }
+        }
+    }
+
+    if(!WriteRecords(options.output_path, records))
+    {
+        std::cerr<<"cannot write "<<options.output_path<<std::endl;
+        return 1;
+    }
+    std::cout<<records.size()<<" records written to "<<options.output_path<<std::endl;
+
+    if(!inflation_within)
+    {
+        std::cerr<<"inflation check FAILED: some pixels differ from the circle inflation by more than 1 px"<<std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,515 @@
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+#if defined(_WIN32)
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "cell_graph_file.hpp"
+#include "profiler.hpp"
+
+
+namespace
+{
+
+const char cell_graph_file_magic[8] = {'B', 'C', 'D', 'G', 'R', 'A', 'P', 'H'};
+const uint32_t cell_graph_file_byte_order = 0x01020304;
+
+// 文件中各段的顺序
+const int LEFT_X_SECTION = 0;
+const int COLUMN_OFFSETS_SECTION = 1;
+const int CEILING_Y_SECTION = 2;
+const int FLOOR_Y_SECTION = 3;
+const int NEIGHBOR_OFFSETS_SECTION = 4;
+const int NEIGHBOR_LIST_SECTION = 5;
+const int INTERVAL_OFFSETS_SECTION = 6;
+const int COLUMN_INTERVALS_SECTION = 7;     // 每个区间4个int: ceiling_y, floor_y, max_floor_y, cell_index
+const int CONTOUR_OFFSETS_SECTION = 8;      // 第一条为墙, 之后为障碍物
+const int CONTOUR_POINTS_SECTION = 9;       // 每个点2个int: x, y
+const int SECTION_NUM = 10;
+
+class FileSection
+{
+public:
+    uint64_t offset;
+    uint64_t count;     // int32的个数
+};
+
+class FileHeader
+{
+public:
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t map_digest;
+    // 文件头之后所有内容的校验和, 用来发现写了一半或损坏的文件
+    uint64_t payload_digest;
+    int32_t map_cols;
+    int32_t map_rows;
+    int32_t robot_radius;
+    // 1为顶点级分解, 0为逐像素分解
+    int32_t decomposition_mode;
+    int32_t reserved;
+    int32_t cell_num;
+    int32_t min_column_x;
+    int32_t wall_contour_num;
+    FileSection sections[SECTION_NUM];
+};
+
+static_assert(sizeof(FileHeader) == 64 + 16*SECTION_NUM, "cell graph file header must not contain padding");
+
+// 按8字节一组做FNV-1a, 末尾不足8字节的部分逐字节处理
+uint64_t ComputePayloadDigest(const char* payload, size_t payload_size)
+{
+    uint64_t digest = 14695981039346656037ULL;
+    size_t i = 0;
+    for(; i+8 <= payload_size; i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, payload+i, 8);
+        digest ^= word;
+        digest *= 1099511628211ULL;
+    }
+    for(; i < payload_size; i++)
+    {
+        digest ^= uint8_t(payload[i]);
+        digest *= 1099511628211ULL;
+    }
+    return digest;
+}
+
+uint64_t AlignSectionOffset(uint64_t offset)
+{
+    return (offset + 7) / 8 * 8;
+}
+
+bool IsOffsetList(const int* offsets, size_t offset_num, size_t total)
+{
+    if(offset_num == 0 || offsets[0] != 0 || size_t(offsets[offset_num-1]) != total)
+    {
+        return false;
+    }
+    for(size_t i = 1; i < offset_num; i++)
+    {
+        if(offsets[i] < offsets[i-1])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+uint64_t ComputeMapDigest(const cv::Mat1b& map)
+{
+    uint64_t digest = 14695981039346656037ULL;
+    auto mix = [&digest](uint8_t byte)
+    {
+        digest ^= byte;
+        digest *= 1099511628211ULL;
+    };
+
+    for(int value : {map.cols, map.rows})
+    {
+        for(int i = 0; i < 4; i++)
+        {
+            mix(uint8_t(uint32_t(value) >> (8*i)));
+        }
+    }
+    for(int y = 0; y < map.rows; y++)
+    {
+        const uchar* row = map.ptr(y);
+        for(int x = 0; x < map.cols; x++)
+        {
+            mix(row[x]);
+        }
+    }
+
+    return digest;
+}
+
+uint64_t ComputeCellGraphDigest(const CellGraph& cell_graph)
+{
+    uint64_t digest = 14695981039346656037ULL;
+    auto mix = [&digest](int value)
+    {
+        for(int i = 0; i < 4; i++)
+        {
+            digest ^= uint8_t(uint32_t(value) >> (8*i));
+            digest *= 1099511628211ULL;
+        }
+    };
+
+    mix(cell_graph.Size());
+    for(int i = 0; i < cell_graph.Size(); i++)
+    {
+        mix(cell_graph.Left(i));
+        mix(cell_graph.Width(i));
+        CellEdgeView ceiling = cell_graph.Ceiling(i);
+        CellEdgeView floor = cell_graph.Floor(i);
+        for(int j = 0; j < ceiling.size(); j++)
+        {
+            mix(ceiling[j].y);
+            mix(floor[j].y);
+        }
+        mix(cell_graph.NeighborCount(i));
+        for(int j = 0; j < cell_graph.NeighborCount(i); j++)
+        {
+            mix(cell_graph.Neighbor(i, j));
+        }
+    }
+
+    return digest;
+}
+
+CellGraphFile::CellGraphFile()
+{
+    data = nullptr;
+    size = 0;
+    min_column_x = 0;
+    wall_contour_num = 0;
+}
+
+CellGraphFile::~CellGraphFile()
+{
+    Close();
+}
+
+bool CellGraphFile::Write(const std::string& file_path, const cv::Mat1b& map, int robot_radius, bool vertex_decomposition, const CellGraph& cell_graph,
+                          const std::vector<std::vector<cv::Point>>& wall_contours, const std::vector<std::vector<cv::Point>>& obstacle_contours)
+{
+    BCD_PROFILE_SCOPE("CellGraphFile::Write");
+
+    static_assert(sizeof(CellGraph::ColumnInterval) == 4*sizeof(int32_t), "column interval must be four packed ints");
+
+    std::vector<int> contour_offsets = {0};
+    std::vector<int> contour_points;
+    for(const auto* contours : {&wall_contours, &obstacle_contours})
+    {
+        for(const auto& contour : *contours)
+        {
+            for(const auto& point : contour)
+            {
+                contour_points.emplace_back(point.x);
+                contour_points.emplace_back(point.y);
+            }
+            contour_offsets.emplace_back(int(contour_points.size()/2));
+        }
+    }
+
+    const int* section_data[SECTION_NUM] = {
+        cell_graph.left_x.data(), cell_graph.column_offsets.data(), cell_graph.ceiling_y.data(), cell_graph.floor_y.data(),
+        cell_graph.neighbor_offsets.data(), cell_graph.neighbor_list.data(),
+        cell_graph.interval_offsets.data(), reinterpret_cast<const int*>(cell_graph.column_intervals.data()),
+        contour_offsets.data(), contour_points.data()};
+    size_t section_counts[SECTION_NUM] = {
+        cell_graph.left_x.size(), cell_graph.column_offsets.size(), cell_graph.ceiling_y.size(), cell_graph.floor_y.size(),
+        cell_graph.neighbor_offsets.size(), cell_graph.neighbor_list.size(),
+        cell_graph.interval_offsets.size(), cell_graph.column_intervals.size()*4,
+        contour_offsets.size(), contour_points.size()};
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, cell_graph_file_magic, sizeof(header.magic));
+    header.version = cell_graph_file_version;
+    header.byte_order = cell_graph_file_byte_order;
+    header.map_digest = ComputeMapDigest(map);
+    header.map_cols = map.cols;
+    header.map_rows = map.rows;
+    header.robot_radius = robot_radius;
+    header.decomposition_mode = vertex_decomposition ? 1 : 0;
+    header.cell_num = cell_graph.Size();
+    header.min_column_x = cell_graph.min_column_x;
+    header.wall_contour_num = int(wall_contours.size());
+
+    uint64_t offset = AlignSectionOffset(sizeof(FileHeader));
+    for(int i = 0; i < SECTION_NUM; i++)
+    {
+        header.sections[i].offset = offset;
+        header.sections[i].count = section_counts[i];
+        offset = AlignSectionOffset(offset + section_counts[i]*sizeof(int32_t));
+    }
+
+    // 先在内存中拼好文件头之后的内容, 算出校验和
+    std::vector<char> payload(offset - sizeof(FileHeader), 0);
+    for(int i = 0; i < SECTION_NUM; i++)
+    {
+        if(section_counts[i] > 0)
+        {
+            std::memcpy(payload.data() + (header.sections[i].offset - sizeof(FileHeader)), section_data[i], section_counts[i]*sizeof(int32_t));
+        }
+    }
+    header.payload_digest = ComputePayloadDigest(payload.data(), payload.size());
+
+    std::ofstream output(file_path, std::ios::binary | std::ios::trunc);
+    if(!output.is_open())
+    {
+        return false;
+    }
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(payload.data(), std::streamsize(payload.size()));
+    output.flush();
+
+    return bool(output);
+}
+
+bool CellGraphFile::Open(const std::string& file_path)
+{
+    BCD_PROFILE_SCOPE("CellGraphFile::Open");
+
+    Close();
+
+#if defined(_WIN32)
+    std::ifstream input(file_path, std::ios::binary);
+    if(!input.is_open())
+    {
+        return false;
+    }
+    buffer.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+#else
+    int file_descriptor = open(file_path.c_str(), O_RDONLY);
+    if(file_descriptor < 0)
+    {
+        return false;
+    }
+    struct stat file_status;
+    if(fstat(file_descriptor, &file_status) != 0 || file_status.st_size < off_t(sizeof(FileHeader)))
+    {
+        close(file_descriptor);
+        return false;
+    }
+    void* mapping = mmap(nullptr, size_t(file_status.st_size), PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    close(file_descriptor);
+    if(mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    data = static_cast<const char*>(mapping);
+    size = size_t(file_status.st_size);
+#endif
+
+    FileHeader header;
+    if(size < sizeof(header))
+    {
+        Close();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if(std::memcmp(header.magic, cell_graph_file_magic, sizeof(header.magic)) != 0
+       || header.byte_order != cell_graph_file_byte_order
+       || header.version != cell_graph_file_version
+       || (header.decomposition_mode != 0 && header.decomposition_mode != 1)
+       || header.cell_num < 0 || header.wall_contour_num < 0)
+    {
+        Close();
+        return false;
+    }
+
+    section_offsets.resize(SECTION_NUM);
+    section_sizes.resize(SECTION_NUM);
+    for(int i = 0; i < SECTION_NUM; i++)
+    {
+        const FileSection& section = header.sections[i];
+        if(section.offset % sizeof(int32_t) != 0 || section.offset < sizeof(header) || section.offset > size
+           || section.count > (size - section.offset) / sizeof(int32_t))
+        {
+            Close();
+            return false;
+        }
+        section_offsets[i] = section.offset;
+        section_sizes[i] = section.count;
+    }
+
+    if(header.payload_digest != ComputePayloadDigest(data + sizeof(header), size - sizeof(header)))
+    {
+        Close();
+        return false;
+    }
+
+    info.version = header.version;
+    info.map_digest = header.map_digest;
+    info.map_cols = header.map_cols;
+    info.map_rows = header.map_rows;
+    info.robot_radius = header.robot_radius;
+    info.vertex_decomposition = header.decomposition_mode == 1;
+    info.cell_num = header.cell_num;
+    min_column_x = header.min_column_x;
+    wall_contour_num = header.wall_contour_num;
+
+    return true;
+}
+
+void CellGraphFile::Close()
+{
+    if(data != nullptr)
+    {
+#if defined(_WIN32)
+        std::vector<char>().swap(buffer);
+#else
+        munmap(const_cast<char*>(data), size);
+#endif
+    }
+    data = nullptr;
+    size = 0;
+    info = CellGraphFileInfo();
+    min_column_x = 0;
+    wall_contour_num = 0;
+    section_offsets.clear();
+    section_sizes.clear();
+}
+
+bool CellGraphFile::IsOpen() const
+{
+    return data != nullptr;
+}
+
+const CellGraphFileInfo& CellGraphFile::GetInfo() const
+{
+    return info;
+}
+
+bool CellGraphFile::Matches(const cv::Mat1b& map, int robot_radius, bool vertex_decomposition) const
+{
+    return IsOpen()
+        && info.robot_radius == robot_radius
+        && info.vertex_decomposition == vertex_decomposition
+        && info.map_cols == map.cols && info.map_rows == map.rows
+        && info.map_digest == ComputeMapDigest(map);
+}
+
+const int* CellGraphFile::Section(int section_index) const
+{
+    return reinterpret_cast<const int*>(data + section_offsets[section_index]);
+}
+
+size_t CellGraphFile::SectionSize(int section_index) const
+{
+    return size_t(section_sizes[section_index]);
+}
+
+bool CellGraphFile::Load(CellGraph& cell_graph, std::vector<std::vector<cv::Point>>& wall_contours, std::vector<std::vector<cv::Point>>& obstacle_contours) const
+{
+    BCD_PROFILE_SCOPE("CellGraphFile::Load");
+
+    if(!IsOpen())
+    {
+        return false;
+    }
+
+    size_t cell_num = size_t(info.cell_num);
+    if(SectionSize(LEFT_X_SECTION) != cell_num
+       || SectionSize(COLUMN_OFFSETS_SECTION) != cell_num+1
+       || SectionSize(NEIGHBOR_OFFSETS_SECTION) != cell_num+1
+       || SectionSize(CEILING_Y_SECTION) != SectionSize(FLOOR_Y_SECTION)
+       || SectionSize(COLUMN_INTERVALS_SECTION) % 4 != 0
+       || SectionSize(CONTOUR_POINTS_SECTION) % 2 != 0
+       || SectionSize(CONTOUR_OFFSETS_SECTION) < size_t(wall_contour_num)+1)
+    {
+        return false;
+    }
+
+    if(!IsOffsetList(Section(COLUMN_OFFSETS_SECTION), cell_num+1, SectionSize(CEILING_Y_SECTION))
+       || !IsOffsetList(Section(NEIGHBOR_OFFSETS_SECTION), cell_num+1, SectionSize(NEIGHBOR_LIST_SECTION))
+       || !IsOffsetList(Section(CONTOUR_OFFSETS_SECTION), SectionSize(CONTOUR_OFFSETS_SECTION), SectionSize(CONTOUR_POINTS_SECTION)/2))
+    {
+        return false;
+    }
+
+    // 每个cell至少一列, 每列的ceiling不低于floor; ceiling_y与floor_y共用column_offsets, 总长度相同即逐cell对齐
+    const int* column_offsets = Section(COLUMN_OFFSETS_SECTION);
+    for(size_t i = 0; i < cell_num; i++)
+    {
+        if(column_offsets[i+1] <= column_offsets[i])
+        {
+            return false;
+        }
+    }
+    const int* ceiling_y = Section(CEILING_Y_SECTION);
+    const int* floor_y = Section(FLOOR_Y_SECTION);
+    for(size_t i = 0; i < SectionSize(CEILING_Y_SECTION); i++)
+    {
+        if(ceiling_y[i] > floor_y[i])
+        {
+            return false;
+        }
+    }
+
+    size_t interval_num = SectionSize(COLUMN_INTERVALS_SECTION) / 4;
+    if(SectionSize(INTERVAL_OFFSETS_SECTION) > 0 && !IsOffsetList(Section(INTERVAL_OFFSETS_SECTION), SectionSize(INTERVAL_OFFSETS_SECTION), interval_num))
+    {
+        return false;
+    }
+    if(SectionSize(INTERVAL_OFFSETS_SECTION) == 0 && interval_num > 0)
+    {
+        return false;
+    }
+
+    const int* neighbor_list = Section(NEIGHBOR_LIST_SECTION);
+    for(size_t i = 0; i < SectionSize(NEIGHBOR_LIST_SECTION); i++)
+    {
+        if(neighbor_list[i] < 0 || size_t(neighbor_list[i]) >= cell_num)
+        {
+            return false;
+        }
+    }
+    const int* column_intervals = Section(COLUMN_INTERVALS_SECTION);
+    for(size_t i = 0; i < interval_num; i++)
+    {
+        int interval_cell_index = column_intervals[4*i+3];
+        if(interval_cell_index < 0 || size_t(interval_cell_index) >= cell_num)
+        {
+            return false;
+        }
+    }
+
+    auto copy_section = [this](int section_index, std::vector<int>& values)
+    {
+        values.assign(Section(section_index), Section(section_index) + SectionSize(section_index));
+    };
+
+    cell_graph.Clear();
+    copy_section(LEFT_X_SECTION, cell_graph.left_x);
+    copy_section(COLUMN_OFFSETS_SECTION, cell_graph.column_offsets);
+    copy_section(CEILING_Y_SECTION, cell_graph.ceiling_y);
+    copy_section(FLOOR_Y_SECTION, cell_graph.floor_y);
+    copy_section(NEIGHBOR_OFFSETS_SECTION, cell_graph.neighbor_offsets);
+    copy_section(NEIGHBOR_LIST_SECTION, cell_graph.neighbor_list);
+    copy_section(INTERVAL_OFFSETS_SECTION, cell_graph.interval_offsets);
+    cell_graph.column_intervals.resize(interval_num);
+    if(interval_num > 0)
+    {
+        std::memcpy(cell_graph.column_intervals.data(), column_intervals, interval_num*sizeof(CellGraph::ColumnInterval));
+    }
+    cell_graph.min_column_x = min_column_x;
+
+    cell_graph.visited_flags.assign(cell_num, false);
+    cell_graph.cleaned_flags.assign(cell_num, false);
+    cell_graph.parent_indices.assign(cell_num, INT_MAX);
+
+    const int* contour_offsets = Section(CONTOUR_OFFSETS_SECTION);
+    const int* contour_points = Section(CONTOUR_POINTS_SECTION);
+    wall_contours.clear();
+    obstacle_contours.clear();
+    for(size_t i = 0; i+1 < SectionSize(CONTOUR_OFFSETS_SECTION); i++)
+    {
+        std::vector<cv::Point> contour;
+        contour.reserve(contour_offsets[i+1]-contour_offsets[i]);
+        for(int j = contour_offsets[i]; j < contour_offsets[i+1]; j++)
+        {
+            contour.emplace_back(cv::Point(contour_points[2*j], contour_points[2*j+1]));
+        }
+        (i < size_t(wall_contour_num) ? wall_contours : obstacle_contours).emplace_back(contour);
+    }
+
+    return true;
+}
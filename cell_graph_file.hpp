@@ -0,0 +1,90 @@
+#ifndef BCD_PLANNER_CELL_GRAPH_FILE_H
+#define BCD_PLANNER_CELL_GRAPH_FILE_H
+
+#include <cstdint>
+#include <vector>
+#include <string>
+
+#include <opencv2/core/core.hpp>
+
+#include "bcd.hpp"
+
+
+/** 二进制cell graph文件: 保存分解的结果(扁平cell graph及其按列索引, 膨胀后的轮廓)以及生成它的地图摘要, 机器人半径与分解方式 **/
+/** 文件头之后是若干段int32数组, 每段按8字节对齐; 启动时mmap整个文件, 检查之后把各段直接拷贝进CellGraph, 不需要重新分解 **/
+/** 数值按本机字节序存放, 字节序或版本不同, 或校验和不符的文件会被拒绝 **/
+
+
+const uint32_t cell_graph_file_version = 2;
+
+// 二值化之后的地图的64位FNV-1a摘要(含宽高)
+uint64_t ComputeMapDigest(const cv::Mat1b& map);
+// 扁平cell graph的64位FNV-1a摘要(各cell的列范围, ceiling, floor与邻居)
+uint64_t ComputeCellGraphDigest(const CellGraph& cell_graph);
+
+class CellGraphFileInfo
+{
+public:
+    CellGraphFileInfo()
+    {
+        version = 0;
+        map_digest = 0;
+        map_cols = 0;
+        map_rows = 0;
+        robot_radius = 0;
+        vertex_decomposition = false;
+        cell_num = 0;
+    }
+    uint32_t version;
+    uint64_t map_digest;
+    int map_cols;
+    int map_rows;
+    int robot_radius;
+    // 顶点级分解(true)还是逐像素分解(false)
+    bool vertex_decomposition;
+    int cell_num;
+};
+
+class CellGraphFile
+{
+public:
+    CellGraphFile();
+    ~CellGraphFile();
+
+    CellGraphFile(const CellGraphFile&) = delete;
+    CellGraphFile& operator=(const CellGraphFile&) = delete;
+
+    // map为分解时使用的(二值化之后的)地图, vertex_decomposition为分解方式
+    static bool Write(const std::string& file_path, const cv::Mat1b& map, int robot_radius, bool vertex_decomposition, const CellGraph& cell_graph,
+                      const std::vector<std::vector<cv::Point>>& wall_contours, const std::vector<std::vector<cv::Point>>& obstacle_contours);
+
+    // 映射文件并检查文件头与各段是否越界
+    bool Open(const std::string& file_path);
+    void Close();
+    bool IsOpen() const;
+    const CellGraphFileInfo& GetInfo() const;
+
+    // 文件是否由这张地图, 半径与分解方式生成
+    bool Matches(const cv::Mat1b& map, int robot_radius, bool vertex_decomposition) const;
+
+    // 拷贝出cell graph与轮廓, 各段之间不一致(偏移不单调, 下标越界等)时返回false且不修改输出
+    bool Load(CellGraph& cell_graph, std::vector<std::vector<cv::Point>>& wall_contours, std::vector<std::vector<cv::Point>>& obstacle_contours) const;
+
+private:
+    const int* Section(int section_index) const;
+    size_t SectionSize(int section_index) const;
+
+    const char* data;
+    size_t size;
+#if defined(_WIN32)
+    std::vector<char> buffer;
+#endif
+
+    CellGraphFileInfo info;
+    int min_column_x;
+    int wall_contour_num;
+    std::vector<uint64_t> section_offsets;
+    std::vector<uint64_t> section_sizes;
+};
+
+#endif //BCD_PLANNER_CELL_GRAPH_FILE_H
@@ -0,0 +1,219 @@
+#include <algorithm>
+
+#include "configuration_space.hpp"
+#include "profiler.hpp"
+
+
+ConfigurationSpaceCache::ConfigurationSpaceCache(int capacity)
+{
+    this->capacity = std::max(capacity, 1);
+    map_data = std::make_shared<MapData>();
+}
+
+bool ConfigurationSpaceCache::LoadMap(const std::string& map_file_path)
+{
+    cv::Mat1b original_map = ReadMap(map_file_path);
+    if(original_map.empty())
+    {
+        return false;
+    }
+
+    SetMap(original_map);
+    return true;
+}
+
+void ConfigurationSpaceCache::SetMap(const cv::Mat1b& original_map)
+{
+    std::shared_ptr<MapData> new_map_data = std::make_shared<MapData>();
+    new_map_data->map = PreprocessMap(original_map);
+    ExtractRawContours(new_map_data->map, new_map_data->raw_wall_contours, new_map_data->raw_obstacle_contours);
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    map_data = new_map_data;
+    recent_radii.clear();
+    entries.clear();
+    pending_builds.clear();
+}
+
+void ConfigurationSpaceCache::SetCapacity(int capacity)
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    this->capacity = std::max(capacity, 1);
+    while(int(recent_radii.size()) > this->capacity)
+    {
+        entries.erase(recent_radii.back());
+        recent_radii.pop_back();
+    }
+}
+
+std::shared_ptr<const ConfigurationSpace> ConfigurationSpaceCache::Get(int robot_radius)
+{
+    BCD_PROFILE_SCOPE("ConfigurationSpaceCache::Get");
+
+    robot_radius = std::max(robot_radius, 0);
+
+    // 未命中时在锁内登记该半径正在生成, 生成本身在锁外进行
+    std::shared_ptr<PendingBuild> pending;
+    std::unique_ptr<std::promise<std::shared_ptr<const ConfigurationSpace>>> promise;
+    std::shared_ptr<MapData> building_map_data;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+
+        auto entry = entries.find(robot_radius);
+        if(entry != entries.end())
+        {
+            BCD_PROFILE_COUNT("configuration_space_hits", 1);
+            recent_radii.splice(recent_radii.begin(), recent_radii, entry->second.second);
+            return entry->second.first;
+        }
+
+        auto pending_build = pending_builds.find(robot_radius);
+        if(pending_build != pending_builds.end())
+        {
+            BCD_PROFILE_COUNT("configuration_space_waits", 1);
+            pending = pending_build->second;
+        }
+        else
+        {
+            BCD_PROFILE_COUNT("configuration_space_misses", 1);
+            promise.reset(new std::promise<std::shared_ptr<const ConfigurationSpace>>());
+            pending = std::make_shared<PendingBuild>(promise->get_future().share());
+            pending_builds[robot_radius] = pending;
+            building_map_data = map_data;
+        }
+    }
+
+    // 同一半径正在由其它请求生成, 等待它的结果
+    if(promise == nullptr)
+    {
+        return pending->get();
+    }
+
+    std::shared_ptr<const ConfigurationSpace> configuration_space;
+    try
+    {
+        configuration_space = Construct(*building_map_data, robot_radius);
+    }
+    catch(...)
+    {
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            auto pending_build = pending_builds.find(robot_radius);
+            if(pending_build != pending_builds.end() && pending_build->second == pending)
+            {
+                pending_builds.erase(pending_build);
+            }
+        }
+        promise->set_exception(std::current_exception());
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+
+        // 生成期间SetMap或Clear过时登记已被清除, 结果只交给等待它的请求, 不放入缓存
+        auto pending_build = pending_builds.find(robot_radius);
+        if(pending_build != pending_builds.end() && pending_build->second == pending)
+        {
+            pending_builds.erase(pending_build);
+            if(configuration_space != nullptr)
+            {
+                recent_radii.push_front(robot_radius);
+                entries[robot_radius] = std::make_pair(configuration_space, recent_radii.begin());
+                if(int(recent_radii.size()) > capacity)
+                {
+                    entries.erase(recent_radii.back());
+                    recent_radii.pop_back();
+                }
+            }
+        }
+    }
+
+    promise->set_value(configuration_space);
+    return configuration_space;
+}
+
+bool ConfigurationSpaceCache::Contains(int robot_radius) const
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return entries.find(std::max(robot_radius, 0)) != entries.end();
+}
+
+void ConfigurationSpaceCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    recent_radii.clear();
+    entries.clear();
+    pending_builds.clear();
+}
+
+int ConfigurationSpaceCache::Size() const
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return int(entries.size());
+}
+
+int ConfigurationSpaceCache::GetCapacity() const
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return capacity;
+}
+
+cv::Mat1b ConfigurationSpaceCache::GetMap() const
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return map_data->map;
+}
+
+// 与Planner::Decompose的逐像素流程相同, 只是轮廓来自缓存的原始轮廓与距离场
+std::shared_ptr<ConfigurationSpace> ConfigurationSpaceCache::Construct(MapData& map_data, int robot_radius)
+{
+    BCD_PROFILE_SCOPE("ConfigurationSpaceCache::Construct");
+
+    const cv::Mat1b& map = map_data.map;
+    if(map.empty() || map_data.raw_wall_contours.empty())
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<ConfigurationSpace> configuration_space = std::make_shared<ConfigurationSpace>();
+    configuration_space->robot_radius = robot_radius;
+
+    if(robot_radius == 0)
+    {
+        configuration_space->wall_contours = map_data.raw_wall_contours;
+        configuration_space->obstacle_contours = map_data.raw_obstacle_contours;
+    }
+    else
+    {
+        std::call_once(map_data.distance_field_flag, [&map_data]()
+        {
+            map_data.distance_field = ComputeObstacleDistanceField(map_data.map, map_data.raw_wall_contours, map_data.raw_obstacle_contours);
+        });
+        ExtractInflatedContours(map_data.distance_field, robot_radius, configuration_space->wall_contours, configuration_space->obstacle_contours);
+        if(configuration_space->wall_contours.empty())
+        {
+            return nullptr;
+        }
+    }
+
+    configuration_space->wall = ConstructWall(map, configuration_space->wall_contours.front());
+    configuration_space->obstacles = ConstructObstacles(map, configuration_space->obstacle_contours);
+
+    cv::Mat3b free_space_map = ConstructFreeSpaceMap(map, configuration_space->wall_contours, configuration_space->obstacle_contours);
+    std::vector<Event> wall_event_list = GenerateWallEventList(free_space_map, configuration_space->wall);
+    std::vector<Event> obstacle_event_list = GenerateObstacleEventList(free_space_map, configuration_space->obstacles);
+    SliceList slice_list = SliceListGenerator(wall_event_list, obstacle_event_list);
+
+    std::vector<int> cell_index_slice;
+    std::vector<int> original_cell_index_slice;
+    ExecuteCellDecomposition(configuration_space->cell_graph, configuration_space->flat_cell_graph, cell_index_slice, original_cell_index_slice, slice_list);
+    if(configuration_space->cell_graph.empty())
+    {
+        return nullptr;
+    }
+
+    return configuration_space;
+}
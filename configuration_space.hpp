@@ -0,0 +1,84 @@
+#ifndef BCD_PLANNER_CONFIGURATION_SPACE_H
+#define BCD_PLANNER_CONFIGURATION_SPACE_H
+
+#include <vector>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <string>
+
+#include <opencv2/core/core.hpp>
+
+#include "bcd.hpp"
+
+
+/** 某个半径下的分解结果, 生成后只读; 规划时在flat_cell_graph的副本上进行 **/
+class ConfigurationSpace
+{
+public:
+    int robot_radius;
+    std::vector<std::vector<cv::Point>> wall_contours;
+    std::vector<std::vector<cv::Point>> obstacle_contours;
+    Polygon wall;
+    PolygonList obstacles;
+    std::vector<CellNode> cell_graph;
+    CellGraph flat_cell_graph;
+};
+
+
+/** 同一张地图上多种半径的配置空间缓存: 原始轮廓与障碍物距离场只计算一次, **/
+/** 每个半径第一次请求时才从距离场生成轮廓, 多边形与cell graph, 按最近使用的顺序最多保留capacity个半径 **/
+class ConfigurationSpaceCache
+{
+public:
+    explicit ConfigurationSpaceCache(int capacity=8);
+
+    // 读取并二值化地图, 清空缓存
+    bool LoadMap(const std::string& map_file_path);
+    void SetMap(const cv::Mat1b& original_map);
+    // 缩小容量时立即丢弃最久未使用的半径
+    void SetCapacity(int capacity);
+
+    // 可在多个线程中调用; 生成时不持有锁, 不同半径可同时生成, 同一半径只生成一次, 其它请求等待同一个结果
+    // 已被丢弃的结果只要还有人持有就仍然有效; 地图为空或该半径下没有空闲区域时返回nullptr(不缓存)
+    std::shared_ptr<const ConfigurationSpace> Get(int robot_radius);
+    bool Contains(int robot_radius) const;
+    void Clear();
+
+    int Size() const;
+    int GetCapacity() const;
+    // 返回的cv::Mat与缓存共享像素, SetMap之后仍指向原来的地图
+    cv::Mat1b GetMap() const;
+
+private:
+    /** 一张地图的原始轮廓与距离场, SetMap时整体替换; 正在生成的配置空间持有旧的一份, 不受影响 **/
+    class MapData
+    {
+    public:
+        cv::Mat1b map;
+        std::vector<std::vector<cv::Point>> raw_wall_contours;
+        std::vector<std::vector<cv::Point>> raw_obstacle_contours;
+        // 第一次需要膨胀时计算, 多个半径同时生成时只计算一次
+        std::once_flag distance_field_flag;
+        cv::Mat1f distance_field;
+    };
+
+    typedef std::shared_future<std::shared_ptr<const ConfigurationSpace>> PendingBuild;
+
+    static std::shared_ptr<ConfigurationSpace> Construct(MapData& map_data, int robot_radius);
+
+    mutable std::mutex cache_mutex;
+
+    std::shared_ptr<MapData> map_data;
+
+    int capacity;
+    // 最近使用的半径在前
+    std::list<int> recent_radii;
+    std::map<int, std::pair<std::shared_ptr<const ConfigurationSpace>, std::list<int>::iterator>> entries;
+    // 正在生成的半径; SetMap与Clear时清空, 之后完成的结果不再放入缓存
+    std::map<int, std::shared_ptr<PendingBuild>> pending_builds;
+};
+
+#endif //BCD_PLANNER_CONFIGURATION_SPACE_H
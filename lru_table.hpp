@@ -0,0 +1,87 @@
+#ifndef BCD_PLANNER_LRU_TABLE_H
+#define BCD_PLANNER_LRU_TABLE_H
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+
+/** 最近最少使用的淘汰表, 不加锁, 由各缓存在自己的锁内使用 **/
+template <typename Key, typename Value, typename Hash>
+class LeastRecentlyUsedTable
+{
+public:
+    std::shared_ptr<const Value> Find(const Key& key)
+    {
+        auto entry = entries.find(key);
+        if(entry == entries.end())
+        {
+            return nullptr;
+        }
+        recent_keys.splice(recent_keys.begin(), recent_keys, entry->second.second);
+        return entry->second.first;
+    }
+
+    void Insert(const Key& key, std::shared_ptr<const Value> value, int capacity)
+    {
+        auto entry = entries.find(key);
+        if(entry != entries.end())
+        {
+            entry->second.first = value;
+            recent_keys.splice(recent_keys.begin(), recent_keys, entry->second.second);
+            return;
+        }
+
+        recent_keys.push_front(key);
+        entries[key] = std::make_pair(value, recent_keys.begin());
+        Shrink(capacity);
+    }
+
+    void Shrink(int capacity)
+    {
+        while(int(recent_keys.size()) > capacity)
+        {
+            entries.erase(recent_keys.back());
+            recent_keys.pop_back();
+        }
+    }
+
+    void Erase(const Key& key)
+    {
+        auto entry = entries.find(key);
+        if(entry != entries.end())
+        {
+            recent_keys.erase(entry->second.second);
+            entries.erase(entry);
+        }
+    }
+
+    void Clear()
+    {
+        recent_keys.clear();
+        entries.clear();
+    }
+
+    int Size() const
+    {
+        return int(entries.size());
+    }
+
+    // 最近使用的在前
+    const std::list<Key>& GetRecentKeys() const
+    {
+        return recent_keys;
+    }
+
+    std::shared_ptr<const Value> Peek(const Key& key) const
+    {
+        auto entry = entries.find(key);
+        return entry == entries.end() ? nullptr : entry->second.first;
+    }
+
+private:
+    std::list<Key> recent_keys;
+    std::unordered_map<Key, std::pair<std::shared_ptr<const Value>, typename std::list<Key>::iterator>, Hash> entries;
+};
+
+#endif //BCD_PLANNER_LRU_TABLE_H
@@ -0,0 +1,399 @@
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+#include "plan_cache.hpp"
+#include "profiler.hpp"
+
+
+namespace
+{
+
+const char plan_cache_file_magic[8] = {'B', 'C', 'D', 'P', 'L', 'A', 'N', 'S'};
+// 键中含分解结果的摘要, 只改变覆盖路径的生成方式而分解结果不变时须增加版本号
+const uint32_t plan_cache_file_version = 2;
+const uint32_t plan_cache_file_byte_order = 0x01020304;
+
+// 64位FNV-1a, 按字节混入
+class KeyDigest
+{
+public:
+    KeyDigest()
+    {
+        digest = 14695981039346656037ULL;
+    }
+
+    template <typename T>
+    void Mix(const T& value)
+    {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        for(unsigned char byte : bytes)
+        {
+            digest ^= byte;
+            digest *= 1099511628211ULL;
+        }
+    }
+
+    uint64_t digest;
+};
+
+// 从内存中按顺序读取定长数值, 越界后一直失败
+class FileCursor
+{
+public:
+    FileCursor(const std::vector<char>& buffer)
+    {
+        data = buffer.data();
+        remaining = buffer.size();
+        good = true;
+    }
+
+    template <typename T>
+    bool Read(T& value)
+    {
+        if(!good || remaining < sizeof(T))
+        {
+            good = false;
+            return false;
+        }
+        std::memcpy(&value, data, sizeof(T));
+        data += sizeof(T);
+        remaining -= sizeof(T);
+        return true;
+    }
+
+    const char* data;
+    size_t remaining;
+    bool good;
+};
+
+template <typename T>
+void AppendValue(std::vector<char>& payload, const T& value)
+{
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    payload.insert(payload.end(), bytes, bytes+sizeof(T));
+}
+
+uint64_t ComputePayloadDigest(const char* payload, size_t payload_size)
+{
+    KeyDigest digest;
+    for(size_t i = 0; i < payload_size; i++)
+    {
+        digest.Mix(payload[i]);
+    }
+    return digest.digest;
+}
+
+}
+
+bool operator==(const PlanKey& lhs, const PlanKey& rhs)
+{
+    return lhs.map_digest == rhs.map_digest && lhs.cell_graph_digest == rhs.cell_graph_digest && lhs.robot_radius == rhs.robot_radius
+        && lhs.vertex_decomposition == rhs.vertex_decomposition && lhs.cell_sequencing == rhs.cell_sequencing
+        && lhs.start_cell_index == rhs.start_cell_index
+        && lhs.start_point.x == rhs.start_point.x && lhs.start_point.y == rhs.start_point.y;
+}
+
+size_t PlanKeyHash::operator()(const PlanKey& key) const
+{
+    KeyDigest digest;
+    digest.Mix(key.map_digest);
+    digest.Mix(key.cell_graph_digest);
+    digest.Mix(key.robot_radius);
+    digest.Mix(uint8_t(key.vertex_decomposition));
+    digest.Mix(uint8_t(key.cell_sequencing));
+    digest.Mix(key.start_cell_index);
+    digest.Mix(key.start_point.x);
+    digest.Mix(key.start_point.y);
+    return size_t(digest.digest);
+}
+
+bool operator==(const NavigationKey& lhs, const NavigationKey& rhs)
+{
+    return lhs.plan_key == rhs.plan_key
+        && lhs.start_point.x == rhs.start_point.x && lhs.start_point.y == rhs.start_point.y
+        && lhs.direction_x == rhs.direction_x && lhs.direction_y == rhs.direction_y
+        && lhs.meters_per_pix == rhs.meters_per_pix;
+}
+
+size_t NavigationKeyHash::operator()(const NavigationKey& key) const
+{
+    KeyDigest digest;
+    digest.Mix(uint64_t(PlanKeyHash()(key.plan_key)));
+    digest.Mix(key.start_point.x);
+    digest.Mix(key.start_point.y);
+    digest.Mix(key.direction_x);
+    digest.Mix(key.direction_y);
+    digest.Mix(key.meters_per_pix);
+    return size_t(digest.digest);
+}
+
+PlanCache::PlanCache(int capacity)
+{
+    this->capacity = std::max(capacity, 1);
+    hit_count = 0;
+    miss_count = 0;
+}
+
+std::shared_ptr<const CachedPlan> PlanCache::Find(const PlanKey& key)
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    std::shared_ptr<const CachedPlan> plan = plans.Find(key);
+    if(plan == nullptr)
+    {
+        BCD_PROFILE_COUNT("plan_cache_misses", 1);
+        miss_count++;
+    }
+    else
+    {
+        BCD_PROFILE_COUNT("plan_cache_hits", 1);
+        hit_count++;
+    }
+    return plan;
+}
+
+void PlanCache::Insert(const PlanKey& key, std::shared_ptr<const CachedPlan> plan)
+{
+    if(plan == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    plans.Insert(key, plan, capacity);
+}
+
+std::shared_ptr<const std::vector<NavigationMessage>> PlanCache::FindMessages(const NavigationKey& key)
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    std::shared_ptr<const std::vector<NavigationMessage>> messages = navigation_messages.Find(key);
+    if(messages == nullptr)
+    {
+        BCD_PROFILE_COUNT("plan_cache_misses", 1);
+        miss_count++;
+    }
+    else
+    {
+        BCD_PROFILE_COUNT("plan_cache_hits", 1);
+        hit_count++;
+    }
+    return messages;
+}
+
+void PlanCache::InsertMessages(const NavigationKey& key, std::shared_ptr<const std::vector<NavigationMessage>> messages)
+{
+    if(messages == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    navigation_messages.Insert(key, messages, capacity);
+}
+
+void PlanCache::SetCapacity(int capacity)
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    this->capacity = std::max(capacity, 1);
+    plans.Shrink(this->capacity);
+    navigation_messages.Shrink(this->capacity);
+}
+
+int PlanCache::GetCapacity() const
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return capacity;
+}
+
+int PlanCache::Size() const
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return plans.Size();
+}
+
+void PlanCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    plans.Clear();
+    navigation_messages.Clear();
+}
+
+long long PlanCache::GetHitCount() const
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return hit_count;
+}
+
+long long PlanCache::GetMissCount() const
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return miss_count;
+}
+
+// 文件头: magic, 版本, 字节序, 其后内容的校验和; 之后为项数与各项: 键, 起点, init_path_length, 子路径数, 每条子路径的点数与各点
+bool PlanCache::Save(const std::string& file_path) const
+{
+    BCD_PROFILE_SCOPE("PlanCache::Save");
+
+    std::vector<char> payload;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+
+        AppendValue(payload, uint64_t(plans.Size()));
+        for(const auto& key : plans.GetRecentKeys())
+        {
+            std::shared_ptr<const CachedPlan> plan = plans.Peek(key);
+
+            AppendValue(payload, key.map_digest);
+            AppendValue(payload, key.cell_graph_digest);
+            AppendValue(payload, int32_t(key.robot_radius));
+            AppendValue(payload, uint8_t(key.vertex_decomposition));
+            AppendValue(payload, uint8_t(key.cell_sequencing));
+            AppendValue(payload, int32_t(key.start_cell_index));
+            AppendValue(payload, int32_t(key.start_point.x));
+            AppendValue(payload, int32_t(key.start_point.y));
+
+            AppendValue(payload, int32_t(plan->start_point.x));
+            AppendValue(payload, int32_t(plan->start_point.y));
+            AppendValue(payload, int32_t(plan->init_path_length));
+            AppendValue(payload, uint64_t(plan->global_path.size()));
+            for(const auto& sub_path : plan->global_path)
+            {
+                AppendValue(payload, uint64_t(sub_path.size()));
+                for(const auto& point : sub_path)
+                {
+                    AppendValue(payload, int32_t(point.x));
+                    AppendValue(payload, int32_t(point.y));
+                }
+            }
+        }
+    }
+
+    std::vector<char> header;
+    header.insert(header.end(), plan_cache_file_magic, plan_cache_file_magic+sizeof(plan_cache_file_magic));
+    AppendValue(header, plan_cache_file_version);
+    AppendValue(header, plan_cache_file_byte_order);
+    AppendValue(header, ComputePayloadDigest(payload.data(), payload.size()));
+
+    std::ofstream output(file_path, std::ios::binary | std::ios::trunc);
+    if(!output.is_open())
+    {
+        return false;
+    }
+    output.write(header.data(), std::streamsize(header.size()));
+    output.write(payload.data(), std::streamsize(payload.size()));
+    output.flush();
+
+    return bool(output);
+}
+
+bool PlanCache::Load(const std::string& file_path)
+{
+    BCD_PROFILE_SCOPE("PlanCache::Load");
+
+    std::ifstream input(file_path, std::ios::binary);
+    if(!input.is_open())
+    {
+        return false;
+    }
+    std::vector<char> buffer((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    FileCursor cursor(buffer);
+    char magic[8];
+    uint32_t version = 0;
+    uint32_t byte_order = 0;
+    uint64_t payload_digest = 0;
+    uint64_t entry_num = 0;
+    for(char& character : magic)
+    {
+        cursor.Read(character);
+    }
+    cursor.Read(version);
+    cursor.Read(byte_order);
+    cursor.Read(payload_digest);
+    if(!cursor.good || std::memcmp(magic, plan_cache_file_magic, sizeof(magic)) != 0
+       || version != plan_cache_file_version || byte_order != plan_cache_file_byte_order
+       || payload_digest != ComputePayloadDigest(cursor.data, cursor.remaining))
+    {
+        return false;
+    }
+    cursor.Read(entry_num);
+
+    std::vector<std::pair<PlanKey, std::shared_ptr<const CachedPlan>>> loaded_plans;
+    for(uint64_t i = 0; i < entry_num && cursor.good; i++)
+    {
+        PlanKey key;
+        int32_t robot_radius = 0, start_cell_index = 0, key_x = 0, key_y = 0;
+        uint8_t vertex_decomposition = 0, cell_sequencing = 0;
+        cursor.Read(key.map_digest);
+        cursor.Read(key.cell_graph_digest);
+        cursor.Read(robot_radius);
+        cursor.Read(vertex_decomposition);
+        cursor.Read(cell_sequencing);
+        cursor.Read(start_cell_index);
+        cursor.Read(key_x);
+        cursor.Read(key_y);
+        key.robot_radius = robot_radius;
+        key.vertex_decomposition = vertex_decomposition != 0;
+        key.cell_sequencing = cell_sequencing != 0;
+        key.start_cell_index = start_cell_index;
+        key.start_point = Point2D(key_x, key_y);
+
+        std::shared_ptr<CachedPlan> plan = std::make_shared<CachedPlan>();
+        int32_t start_x = 0, start_y = 0, init_path_length = 0;
+        uint64_t sub_path_num = 0;
+        cursor.Read(start_x);
+        cursor.Read(start_y);
+        cursor.Read(init_path_length);
+        cursor.Read(sub_path_num);
+        plan->start_point = Point2D(start_x, start_y);
+        plan->init_path_length = init_path_length;
+
+        // 每条子路径至少占8字节, 数目不可能超过剩余的字节数
+        if(!cursor.good || sub_path_num > cursor.remaining/sizeof(uint64_t))
+        {
+            return false;
+        }
+        plan->global_path.resize(sub_path_num);
+        for(auto& sub_path : plan->global_path)
+        {
+            uint64_t point_num = 0;
+            if(!cursor.Read(point_num) || point_num > cursor.remaining/(2*sizeof(int32_t)))
+            {
+                return false;
+            }
+            for(uint64_t j = 0; j < point_num; j++)
+            {
+                int32_t x = 0, y = 0;
+                cursor.Read(x);
+                cursor.Read(y);
+                sub_path.emplace_back(Point2D(x, y));
+            }
+        }
+
+        // 命中时会改写第一条子路径, 没有子路径的项视为损坏
+        if(plan->global_path.empty() || init_path_length < 0 || size_t(init_path_length) > plan->global_path.front().size())
+        {
+            return false;
+        }
+        loaded_plans.emplace_back(key, plan);
+    }
+    if(!cursor.good || cursor.remaining != 0)
+    {
+        return false;
+    }
+
+    // 文件中最近使用的在前, 倒序插入以保持原来的顺序
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    for(auto loaded_plan = loaded_plans.rbegin(); loaded_plan != loaded_plans.rend(); loaded_plan++)
+    {
+        plans.Insert(loaded_plan->first, loaded_plan->second, capacity);
+    }
+
+    return true;
+}
@@ -0,0 +1,127 @@
+#ifndef BCD_PLANNER_PLAN_CACHE_H
+#define BCD_PLANNER_PLAN_CACHE_H
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "bcd.hpp"
+#include "lru_table.hpp"
+
+
+/** 规划结果的键: 地图摘要(ComputeMapDigest), 分解结果的摘要(ComputeCellGraphDigest), 半径, 分解方式与起点所在的cell **/
+/** 分解结果的摘要使分解算法改变之后, 旧版本保存的路径不会再命中 **/
+/** 按深度优先顺序规划时, 访问顺序只取决于起点所在的cell, 起点本身只影响从起点走到第一个cell角点的那一段; **/
+/** 按代价排序(cell sequencing)时访问顺序与起点有关, 此时起点也是键的一部分 **/
+class PlanKey
+{
+public:
+    PlanKey()
+    {
+        map_digest = 0;
+        cell_graph_digest = 0;
+        robot_radius = 0;
+        vertex_decomposition = false;
+        cell_sequencing = false;
+        start_cell_index = -1;
+    }
+    uint64_t map_digest;
+    uint64_t cell_graph_digest;
+    int robot_radius;
+    bool vertex_decomposition;
+    bool cell_sequencing;
+    int start_cell_index;
+    // 只在cell_sequencing时使用, 否则保持默认值
+    Point2D start_point;
+};
+
+bool operator==(const PlanKey& lhs, const PlanKey& rhs);
+
+class PlanKeyHash
+{
+public:
+    size_t operator()(const PlanKey& key) const;
+};
+
+/** 运动指令的键: 在规划的键之外还与确切的起点, 初始朝向以及每像素的米数有关 **/
+class NavigationKey
+{
+public:
+    NavigationKey()
+    {
+        direction_x = 0.0;
+        direction_y = 0.0;
+        meters_per_pix = 0.0;
+    }
+    PlanKey plan_key;
+    Point2D start_point;
+    double direction_x;
+    double direction_y;
+    double meters_per_pix;
+};
+
+bool operator==(const NavigationKey& lhs, const NavigationKey& rhs);
+
+class NavigationKeyHash
+{
+public:
+    size_t operator()(const NavigationKey& key) const;
+};
+
+class CachedPlan
+{
+public:
+    CachedPlan()
+    {
+        init_path_length = 0;
+    }
+    // 规划时使用的起点
+    Point2D start_point;
+    // global_path.front()的前init_path_length个点是从start_point走到第一个cell角点的路径
+    int init_path_length;
+    std::deque<std::deque<Point2D>> global_path;
+};
+
+
+/** 覆盖路径与运动指令的缓存, 可被多个Planner共享, 所有接口可在多个线程中调用 **/
+/** 规划与运动指令各自最多保留capacity项; Save/Load只保存路径, 运动指令由路径重新生成 **/
+class PlanCache
+{
+public:
+    explicit PlanCache(int capacity=64);
+
+    std::shared_ptr<const CachedPlan> Find(const PlanKey& key);
+    void Insert(const PlanKey& key, std::shared_ptr<const CachedPlan> plan);
+
+    std::shared_ptr<const std::vector<NavigationMessage>> FindMessages(const NavigationKey& key);
+    void InsertMessages(const NavigationKey& key, std::shared_ptr<const std::vector<NavigationMessage>> messages);
+
+    // 缩小容量时立即丢弃最久未使用的项
+    void SetCapacity(int capacity);
+    int GetCapacity() const;
+    // 缓存的路径数
+    int Size() const;
+    void Clear();
+
+    // 查找的命中与未命中次数(路径与运动指令合计)
+    long long GetHitCount() const;
+    long long GetMissCount() const;
+
+    // 按最近使用的顺序写出全部路径; 读入时与已有内容合并, 文件版本不符或损坏(含没有子路径的项)时返回false且不修改缓存
+    bool Save(const std::string& file_path) const;
+    bool Load(const std::string& file_path);
+
+private:
+    mutable std::mutex cache_mutex;
+    int capacity;
+    long long hit_count;
+    long long miss_count;
+
+    LeastRecentlyUsedTable<PlanKey, CachedPlan, PlanKeyHash> plans;
+    LeastRecentlyUsedTable<NavigationKey, std::vector<NavigationMessage>, NavigationKeyHash> navigation_messages;
+};
+
+#endif //BCD_PLANNER_PLAN_CACHE_H
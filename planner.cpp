@@ -0,0 +1,440 @@
+#include "planner.hpp"
+#include "cell_graph_file.hpp"
+
+
+Planner::Planner()
+{
+    map_digest = ComputeMapDigest(map);
+    cell_graph_digest = 0;
+    robot_radius = 0;
+    cell_sequencing = false;
+    vertex_decomposition = false;
+    decomposition_stripes = 1;
+    parallel_sweeps = false;
+    decomposed = false;
+}
+
+bool Planner::LoadMap(const std::string& map_file_path)
+{
+    cv::Mat1b original_map = ReadMap(map_file_path);
+    if(original_map.empty())
+    {
+        return false;
+    }
+
+    SetMap(original_map);
+    return true;
+}
+
+void Planner::SetMap(const cv::Mat1b& original_map)
+{
+    map = PreprocessMap(original_map);
+    map_digest = ComputeMapDigest(map);
+    Reset();
+}
+
+void Planner::SetRobotRadius(int radius)
+{
+    if(radius != robot_radius)
+    {
+        robot_radius = radius;
+        Reset();
+    }
+}
+
+void Planner::SetCellSequencing(bool enable)
+{
+    cell_sequencing = enable;
+}
+
+void Planner::SetVertexDecomposition(bool enable)
+{
+    if(vertex_decomposition != enable)
+    {
+        vertex_decomposition = enable;
+        Reset();
+    }
+}
+
+void Planner::SetDecompositionStripes(int stripe_num)
+{
+    decomposition_stripes = stripe_num;
+}
+
+void Planner::SetParallelSweeps(bool enable)
+{
+    parallel_sweeps = enable;
+}
+
+void Planner::SetPlanCache(const std::shared_ptr<PlanCache>& plan_cache)
+{
+    this->plan_cache = plan_cache;
+}
+
+void Planner::SetSweepCache(const std::shared_ptr<SweepCache>& sweep_cache)
+{
+    // 挂在扁平cell graph上, 规划时的副本一并带上; Assign/Clear不会去掉它
+    flat_cell_graph.SetSweepCache(sweep_cache);
+}
+
+bool Planner::Decompose(Profiler* profiler)
+{
+    ProfileSession session(profiler);
+    BCD_PROFILE_SCOPE("Decompose");
+
+    if(map.empty())
+    {
+        return false;
+    }
+
+    ExtractContours(map, wall_contours, obstacle_contours, robot_radius);
+    if(wall_contours.empty())
+    {
+        return false;
+    }
+
+    if(vertex_decomposition)
+    {
+        cell_graph = ConstructCellGraphFromVertices(map, wall_contours, obstacle_contours, wall_event_list, obstacle_event_list);
+        flat_cell_graph.Assign(cell_graph);
+        cell_graph_digest = ComputeCellGraphDigest(flat_cell_graph);
+
+        decomposed = !cell_graph.empty();
+        return decomposed;
+    }
+
+    wall = ConstructWall(map, wall_contours.front());
+    obstacles = ConstructObstacles(map, obstacle_contours);
+
+    cv::Mat3b free_space_map = ConstructFreeSpaceMap(map, wall_contours, obstacle_contours);
+    wall_event_list = GenerateWallEventList(free_space_map, wall);
+    obstacle_event_list = GenerateObstacleEventList(free_space_map, obstacles);
+    slice_list = SliceListGenerator(wall_event_list, obstacle_event_list);
+
+    if(decomposition_stripes != 1)
+    {
+        ExecuteStripedCellDecomposition(cell_graph, flat_cell_graph, slice_list, decomposition_stripes);
+    }
+    else
+    {
+        std::vector<int> cell_index_slice;
+        std::vector<int> original_cell_index_slice;
+        cell_graph.clear();
+        ExecuteCellDecomposition(cell_graph, flat_cell_graph, cell_index_slice, original_cell_index_slice, slice_list);
+    }
+    cell_graph_digest = ComputeCellGraphDigest(flat_cell_graph);
+
+    decomposed = !cell_graph.empty();
+    return decomposed;
+}
+
+bool Planner::IsDecomposed() const
+{
+    return decomposed;
+}
+
+bool Planner::SaveDecomposition(const std::string& file_path) const
+{
+    if(!decomposed)
+    {
+        return false;
+    }
+    return CellGraphFile::Write(file_path, map, robot_radius, vertex_decomposition, flat_cell_graph, wall_contours, obstacle_contours);
+}
+
+bool Planner::LoadDecomposition(const std::string& file_path, Profiler* profiler)
+{
+    ProfileSession session(profiler);
+    BCD_PROFILE_SCOPE("LoadDecomposition");
+
+    if(map.empty())
+    {
+        return false;
+    }
+
+    CellGraphFile cell_graph_file;
+    if(!cell_graph_file.Open(file_path) || !cell_graph_file.Matches(map, robot_radius, vertex_decomposition))
+    {
+        return false;
+    }
+
+    // 先读进局部变量, 文件有问题时保留原来的分解结果
+    CellGraph loaded_cell_graph;
+    loaded_cell_graph.SetSweepCache(flat_cell_graph.GetSweepCache());
+    std::vector<std::vector<cv::Point>> loaded_wall_contours;
+    std::vector<std::vector<cv::Point>> loaded_obstacle_contours;
+    if(!cell_graph_file.Load(loaded_cell_graph, loaded_wall_contours, loaded_obstacle_contours))
+    {
+        return false;
+    }
+
+    Reset();
+    flat_cell_graph = std::move(loaded_cell_graph);
+    wall_contours.swap(loaded_wall_contours);
+    obstacle_contours.swap(loaded_obstacle_contours);
+    flat_cell_graph.CopyTo(cell_graph);
+    cell_graph_digest = ComputeCellGraphDigest(flat_cell_graph);
+
+    decomposed = !cell_graph.empty();
+    return decomposed;
+}
+
+std::deque<std::deque<Point2D>> Planner::PlanCoverage(const Point2D& start_point, Profiler* profiler) const
+{
+    ProfileSession session(profiler);
+    BCD_PROFILE_SCOPE("PlanCoverage");
+
+    if(!decomposed)
+    {
+        return {};
+    }
+
+    std::vector<int> start_cell_indices = DetermineCellIndex(flat_cell_graph, start_point);
+    if(start_cell_indices.empty())
+    {
+        return {};
+    }
+
+    if(plan_cache != nullptr)
+    {
+        return FindOrPlanCoverage(start_point, start_cell_indices.front());
+    }
+
+    CellGraph working_graph = flat_cell_graph;
+    return StaticPathPlanning(working_graph, start_point, robot_radius, cell_sequencing, parallel_sweeps);
+}
+
+std::vector<NavigationMessage> Planner::PlanNavigation(const Point2D& start_point, const Eigen::Vector2d& curr_direction, double meters_per_pix, Profiler* profiler) const
+{
+    ProfileSession session(profiler);
+    BCD_PROFILE_SCOPE("PlanNavigation");
+
+    if(!decomposed)
+    {
+        return {};
+    }
+
+    std::vector<int> start_cell_indices = DetermineCellIndex(flat_cell_graph, start_point);
+    if(start_cell_indices.empty())
+    {
+        return {};
+    }
+
+    if(plan_cache == nullptr)
+    {
+        CellGraph working_graph = flat_cell_graph;
+        return StaticNavigationPlanning(working_graph, start_point, robot_radius, curr_direction, meters_per_pix, cell_sequencing, parallel_sweeps);
+    }
+
+    NavigationKey key;
+    key.plan_key = MakePlanKey(start_point, start_cell_indices.front());
+    key.start_point = start_point;
+    key.direction_x = curr_direction.x();
+    key.direction_y = curr_direction.y();
+    key.meters_per_pix = meters_per_pix;
+
+    std::shared_ptr<const std::vector<NavigationMessage>> cached_messages = plan_cache->FindMessages(key);
+    if(cached_messages != nullptr)
+    {
+        return *cached_messages;
+    }
+
+    std::shared_ptr<std::vector<NavigationMessage>> messages = std::make_shared<std::vector<NavigationMessage>>(
+            GetNavigationMessage(curr_direction, FilterTrajectory(FindOrPlanCoverage(start_point, start_cell_indices.front())), meters_per_pix));
+    plan_cache->InsertMessages(key, messages);
+    return *messages;
+}
+
+std::deque<SegmentPath> Planner::PlanCoverageSegments(const Point2D& start_point, Profiler* profiler) const
+{
+    ProfileSession session(profiler);
+    BCD_PROFILE_SCOPE("PlanCoverageSegments");
+
+    if(!decomposed)
+    {
+        return {};
+    }
+
+    if(DetermineCellIndex(flat_cell_graph, start_point).empty())
+    {
+        return {};
+    }
+
+    CellGraph working_graph = flat_cell_graph;
+    return StaticSegmentPathPlanning(working_graph, start_point, robot_radius, cell_sequencing, parallel_sweeps);
+}
+
+std::deque<Point2D> Planner::PlanReturning(const Point2D& curr_pos, const Point2D& original_pos, Profiler* profiler) const
+{
+    ProfileSession session(profiler);
+    BCD_PROFILE_SCOPE("PlanReturning");
+
+    if(!decomposed)
+    {
+        return {};
+    }
+
+    if(DetermineCellIndex(flat_cell_graph, curr_pos).empty() || DetermineCellIndex(flat_cell_graph, original_pos).empty())
+    {
+        return {};
+    }
+
+    // 返回时覆盖已经完成, 在所有cell都标记为已清扫的副本上规划, 途经的cell只经过角点而不再往返清扫
+    CellGraph working_graph = flat_cell_graph;
+    for(int i = 0; i < working_graph.Size(); i++)
+    {
+        working_graph.SetCleaned(i, true);
+    }
+    return ReturningPathPlanning(working_graph, curr_pos, original_pos, robot_radius);
+}
+
+const cv::Mat1b& Planner::GetMap() const
+{
+    return map;
+}
+
+int Planner::GetRobotRadius() const
+{
+    return robot_radius;
+}
+
+bool Planner::IsCellSequencing() const
+{
+    return cell_sequencing;
+}
+
+bool Planner::IsVertexDecomposition() const
+{
+    return vertex_decomposition;
+}
+
+int Planner::GetDecompositionStripes() const
+{
+    return decomposition_stripes;
+}
+
+bool Planner::IsParallelSweeps() const
+{
+    return parallel_sweeps;
+}
+
+const std::shared_ptr<PlanCache>& Planner::GetPlanCache() const
+{
+    return plan_cache;
+}
+
+const std::shared_ptr<SweepCache>& Planner::GetSweepCache() const
+{
+    return flat_cell_graph.GetSweepCache();
+}
+
+const std::vector<std::vector<cv::Point>>& Planner::GetWallContours() const
+{
+    return wall_contours;
+}
+
+const std::vector<std::vector<cv::Point>>& Planner::GetObstacleContours() const
+{
+    return obstacle_contours;
+}
+
+const Polygon& Planner::GetWall() const
+{
+    return wall;
+}
+
+const PolygonList& Planner::GetObstacles() const
+{
+    return obstacles;
+}
+
+const std::vector<Event>& Planner::GetWallEventList() const
+{
+    return wall_event_list;
+}
+
+const std::vector<Event>& Planner::GetObstacleEventList() const
+{
+    return obstacle_event_list;
+}
+
+const SliceList& Planner::GetSliceList() const
+{
+    return slice_list;
+}
+
+const std::vector<CellNode>& Planner::GetCellGraph() const
+{
+    return cell_graph;
+}
+
+const CellGraph& Planner::GetFlatCellGraph() const
+{
+    return flat_cell_graph;
+}
+
+void Planner::Reset()
+{
+    wall_contours.clear();
+    obstacle_contours.clear();
+    wall.clear();
+    obstacles.clear();
+    wall_event_list.clear();
+    obstacle_event_list.clear();
+    slice_list.Clear();
+    cell_graph.clear();
+    flat_cell_graph.Clear();
+    cell_graph_digest = 0;
+    decomposed = false;
+}
+
+PlanKey Planner::MakePlanKey(const Point2D& start_point, int start_cell_index) const
+{
+    PlanKey key;
+    key.map_digest = map_digest;
+    key.cell_graph_digest = cell_graph_digest;
+    key.robot_radius = robot_radius;
+    key.vertex_decomposition = vertex_decomposition;
+    key.cell_sequencing = cell_sequencing;
+    key.start_cell_index = start_cell_index;
+    if(cell_sequencing)
+    {
+        key.start_point = start_point;
+    }
+    return key;
+}
+
+// 同一cell内起点不同时, 只替换从起点走到第一个cell左上角的那一段
+std::deque<std::deque<Point2D>> Planner::FindOrPlanCoverage(const Point2D& start_point, int start_cell_index) const
+{
+    PlanKey key = MakePlanKey(start_point, start_cell_index);
+    std::shared_ptr<const CachedPlan> cached_plan = plan_cache->Find(key);
+
+    if(cached_plan == nullptr)
+    {
+        std::shared_ptr<CachedPlan> plan = std::make_shared<CachedPlan>();
+        CellGraph working_graph = flat_cell_graph;
+        plan->start_point = start_point;
+        plan->global_path = StaticPathPlanning(working_graph, start_point, robot_radius, cell_sequencing, parallel_sweeps);
+        if(!cell_sequencing)
+        {
+            Point2D first_corner = ComputeCellCornerPoints(flat_cell_graph, start_cell_index)[TOPLEFT];
+            plan->init_path_length = int(WalkInsideCell(flat_cell_graph, start_cell_index, start_point, first_corner).size());
+        }
+        plan_cache->Insert(key, plan);
+        return plan->global_path;
+    }
+
+    if(cell_sequencing || (cached_plan->start_point.x == start_point.x && cached_plan->start_point.y == start_point.y))
+    {
+        return cached_plan->global_path;
+    }
+
+    std::deque<std::deque<Point2D>> global_path = cached_plan->global_path;
+    Point2D first_corner = ComputeCellCornerPoints(flat_cell_graph, start_cell_index)[TOPLEFT];
+    std::deque<Point2D> init_path = WalkInsideCell(flat_cell_graph, start_cell_index, start_point, first_corner);
+    global_path.front().erase(global_path.front().begin(), global_path.front().begin()+cached_plan->init_path_length);
+    global_path.front().insert(global_path.front().begin(), init_path.begin(), init_path.end());
+
+    return global_path;
+}
@@ -0,0 +1,112 @@
+#ifndef BCD_PLANNER_PLANNER_H
+#define BCD_PLANNER_PLANNER_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+
+#include <opencv2/core/core.hpp>
+
+#include "bcd.hpp"
+#include "plan_cache.hpp"
+#include "sweep_cache.hpp"
+#include "profiler.hpp"
+
+
+/** 无界面的规划器：地图只分解一次，之后可重复规划 **/
+class Planner
+{
+public:
+    Planner();
+
+    // 读取并二值化地图, 之前的分解结果作废
+    bool LoadMap(const std::string& map_file_path);
+    void SetMap(const cv::Mat1b& original_map);
+    // 半径改变后需要重新分解
+    void SetRobotRadius(int radius);
+    // 打开后按转移代价优化cell的访问顺序(SequenceCells), 默认按深度优先顺序
+    void SetCellSequencing(bool enable);
+    // 打开后直接在轮廓顶点上分解(ConstructCellGraphFromVertices), 不再生成逐像素的多边形与slice, 需要重新分解
+    void SetVertexDecomposition(bool enable);
+    // 逐像素分解时把slice切成多少个竖直条带并行扫描, 1为单线程(默认), <=0按线程池大小; 结果与单线程相同
+    void SetDecompositionStripes(int stripe_num);
+    // 打开后各cell的往返路径在线程池中并行生成(StaticPathPlanning的parallel_sweeps), 结果不变
+    void SetParallelSweeps(bool enable);
+    // 规划结果缓存, 可在多个Planner之间共享; nullptr为不缓存(默认)
+    void SetPlanCache(const std::shared_ptr<PlanCache>& plan_cache);
+    // 各cell的往返路径缓存, 可在多个Planner之间共享, 重新分解或换地图后几何不变的cell仍可命中; nullptr为不缓存(默认)
+    void SetSweepCache(const std::shared_ptr<SweepCache>& sweep_cache);
+
+    // 提取轮廓 -> 生成事件 -> 构造cell graph
+    // 传入profiler时记录各阶段的耗时与计数, 需要以BCD_PROFILING编译
+    bool Decompose(Profiler* profiler=nullptr);
+    bool IsDecomposed() const;
+
+    // 把分解结果写成二进制文件(CellGraphFile), 需要先分解
+    bool SaveDecomposition(const std::string& file_path) const;
+    // 从文件恢复分解结果, 文件必须由当前的地图, 半径与分解方式生成; 不恢复逐像素的多边形, 事件与slice
+    // 读取失败时保留原来的分解结果
+    bool LoadDecomposition(const std::string& file_path, Profiler* profiler=nullptr);
+
+    // 每次规划都在扁平cell graph的副本上进行, 分解结果保持不变
+    // 设置了PlanCache时先按地图摘要, 半径与起点所在的cell查找, 命中时不再规划
+    std::deque<std::deque<Point2D>> PlanCoverage(const Point2D& start_point, Profiler* profiler=nullptr) const;
+    // 覆盖路径经FilterTrajectory后的运动指令, 设置了PlanCache时同样缓存
+    std::vector<NavigationMessage> PlanNavigation(const Point2D& start_point, const Eigen::Vector2d& curr_direction, double meters_per_pix, Profiler* profiler=nullptr) const;
+    // 覆盖完成后返回: 所有cell视为已清扫, 途经的cell只经过角点
+    std::deque<Point2D> PlanReturning(const Point2D& curr_pos, const Point2D& original_pos, Profiler* profiler=nullptr) const;
+    // 与PlanCoverage相同, 但子路径以游程形式返回
+    std::deque<SegmentPath> PlanCoverageSegments(const Point2D& start_point, Profiler* profiler=nullptr) const;
+
+    const cv::Mat1b& GetMap() const;
+    int GetRobotRadius() const;
+    bool IsCellSequencing() const;
+    bool IsVertexDecomposition() const;
+    int GetDecompositionStripes() const;
+    bool IsParallelSweeps() const;
+    const std::shared_ptr<PlanCache>& GetPlanCache() const;
+    const std::shared_ptr<SweepCache>& GetSweepCache() const;
+    const std::vector<std::vector<cv::Point>>& GetWallContours() const;
+    const std::vector<std::vector<cv::Point>>& GetObstacleContours() const;
+    const Polygon& GetWall() const;
+    const PolygonList& GetObstacles() const;
+    const std::vector<Event>& GetWallEventList() const;
+    const std::vector<Event>& GetObstacleEventList() const;
+    const SliceList& GetSliceList() const;
+    const std::vector<CellNode>& GetCellGraph() const;
+    // 规划时实际使用的扁平存储
+    const CellGraph& GetFlatCellGraph() const;
+
+private:
+    void Reset();
+    PlanKey MakePlanKey(const Point2D& start_point, int start_cell_index) const;
+    std::deque<std::deque<Point2D>> FindOrPlanCoverage(const Point2D& start_point, int start_cell_index) const;
+
+    cv::Mat1b map;
+    // 二值化之后的地图的摘要, 作为缓存键的一部分
+    uint64_t map_digest;
+    // 分解结果的摘要, 作为缓存键的一部分
+    uint64_t cell_graph_digest;
+    int robot_radius;
+    bool cell_sequencing;
+    bool vertex_decomposition;
+    int decomposition_stripes;
+    bool parallel_sweeps;
+    std::shared_ptr<PlanCache> plan_cache;
+
+    std::vector<std::vector<cv::Point>> wall_contours;
+    std::vector<std::vector<cv::Point>> obstacle_contours;
+    Polygon wall;
+    PolygonList obstacles;
+
+    std::vector<Event> wall_event_list;
+    std::vector<Event> obstacle_event_list;
+    SliceList slice_list;
+
+    std::vector<CellNode> cell_graph;
+    CellGraph flat_cell_graph;
+    bool decomposed;
+};
+
+#endif //BCD_PLANNER_PLANNER_H
@@ -0,0 +1,929 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include <climits>
+#include <chrono>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#if !defined(_WIN32)
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "planner_daemon.hpp"
+
+
+namespace
+{
+
+typedef std::chrono::steady_clock DaemonClock;
+
+double ElapsedMilliseconds(const DaemonClock::time_point& start, const DaemonClock::time_point& end)
+{
+    return std::chrono::duration<double, std::milli>(end-start).count();
+}
+
+/** 只支持一层的JSON对象, 值为字符串, 数字, true/false/null; 保存各值的原始文本 **/
+
+void SkipSpaces(const std::string& text, size_t& pos)
+{
+    while(pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' || text[pos] == '\n'))
+    {
+        pos++;
+    }
+}
+
+// pos指向左引号, 成功时pos指向右引号之后
+bool ParseJsonString(const std::string& text, size_t& pos, std::string& value)
+{
+    if(pos >= text.size() || text[pos] != '"')
+    {
+        return false;
+    }
+
+    value.clear();
+    for(pos++; pos < text.size(); pos++)
+    {
+        char character = text[pos];
+        if(character == '"')
+        {
+            pos++;
+            return true;
+        }
+        if(character != '\\')
+        {
+            value.push_back(character);
+            continue;
+        }
+
+        if(++pos >= text.size())
+        {
+            return false;
+        }
+        switch(text[pos])
+        {
+            case 'n': value.push_back('\n'); break;
+            case 't': value.push_back('\t'); break;
+            case 'r': value.push_back('\r'); break;
+            case 'b': value.push_back('\b'); break;
+            case 'f': value.push_back('\f'); break;
+            case 'u':
+            {
+                // 只需要ASCII范围内的字符
+                if(pos+4 >= text.size())
+                {
+                    return false;
+                }
+                long code = std::strtol(text.substr(pos+1, 4).c_str(), nullptr, 16);
+                value.push_back(code < 128 ? char(code) : '?');
+                pos += 4;
+                break;
+            }
+            default: value.push_back(text[pos]); break;
+        }
+    }
+    return false;
+}
+
+bool ParseJsonObject(const std::string& text, std::map<std::string, std::string>& fields, std::map<std::string, std::string>& raw_fields)
+{
+    size_t pos = 0;
+    SkipSpaces(text, pos);
+    if(pos >= text.size() || text[pos] != '{')
+    {
+        return false;
+    }
+    pos++;
+    SkipSpaces(text, pos);
+    if(pos < text.size() && text[pos] == '}')
+    {
+        pos++;
+        SkipSpaces(text, pos);
+        return pos == text.size();
+    }
+
+    while(pos < text.size())
+    {
+        std::string key;
+        SkipSpaces(text, pos);
+        if(!ParseJsonString(text, pos, key))
+        {
+            return false;
+        }
+        SkipSpaces(text, pos);
+        if(pos >= text.size() || text[pos] != ':')
+        {
+            return false;
+        }
+        pos++;
+        SkipSpaces(text, pos);
+
+        size_t value_start = pos;
+        std::string value;
+        if(pos < text.size() && text[pos] == '"')
+        {
+            if(!ParseJsonString(text, pos, value))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            while(pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ' ' && text[pos] != '\t')
+            {
+                pos++;
+            }
+            value = text.substr(value_start, pos-value_start);
+            if(value.empty() || value.front() == '{' || value.front() == '[')
+            {
+                return false;
+            }
+        }
+        fields[key] = value;
+        raw_fields[key] = text.substr(value_start, pos-value_start);
+
+        SkipSpaces(text, pos);
+        if(pos < text.size() && text[pos] == ',')
+        {
+            pos++;
+            continue;
+        }
+        if(pos < text.size() && text[pos] == '}')
+        {
+            pos++;
+            SkipSpaces(text, pos);
+            return pos == text.size();
+        }
+        return false;
+    }
+    return false;
+}
+
+std::string EscapeJsonString(const std::string& text)
+{
+    std::string escaped = "\"";
+    for(char character : text)
+    {
+        if(character == '"' || character == '\\')
+        {
+            escaped.push_back('\\');
+            escaped.push_back(character);
+        }
+        else if(character == '\n')
+        {
+            escaped += "\\n";
+        }
+        else if((unsigned char)(character) < 0x20)
+        {
+            escaped.push_back(' ');
+        }
+        else
+        {
+            escaped.push_back(character);
+        }
+    }
+    escaped.push_back('"');
+    return escaped;
+}
+
+// 按JSON数值文法检查: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+bool IsJsonNumber(const std::string& text)
+{
+    size_t pos = 0;
+    auto skip_digits = [&]()
+    {
+        size_t start = pos;
+        while(pos < text.size() && std::isdigit((unsigned char)(text[pos])))
+        {
+            pos++;
+        }
+        return pos > start;
+    };
+
+    if(pos < text.size() && text[pos] == '-')
+    {
+        pos++;
+    }
+    if(pos < text.size() && text[pos] == '0')
+    {
+        pos++;
+    }
+    else if(!skip_digits())
+    {
+        return false;
+    }
+    if(pos < text.size() && text[pos] == '.')
+    {
+        pos++;
+        if(!skip_digits())
+        {
+            return false;
+        }
+    }
+    if(pos < text.size() && (text[pos] == 'e' || text[pos] == 'E'))
+    {
+        pos++;
+        if(pos < text.size() && (text[pos] == '+' || text[pos] == '-'))
+        {
+            pos++;
+        }
+        if(!skip_digits())
+        {
+            return false;
+        }
+    }
+    return pos == text.size();
+}
+
+class Request
+{
+public:
+    std::string GetString(const std::string& key) const
+    {
+        auto field = fields.find(key);
+        return field == fields.end() ? std::string() : field->second;
+    }
+
+    bool HasField(const std::string& key) const
+    {
+        return fields.find(key) != fields.end();
+    }
+
+    // 只接受int范围内的整数, 1e300, nan, 2.7之类返回false
+    bool GetInt(const std::string& key, int& value) const
+    {
+        auto field = fields.find(key);
+        if(field == fields.end())
+        {
+            return false;
+        }
+        char* end = nullptr;
+        double number = std::strtod(field->second.c_str(), &end);
+        if(end == field->second.c_str() || *end != '\0')
+        {
+            return false;
+        }
+        if(!std::isfinite(number) || number != std::floor(number) || number < double(INT_MIN) || number > double(INT_MAX))
+        {
+            return false;
+        }
+        value = int(number);
+        return true;
+    }
+
+    // 半径: 缺省时返回true并保持value不变, 给出但不是非负整数时返回false
+    bool GetOptionalRadius(int& value) const
+    {
+        if(!HasField("radius"))
+        {
+            return true;
+        }
+        int radius = 0;
+        if(!GetInt("radius", radius) || radius < 0)
+        {
+            return false;
+        }
+        value = radius;
+        return true;
+    }
+
+    bool GetDouble(const std::string& key, double& value) const
+    {
+        auto field = fields.find(key);
+        if(field == fields.end())
+        {
+            return false;
+        }
+        char* end = nullptr;
+        double number = std::strtod(field->second.c_str(), &end);
+        if(end == field->second.c_str() || *end != '\0' || !std::isfinite(number))
+        {
+            return false;
+        }
+        value = number;
+        return true;
+    }
+
+    // 回显用的id: 没有时为null; 只接受JSON数值或字符串, 其它形式返回false, id置为null
+    bool GetReplyId(std::string& id) const
+    {
+        id = "null";
+        auto field = raw_fields.find("id");
+        if(field == raw_fields.end())
+        {
+            return true;
+        }
+        const std::string& raw = field->second;
+        if(!raw.empty() && raw[0] == '"')
+        {
+            // 字符串按解析后的内容重新转义, 保证回复仍是合法JSON
+            id = EscapeJsonString(fields.at("id"));
+            return true;
+        }
+        if(!IsJsonNumber(raw))
+        {
+            return false;
+        }
+        id = raw;
+        return true;
+    }
+
+    std::map<std::string, std::string> fields;
+    std::map<std::string, std::string> raw_fields;
+};
+
+// 回复的公共部分, payload为空或以逗号开头的其余字段
+std::string FormatReply(const std::string& raw_id, bool ok, double queue_milliseconds, double latency_milliseconds, const std::string& payload)
+{
+    std::ostringstream reply;
+    reply<<"{\"id\":"<<raw_id<<",\"ok\":"<<(ok ? "true" : "false")
+         <<",\"queue_ms\":"<<queue_milliseconds<<",\"latency_ms\":"<<latency_milliseconds<<payload<<"}";
+    return reply.str();
+}
+
+std::string FormatError(const std::string& error)
+{
+    return ",\"error\":" + EscapeJsonString(error);
+}
+
+std::string FormatPath(const std::deque<Point2D>& path)
+{
+    std::ostringstream payload;
+    payload<<",\"path\":[";
+    for(size_t i = 0; i < path.size(); i++)
+    {
+        payload<<(i > 0 ? ",[" : "[")<<path[i].x<<","<<path[i].y<<"]";
+    }
+    payload<<"]";
+    return payload.str();
+}
+
+std::string FormatMessages(const std::vector<NavigationMessage>& messages)
+{
+    std::ostringstream payload;
+    payload<<",\"messages\":[";
+    for(size_t i = 0; i < messages.size(); i++)
+    {
+        double distance, global_yaw, local_yaw;
+        NavigationMessage message = messages[i];
+        message.GetMotion(distance, global_yaw, local_yaw);
+        payload<<(i > 0 ? ",[" : "[")<<distance<<","<<global_yaw<<","<<local_yaw<<"]";
+    }
+    payload<<"]";
+    return payload.str();
+}
+
+}
+
+PlannerService::PlannerService(int plan_cache_capacity, int planner_capacity)
+{
+    plan_cache = std::make_shared<PlanCache>(plan_cache_capacity);
+    this->planner_capacity = std::max(planner_capacity, 1);
+}
+
+const std::shared_ptr<PlanCache>& PlannerService::GetPlanCache() const
+{
+    return plan_cache;
+}
+
+std::shared_ptr<MapSession> PlannerService::FindSession(const std::string& map_name) const
+{
+    std::lock_guard<std::mutex> lock(session_mutex);
+    auto session = sessions.find(map_name);
+    return session == sessions.end() ? nullptr : session->second;
+}
+
+std::shared_ptr<const Planner> PlannerService::GetPlanner(MapSession& session, int robot_radius) const
+{
+    // 未登记的半径在锁内登记, 分解在锁外进行, 其它半径上的规划不必等待
+    std::shared_ptr<const MapSession::PendingPlanner> pending;
+    std::unique_ptr<std::promise<std::shared_ptr<const Planner>>> promise;
+    {
+        std::lock_guard<std::mutex> lock(session.planner_mutex);
+        pending = session.planners.Find(robot_radius);
+        if(pending == nullptr)
+        {
+            promise.reset(new std::promise<std::shared_ptr<const Planner>>());
+            pending = std::make_shared<const MapSession::PendingPlanner>(promise->get_future().share());
+            session.planners.Insert(robot_radius, pending, planner_capacity);
+        }
+    }
+
+    // 同一半径正在由其它请求分解或已经分解过, 等待或直接取它的结果
+    if(promise == nullptr)
+    {
+        return pending->get();
+    }
+
+    std::shared_ptr<Planner> new_planner = std::make_shared<Planner>();
+    try
+    {
+        new_planner->SetMap(session.map);
+        new_planner->SetRobotRadius(robot_radius);
+        new_planner->SetPlanCache(plan_cache);
+        if(!new_planner->Decompose())
+        {
+            new_planner = nullptr;
+        }
+    }
+    catch(...)
+    {
+        // 分解中途失败(如内存不足)时去掉登记, 之后的请求重新分解
+        {
+            std::lock_guard<std::mutex> lock(session.planner_mutex);
+            if(session.planners.Peek(robot_radius) == pending)
+            {
+                session.planners.Erase(robot_radius);
+            }
+        }
+        promise->set_exception(std::current_exception());
+        throw;
+    }
+
+    promise->set_value(new_planner);
+    return new_planner;
+}
+
+std::function<void()> PlannerService::Dispatch(const std::string& request_line, const std::function<void(const std::string&)>& reply, bool& stop_requested)
+{
+    DaemonClock::time_point received = DaemonClock::now();
+
+    Request request;
+    if(!ParseJsonObject(request_line, request.fields, request.raw_fields))
+    {
+        reply(FormatReply("null", false, 0.0, ElapsedMilliseconds(received, DaemonClock::now()), FormatError("malformed request")));
+        return nullptr;
+    }
+
+    std::string raw_id;
+    if(!request.GetReplyId(raw_id))
+    {
+        reply(FormatReply(raw_id, false, 0.0, ElapsedMilliseconds(received, DaemonClock::now()), FormatError("invalid id")));
+        return nullptr;
+    }
+    std::string op = request.GetString("op");
+    std::string map_name = request.GetString("map");
+
+    auto reply_now = [&](bool ok, const std::string& payload)
+    {
+        reply(FormatReply(raw_id, ok, 0.0, ElapsedMilliseconds(received, DaemonClock::now()), payload));
+    };
+
+    if(op == "shutdown")
+    {
+        stop_requested = true;
+        reply_now(true, "");
+        return nullptr;
+    }
+
+    if(op == "load_map")
+    {
+        cv::Mat1b original_map = ReadMap(request.GetString("path"));
+        if(original_map.empty())
+        {
+            reply_now(false, FormatError("cannot read map"));
+            return nullptr;
+        }
+
+        std::shared_ptr<MapSession> session = std::make_shared<MapSession>();
+        session->robot_radius = 0;
+        if(!request.GetOptionalRadius(session->robot_radius))
+        {
+            reply_now(false, FormatError("invalid radius"));
+            return nullptr;
+        }
+        session->map = PreprocessMap(original_map);
+
+        // 先分解默认半径, 之后的规划请求不必等待
+        if(GetPlanner(*session, session->robot_radius) == nullptr)
+        {
+            reply_now(false, FormatError("no free space at this radius"));
+            return nullptr;
+        }
+        {
+            std::lock_guard<std::mutex> lock(session_mutex);
+            sessions[map_name] = session;
+        }
+        reply_now(true, ",\"cols\":" + std::to_string(session->map.cols) + ",\"rows\":" + std::to_string(session->map.rows));
+        return nullptr;
+    }
+
+    if(op == "unload_map")
+    {
+        std::lock_guard<std::mutex> lock(session_mutex);
+        bool erased = sessions.erase(map_name) > 0;
+        reply(FormatReply(raw_id, erased, 0.0, ElapsedMilliseconds(received, DaemonClock::now()), erased ? "" : FormatError("unknown map")));
+        return nullptr;
+    }
+
+    std::shared_ptr<MapSession> session = FindSession(map_name);
+
+    if(op == "set_radius")
+    {
+        int robot_radius = 0;
+        if(session == nullptr || !request.HasField("radius"))
+        {
+            reply_now(false, FormatError(session == nullptr ? "unknown map" : "missing radius"));
+            return nullptr;
+        }
+        if(!request.GetOptionalRadius(robot_radius))
+        {
+            reply_now(false, FormatError("invalid radius"));
+            return nullptr;
+        }
+        if(GetPlanner(*session, robot_radius) == nullptr)
+        {
+            reply_now(false, FormatError("no free space at this radius"));
+            return nullptr;
+        }
+        {
+            std::lock_guard<std::mutex> lock(session->planner_mutex);
+            session->robot_radius = robot_radius;
+        }
+        reply_now(true, "");
+        return nullptr;
+    }
+
+    if(op != "plan_coverage" && op != "plan_return")
+    {
+        reply_now(false, FormatError("unknown op"));
+        return nullptr;
+    }
+    if(session == nullptr)
+    {
+        reply_now(false, FormatError("unknown map"));
+        return nullptr;
+    }
+
+    // 默认半径在分派时确定, 与请求的顺序一致
+    int robot_radius = 0;
+    if(!request.HasField("radius"))
+    {
+        std::lock_guard<std::mutex> lock(session->planner_mutex);
+        robot_radius = session->robot_radius;
+    }
+    else if(!request.GetOptionalRadius(robot_radius))
+    {
+        reply_now(false, FormatError("invalid radius"));
+        return nullptr;
+    }
+
+    return [this, request, raw_id, op, session, robot_radius, received, reply]()
+    {
+        DaemonClock::time_point started = DaemonClock::now();
+        auto reply_done = [&](bool ok, const std::string& payload)
+        {
+            reply(FormatReply(raw_id, ok, ElapsedMilliseconds(received, started), ElapsedMilliseconds(received, DaemonClock::now()), payload));
+        };
+
+        int x = 0, y = 0;
+        if(!request.GetInt("x", x) || !request.GetInt("y", y))
+        {
+            reply_done(false, FormatError("missing or invalid x or y"));
+            return;
+        }
+        std::shared_ptr<const Planner> planner = GetPlanner(*session, robot_radius);
+        if(planner == nullptr)
+        {
+            reply_done(false, FormatError("no free space at this radius"));
+            return;
+        }
+
+        Point2D point(x, y);
+        if(op == "plan_coverage")
+        {
+            std::deque<std::deque<Point2D>> global_path = planner->PlanCoverage(point);
+            if(global_path.empty())
+            {
+                reply_done(false, FormatError("start point is not in free space"));
+                return;
+            }
+            std::string payload = FormatPath(FilterTrajectory(global_path));
+
+            double meters_per_pix = 0.0;
+            if(request.GetDouble("meters_per_pix", meters_per_pix))
+            {
+                Eigen::Vector2d curr_direction = {0, -1};
+                request.GetDouble("direction_x", curr_direction.x());
+                request.GetDouble("direction_y", curr_direction.y());
+                payload += FormatMessages(planner->PlanNavigation(point, curr_direction, meters_per_pix));
+            }
+            reply_done(true, payload);
+        }
+        else
+        {
+            int home_x = 0, home_y = 0;
+            if(!request.GetInt("home_x", home_x) || !request.GetInt("home_y", home_y))
+            {
+                reply_done(false, FormatError("missing or invalid home_x or home_y"));
+                return;
+            }
+            std::deque<Point2D> returning_path = planner->PlanReturning(point, Point2D(home_x, home_y));
+            if(returning_path.empty())
+            {
+                reply_done(false, FormatError("point is not in free space"));
+                return;
+            }
+            reply_done(true, FormatPath(returning_path));
+        }
+    };
+}
+
+namespace
+{
+
+// 读取请求直到输入结束或收到shutdown, 规划任务交给线程池; 返回是否收到shutdown
+bool ServeRequests(PlannerService& service, ThreadPool& pool, const std::function<bool(std::string&)>& read_line, const std::function<void(const std::string&)>& reply)
+{
+    bool stop_requested = false;
+    std::string line;
+    while(!stop_requested && read_line(line))
+    {
+        if(line.find_first_not_of(" \t\r") == std::string::npos)
+        {
+            continue;
+        }
+        std::function<void()> task = service.Dispatch(line, reply, stop_requested);
+        if(task)
+        {
+            pool.Enqueue(task);
+        }
+    }
+    return stop_requested;
+}
+
+#if !defined(_WIN32)
+
+// 一行请求的最大长度, 超过时回复错误并断开连接, 一个客户端不能无限占用内存
+const size_t max_request_length = 1 << 20;
+
+// 一个socket连接, 任务持有shared_ptr, 全部回复写完后才关闭
+class DaemonConnection
+{
+public:
+    explicit DaemonConnection(int socket_descriptor)
+    {
+        this->socket_descriptor = socket_descriptor;
+        read_pos = 0;
+        too_long = false;
+    }
+
+    ~DaemonConnection()
+    {
+        close(socket_descriptor);
+    }
+
+    // 让阻塞中的ReadLine返回, 仍可写回复
+    void StopReading()
+    {
+        shutdown(socket_descriptor, SHUT_RD);
+    }
+
+    bool ReadLine(std::string& line)
+    {
+        while(true)
+        {
+            size_t line_end = buffer.find('\n', read_pos);
+            if(line_end != std::string::npos && line_end-read_pos <= max_request_length)
+            {
+                line = buffer.substr(read_pos, line_end-read_pos);
+                read_pos = line_end + 1;
+                return true;
+            }
+            buffer.erase(0, read_pos);
+            read_pos = 0;
+            if(line_end != std::string::npos || buffer.size() > max_request_length)
+            {
+                too_long = true;
+                buffer.clear();
+                StopReading();
+                return false;
+            }
+
+            char chunk[4096];
+            ssize_t received = read(socket_descriptor, chunk, sizeof(chunk));
+            if(received < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if(received <= 0)
+            {
+                // 最后一行可以没有换行
+                line = buffer;
+                buffer.clear();
+                return !line.empty();
+            }
+            buffer.append(chunk, size_t(received));
+        }
+    }
+
+    // ReadLine是否因为一行超过max_request_length而停止
+    bool IsTooLong() const
+    {
+        return too_long;
+    }
+
+    void WriteLine(const std::string& line)
+    {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        std::string data = line + "\n";
+        size_t written = 0;
+        while(written < data.size())
+        {
+            ssize_t result = write(socket_descriptor, data.data()+written, data.size()-written);
+            if(result < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if(result <= 0)
+            {
+                return;
+            }
+            written += size_t(result);
+        }
+    }
+
+private:
+    int socket_descriptor;
+    std::string buffer;
+    size_t read_pos;
+    bool too_long;
+    std::mutex write_mutex;
+};
+
+bool RunSocketDaemon(PlannerService& service, ThreadPool& pool, const std::string& socket_path)
+{
+    // 客户端提前断开时写回复不应终止进程
+    std::signal(SIGPIPE, SIG_IGN);
+
+    sockaddr_un address;
+    if(socket_path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr<<"socket path too long: "<<socket_path<<std::endl;
+        return false;
+    }
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path)-1);
+
+    int listen_descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listen_descriptor < 0)
+    {
+        return false;
+    }
+    unlink(socket_path.c_str());
+    if(bind(listen_descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listen_descriptor, 16) != 0)
+    {
+        std::cerr<<"cannot listen on "<<socket_path<<std::endl;
+        close(listen_descriptor);
+        return false;
+    }
+
+    // 每个连接一个读取线程, done在线程结束前置位
+    class ConnectionReader
+    {
+    public:
+        std::thread thread;
+        std::weak_ptr<DaemonConnection> connection;
+        std::shared_ptr<std::atomic<bool>> done;
+    };
+
+    std::mutex stop_mutex;
+    bool stopping = false;
+    std::vector<ConnectionReader> readers;
+
+    while(true)
+    {
+        int connection_descriptor = accept(listen_descriptor, nullptr, nullptr);
+        {
+            std::lock_guard<std::mutex> lock(stop_mutex);
+            if(stopping)
+            {
+                if(connection_descriptor >= 0)
+                {
+                    close(connection_descriptor);
+                }
+                break;
+            }
+        }
+        if(connection_descriptor < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        // 回收已经结束的读取线程, 长期运行时不随连接数累积
+        for(auto reader = readers.begin(); reader != readers.end(); )
+        {
+            if(reader->done->load())
+            {
+                reader->thread.join();
+                reader = readers.erase(reader);
+            }
+            else
+            {
+                ++reader;
+            }
+        }
+
+        std::shared_ptr<DaemonConnection> connection = std::make_shared<DaemonConnection>(connection_descriptor);
+        std::shared_ptr<std::atomic<bool>> done = std::make_shared<std::atomic<bool>>(false);
+        ConnectionReader reader;
+        reader.connection = connection;
+        reader.done = done;
+        reader.thread = std::thread([&service, &pool, &stop_mutex, &stopping, &socket_path, connection, done]()
+        {
+            auto read_line = [&connection](std::string& line){ return connection->ReadLine(line); };
+            auto reply = [connection](const std::string& line){ connection->WriteLine(line); };
+            bool stop_requested = ServeRequests(service, pool, read_line, reply);
+            if(connection->IsTooLong())
+            {
+                reply(FormatReply("null", false, 0.0, 0.0, FormatError("request too long")));
+            }
+            if(stop_requested)
+            {
+                std::lock_guard<std::mutex> lock(stop_mutex);
+                stopping = true;
+                // 连一次自己, 让accept返回
+                int wakeup_descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+                sockaddr_un wakeup_address;
+                std::memset(&wakeup_address, 0, sizeof(wakeup_address));
+                wakeup_address.sun_family = AF_UNIX;
+                std::strncpy(wakeup_address.sun_path, socket_path.c_str(), sizeof(wakeup_address.sun_path)-1);
+                if(wakeup_descriptor >= 0)
+                {
+                    connect(wakeup_descriptor, reinterpret_cast<sockaddr*>(&wakeup_address), sizeof(wakeup_address));
+                    close(wakeup_descriptor);
+                }
+            }
+            done->store(true);
+        });
+        readers.emplace_back(std::move(reader));
+    }
+
+    // 其余连接在客户端断开之前不会结束, 关闭它们的读端让读取线程退出, 已分派的请求照常回复
+    close(listen_descriptor);
+    for(const auto& reader : readers)
+    {
+        std::shared_ptr<DaemonConnection> connection = reader.connection.lock();
+        if(connection != nullptr)
+        {
+            connection->StopReading();
+        }
+    }
+    for(auto& reader : readers)
+    {
+        reader.thread.join();
+    }
+    unlink(socket_path.c_str());
+
+    return true;
+}
+
+#endif
+
+}
+
+bool RunPlannerDaemon(const std::string& socket_path, int worker_num, int planner_capacity)
+{
+    if(worker_num <= 0)
+    {
+        worker_num = int(std::thread::hardware_concurrency());
+    }
+    std::mutex output_mutex;
+    PlannerService service(64, planner_capacity);
+    // 析构时先执行完队列中剩余的规划请求, 因此放在它们用到的对象之后
+    ThreadPool pool(std::max(worker_num, 1));
+
+    if(socket_path == "-")
+    {
+        auto read_line = [](std::string& line){ return bool(std::getline(std::cin, line)); };
+        auto reply = [&output_mutex](const std::string& line)
+        {
+            std::lock_guard<std::mutex> lock(output_mutex);
+            std::cout<<line<<std::endl;
+        };
+        ServeRequests(service, pool, read_line, reply);
+        return true;
+    }
+
+#if defined(_WIN32)
+    std::cerr<<"unix domain sockets are not supported on this platform, use \"-\" for stdin/stdout"<<std::endl;
+    return false;
+#else
+    return RunSocketDaemon(service, pool, socket_path);
+#endif
+}
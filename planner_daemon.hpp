@@ -0,0 +1,72 @@
+#ifndef BCD_PLANNER_PLANNER_DAEMON_H
+#define BCD_PLANNER_PLANNER_DAEMON_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <string>
+#include <functional>
+
+#include <opencv2/core/core.hpp>
+
+#include "planner.hpp"
+#include "plan_cache.hpp"
+#include "lru_table.hpp"
+#include "thread_pool.hpp"
+
+
+/** 常驻规划服务: 每行一个JSON对象作为请求, 每个请求回复一行JSON, 地图与各半径下的分解结果常驻内存 **/
+/** 请求: {"id":1, "op":"load_map", "map":"office", "path":"office.png", "radius":5} **/
+/**       {"id":2, "op":"set_radius", "map":"office", "radius":7}      之后的规划默认使用该半径 **/
+/**       {"id":3, "op":"plan_coverage", "map":"office", "x":10, "y":20, "radius":7, "meters_per_pix":0.02, "direction_x":0, "direction_y":-1} **/
+/**       {"id":4, "op":"plan_return", "map":"office", "x":40, "y":50, "home_x":10, "home_y":20} **/
+/**       {"id":5, "op":"unload_map", "map":"office"}    {"id":6, "op":"shutdown"} **/
+/** 回复: {"id":3, "ok":true, "queue_ms":0.01, "latency_ms":1.5, "path":[[x,y],...], "messages":[[distance,global_yaw,local_yaw],...]} **/
+/**       失败时 {"id":3, "ok":false, ..., "error":"unknown map"} **/
+/** 地图相关的请求在读取请求的线程上按顺序执行, 规划请求交给工作线程, 回复可能不按请求的顺序, 以id对应 **/
+
+
+/** 一张常驻的地图及其各半径下的Planner, 规划请求执行期间持有shared_ptr, 卸载或替换地图不影响正在进行的规划 **/
+/** 每个半径登记一个shared_future: 同一半径只分解一次, 其它请求等待同一个结果; 没有空闲区域的半径记为nullptr, 不再重复分解 **/
+/** 按最近使用的顺序最多保留planner_capacity个半径(含正在分解的与没有空闲区域的) **/
+class MapSession
+{
+public:
+    typedef std::shared_future<std::shared_ptr<const Planner>> PendingPlanner;
+
+    cv::Mat1b map;
+    int robot_radius;
+    std::mutex planner_mutex;
+    LeastRecentlyUsedTable<int, PendingPlanner, std::hash<int>> planners;
+};
+
+class PlannerService
+{
+public:
+    // planner_capacity为每张地图常驻的半径数
+    explicit PlannerService(int plan_cache_capacity=64, int planner_capacity=8);
+
+    // 解析一行请求; 地图相关的请求立即执行并回复, 规划请求返回在工作线程上执行的任务(执行完后回复), 其余情况返回空任务
+    // 收到shutdown时stop_requested置为true
+    std::function<void()> Dispatch(const std::string& request_line, const std::function<void(const std::string&)>& reply, bool& stop_requested);
+
+    const std::shared_ptr<PlanCache>& GetPlanCache() const;
+
+private:
+    std::shared_ptr<MapSession> FindSession(const std::string& map_name) const;
+    // 没有该半径的Planner时先分解(不持有锁), 同一半径正在分解时等待它的结果; 该半径下没有空闲区域时返回nullptr
+    std::shared_ptr<const Planner> GetPlanner(MapSession& session, int robot_radius) const;
+
+    mutable std::mutex session_mutex;
+    std::map<std::string, std::shared_ptr<MapSession>> sessions;
+    std::shared_ptr<PlanCache> plan_cache;
+    int planner_capacity;
+};
+
+// socket_path为"-"时从标准输入读请求, 回复写到标准输出, 输入结束后等待所有请求完成再返回
+// 否则在该路径上监听UNIX domain socket, 每个连接一个读取线程, 直到收到shutdown; worker_num<=0时按硬件并发数
+// planner_capacity为每张地图常驻的半径数
+bool RunPlannerDaemon(const std::string& socket_path, int worker_num=0, int planner_capacity=8);
+
+#endif //BCD_PLANNER_PLANNER_DAEMON_H
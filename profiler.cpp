@@ -0,0 +1,242 @@
+#include <new>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include "profiler.hpp"
+
+
+namespace
+{
+thread_local Profiler* current_profiler = nullptr;
+thread_local long long allocation_counter = 0;
+}
+
+
+#ifdef BCD_PROFILING
+
+/** 替换全局operator new以统计堆分配次数, 仅在插桩版本中生效 **/
+
+void* operator new(std::size_t size)
+{
+    allocation_counter++;
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if(ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    allocation_counter++;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#endif
+
+
+Profiler* CurrentProfiler()
+{
+    return current_profiler;
+}
+
+long long AllocationCount()
+{
+    return allocation_counter;
+}
+
+ProfileSession::ProfileSession(Profiler* profiler)
+{
+    previous_profiler = current_profiler;
+    if(profiler != nullptr)
+    {
+        current_profiler = profiler;
+    }
+}
+
+ProfileSession::~ProfileSession()
+{
+    current_profiler = previous_profiler;
+}
+
+ProfileScope::ProfileScope(const char* stage_name)
+{
+    profiler = current_profiler;
+    stage = stage_name;
+    if(profiler != nullptr)
+    {
+        start_allocations = allocation_counter;
+        start_time = std::chrono::steady_clock::now();
+    }
+    else
+    {
+        start_allocations = 0;
+    }
+}
+
+ProfileScope::~ProfileScope()
+{
+    if(profiler != nullptr)
+    {
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+        profiler->AddStage(stage, milliseconds, allocation_counter - start_allocations);
+    }
+}
+
+void Profiler::AddStage(const std::string& stage, double milliseconds, long long allocations)
+{
+    StageStats& stats = stages[stage];
+    stats.calls++;
+    stats.milliseconds += milliseconds;
+    stats.allocations += allocations;
+}
+
+void Profiler::AddCount(const std::string& counter, long long value)
+{
+    counters[counter] += value;
+}
+
+void Profiler::AddSample(const std::string& series, long long value)
+{
+    samples[series].emplace_back(value);
+}
+
+void Profiler::Clear()
+{
+    stages.clear();
+    counters.clear();
+    samples.clear();
+}
+
+const std::map<std::string, Profiler::StageStats>& Profiler::GetStages() const
+{
+    return stages;
+}
+
+const std::map<std::string, long long>& Profiler::GetCounters() const
+{
+    return counters;
+}
+
+const std::map<std::string, std::vector<long long>>& Profiler::GetSamples() const
+{
+    return samples;
+}
+
+bool Profiler::IsEnabled()
+{
+#ifdef BCD_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::string Profiler::ToJson() const
+{
+    std::ostringstream json;
+
+    json<<"{\"enabled\":"<<(IsEnabled() ? "true" : "false");
+
+    json<<",\"stages\":{";
+    for(auto iter = stages.begin(); iter != stages.end(); ++iter)
+    {
+        if(iter != stages.begin())
+        {
+            json<<",";
+        }
+        json<<"\""<<iter->first<<"\":{\"calls\":"<<iter->second.calls
+            <<",\"milliseconds\":"<<iter->second.milliseconds
+            <<",\"allocations\":"<<iter->second.allocations<<"}";
+    }
+    json<<"}";
+
+    json<<",\"counters\":{";
+    for(auto iter = counters.begin(); iter != counters.end(); ++iter)
+    {
+        if(iter != counters.begin())
+        {
+            json<<",";
+        }
+        json<<"\""<<iter->first<<"\":"<<iter->second;
+    }
+    json<<"}";
+
+    // 每个序列给出汇总值和原始数据
+    json<<",\"samples\":{";
+    for(auto iter = samples.begin(); iter != samples.end(); ++iter)
+    {
+        if(iter != samples.begin())
+        {
+            json<<",";
+        }
+
+        const std::vector<long long>& values = iter->second;
+        long long sum = 0;
+        for(const auto& value : values)
+        {
+            sum += value;
+        }
+        long long min_value = values.empty() ? 0 : *std::min_element(values.begin(), values.end());
+        long long max_value = values.empty() ? 0 : *std::max_element(values.begin(), values.end());
+
+        json<<"\""<<iter->first<<"\":{\"count\":"<<values.size()<<",\"sum\":"<<sum
+            <<",\"min\":"<<min_value<<",\"max\":"<<max_value<<",\"values\":[";
+        for(size_t i = 0; i < values.size(); i++)
+        {
+            if(i != 0)
+            {
+                json<<",";
+            }
+            json<<values[i];
+        }
+        json<<"]}";
+    }
+    json<<"}}";
+
+    return json.str();
+}
+
+bool Profiler::WriteJson(const std::string& file_path) const
+{
+    std::ofstream output(file_path);
+    if(!output.is_open())
+    {
+        return false;
+    }
+    output<<ToJson()<<std::endl;
+    return true;
+}
@@ -0,0 +1,147 @@
+#ifndef BCD_PLANNER_PROFILER_H
+#define BCD_PLANNER_PROFILER_H
+
+#include <map>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <type_traits>
+
+
+/** 热点路径计时与计数 **/
+/** 编译时定义BCD_PROFILING才会插桩, 否则下面的宏全部展开为空, 没有任何运行时开销 **/
+
+
+class Profiler
+{
+public:
+    class StageStats
+    {
+    public:
+        StageStats()
+        {
+            calls = 0;
+            milliseconds = 0.0;
+            allocations = 0;
+        }
+        long long calls;
+        double milliseconds;
+        // 阶段内(含嵌套阶段)的堆分配次数
+        long long allocations;
+    };
+
+    void AddStage(const std::string& stage, double milliseconds, long long allocations);
+    void AddCount(const std::string& counter, long long value);
+    void AddSample(const std::string& series, long long value);
+    void Clear();
+
+    const std::map<std::string, StageStats>& GetStages() const;
+    const std::map<std::string, long long>& GetCounters() const;
+    const std::map<std::string, std::vector<long long>>& GetSamples() const;
+
+    std::string ToJson() const;
+    bool WriteJson(const std::string& file_path) const;
+
+    // 编译时是否打开了插桩
+    static bool IsEnabled();
+
+private:
+    std::map<std::string, StageStats> stages;
+    std::map<std::string, long long> counters;
+    std::map<std::string, std::vector<long long>> samples;
+};
+
+// 当前线程正在记录的profiler, 没有时为nullptr
+Profiler* CurrentProfiler();
+// 当前线程到目前为止的堆分配次数, 未打开插桩时恒为0
+long long AllocationCount();
+
+/** 在作用域内把profiler挂到当前线程上, 结束时恢复之前的profiler; 传入nullptr时沿用当前的profiler **/
+class ProfileSession
+{
+public:
+    explicit ProfileSession(Profiler* profiler);
+    ~ProfileSession();
+
+private:
+    ProfileSession(const ProfileSession&) = delete;
+    ProfileSession& operator=(const ProfileSession&) = delete;
+
+    Profiler* previous_profiler;
+};
+
+/** 作用域计时器 **/
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* stage_name);
+    ~ProfileScope();
+
+private:
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+    Profiler* profiler;
+    const char* stage;
+    std::chrono::steady_clock::time_point start_time;
+    long long start_allocations;
+};
+
+/** 统计一次操作新建的cell数 **/
+template <typename Graph>
+class ProfileCellCounter
+{
+public:
+    ProfileCellCounter(const char* operation_name, const Graph& graph): operation(operation_name), cell_graph(graph)
+    {
+        initial_size = cell_graph.size();
+    }
+    ~ProfileCellCounter()
+    {
+        Profiler* profiler = CurrentProfiler();
+        if(profiler != nullptr)
+        {
+            profiler->AddCount(operation, (long long)(cell_graph.size() - initial_size));
+        }
+    }
+
+private:
+    const char* operation;
+    const Graph& cell_graph;
+    size_t initial_size;
+};
+
+inline void ProfileCount(const char* counter, long long value)
+{
+    Profiler* profiler = CurrentProfiler();
+    if(profiler != nullptr)
+    {
+        profiler->AddCount(counter, value);
+    }
+}
+
+inline void ProfileSample(const char* series, long long value)
+{
+    Profiler* profiler = CurrentProfiler();
+    if(profiler != nullptr)
+    {
+        profiler->AddSample(series, value);
+    }
+}
+
+#define BCD_PROFILE_CONCAT_IMPL(a, b) a##b
+#define BCD_PROFILE_CONCAT(a, b) BCD_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef BCD_PROFILING
+#define BCD_PROFILE_SCOPE(stage) ProfileScope BCD_PROFILE_CONCAT(bcd_profile_scope_, __LINE__)(stage)
+#define BCD_PROFILE_CELLS(operation, graph) ProfileCellCounter<std::decay<decltype(graph)>::type> BCD_PROFILE_CONCAT(bcd_profile_cells_, __LINE__)(operation, graph)
+#define BCD_PROFILE_COUNT(counter, value) ProfileCount(counter, (long long)(value))
+#define BCD_PROFILE_SAMPLE(series, value) ProfileSample(series, (long long)(value))
+#else
+#define BCD_PROFILE_SCOPE(stage)
+#define BCD_PROFILE_CELLS(operation, graph)
+#define BCD_PROFILE_COUNT(counter, value)
+#define BCD_PROFILE_SAMPLE(series, value)
+#endif
+
+#endif //BCD_PLANNER_PROFILER_H
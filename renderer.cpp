@@ -0,0 +1,252 @@
+#include <algorithm>
+
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/imgcodecs/imgcodecs.hpp>
+
+#include "renderer.hpp"
+
+
+void InitializeColorMap(std::deque<cv::Scalar>& JetColorMap, int repeat_times)
+{
+    for(int i = 0; i <= 255; i++)
+    {
+        for(int j = 0; j < repeat_times; j++)
+        {
+            JetColorMap.emplace_back(cv::Scalar(0, i, 255));
+        }
+    }
+
+    for(int i = 254; i >= 0; i--)
+    {
+        for(int j = 0; j < repeat_times; j++)
+        {
+            JetColorMap.emplace_back(cv::Scalar(0, 255, i));
+        }
+    }
+
+    for(int i = 1; i <= 255; i++)
+    {
+        for(int j = 0; j < repeat_times; j++)
+        {
+            JetColorMap.emplace_back(cv::Scalar(i, 255, 0));
+        }
+    }
+
+    for(int i = 254; i >= 0; i--)
+    {
+        for(int j = 0; j < repeat_times; j++)
+        {
+            JetColorMap.emplace_back(cv::Scalar(255, i, 0));
+        }
+    }
+
+    for(int i = 1; i <= 255; i++)
+    {
+        for(int j = 0; j < repeat_times; j++)
+        {
+            JetColorMap.emplace_back(cv::Scalar(255, 0, i));
+        }
+    }
+
+    for(int i = 254; i >= 1; i--)
+    {
+        for(int j = 0; j < repeat_times; j++)
+        {
+            JetColorMap.emplace_back(cv::Scalar(i, 0, 255));
+        }
+    }
+}
+
+void UpdateColorMap(std::deque<cv::Scalar>& JetColorMap)
+{
+    cv::Scalar color = JetColorMap.front();
+    JetColorMap.pop_front();
+    JetColorMap.emplace_back(color);
+}
+
+void DrawCell(cv::Mat& map, const CellNode& cell, const cv::Scalar& color)
+{
+    for(const auto& ceiling_point : cell.ceiling)
+    {
+        map.at<cv::Vec3b>(ceiling_point.y, ceiling_point.x) = cv::Vec3b(uchar(color[0]), uchar(color[1]), uchar(color[2]));
+    }
+
+    for(const auto& floor_point : cell.floor)
+    {
+        map.at<cv::Vec3b>(floor_point.y, floor_point.x) = cv::Vec3b(uchar(color[0]), uchar(color[1]), uchar(color[2]));
+    }
+
+    cv::line(map, cv::Point(cell.ceiling.front().x,cell.ceiling.front().y), cv::Point(cell.floor.front().x,cell.floor.front().y), color);
+    cv::line(map, cv::Point(cell.ceiling.back().x,cell.ceiling.back().y), cv::Point(cell.floor.back().x,cell.floor.back().y), color);
+}
+
+
+/** 离屏渲染 **/
+
+
+PathRenderer::PathRenderer()
+{
+    frame_stride = 1;
+    drawn_points = 0;
+}
+
+PathRenderer::PathRenderer(const cv::Mat& map, int color_repeats)
+{
+    frame_stride = 1;
+    drawn_points = 0;
+    SetCanvas(map, color_repeats);
+}
+
+void PathRenderer::SetCanvas(const cv::Mat& map, int color_repeats)
+{
+    if(map.channels() == 1)
+    {
+        cv::cvtColor(map, canvas, cv::COLOR_GRAY2BGR);
+    }
+    else
+    {
+        canvas = map.clone();
+    }
+
+    JetColorMap.clear();
+    InitializeColorMap(JetColorMap, color_repeats);
+    drawn_points = 0;
+}
+
+bool PathRenderer::OpenVideo(const std::string& video_path, double fps, int stride)
+{
+    if(canvas.empty())
+    {
+        return false;
+    }
+
+    // .mp4使用mp4v编码, 其余使用MJPG
+    int codec = cv::VideoWriter::fourcc('M', 'J', 'P', 'G');
+    if(video_path.size() >= 4 && video_path.compare(video_path.size()-4, 4, ".mp4") == 0)
+    {
+        codec = cv::VideoWriter::fourcc('m', 'p', '4', 'v');
+    }
+
+    frame_stride = std::max(1, stride);
+    return video_writer.open(video_path, codec, fps, canvas.size(), true);
+}
+
+void PathRenderer::CloseVideo()
+{
+    if(video_writer.isOpened())
+    {
+        video_writer.write(canvas);
+        video_writer.release();
+    }
+}
+
+bool PathRenderer::IsRecording() const
+{
+    return video_writer.isOpened();
+}
+
+void PathRenderer::DrawCells(const std::vector<CellNode>& cell_graph, const cv::Scalar& color)
+{
+    for(const auto& cell : cell_graph)
+    {
+        if(cell.ceiling.empty() || cell.floor.empty())
+        {
+            continue;
+        }
+        DrawCell(canvas, cell, color);
+        // 每个cell一帧
+        Flush();
+    }
+}
+
+void PathRenderer::DrawMarker(const Point2D& point, int radius, const cv::Scalar& color)
+{
+    cv::circle(canvas, cv::Point(point.x, point.y), radius, color, -1);
+}
+
+void PathRenderer::DrawPolygons(const std::vector<std::vector<cv::Point>>& contours, const cv::Scalar& color)
+{
+    cv::fillPoly(canvas, contours, color);
+}
+
+void PathRenderer::DrawPathPoint(const Point2D& point)
+{
+    SetPixel(point, JetColorMap.front());
+    UpdateColorMap(JetColorMap);
+    StepFrame();
+}
+
+void PathRenderer::DrawPath(const std::deque<Point2D>& path)
+{
+    for(const auto& point : path)
+    {
+        DrawPathPoint(point);
+    }
+}
+
+void PathRenderer::DrawPath(const std::deque<std::deque<Point2D>>& path)
+{
+    for(const auto& sub_path : path)
+    {
+        DrawPath(sub_path);
+    }
+}
+
+void PathRenderer::DrawPath(const std::deque<Point2D>& path, const cv::Scalar& color)
+{
+    for(const auto& point : path)
+    {
+        SetPixel(point, color);
+        StepFrame();
+    }
+}
+
+void PathRenderer::DrawRobotPath(const std::deque<Point2D>& path, int robot_radius)
+{
+    for(const auto& position : path)
+    {
+        cv::circle(canvas, cv::Point(position.x, position.y), robot_radius, cv::Scalar(255, 204, 153), -1);
+        StepFrame();
+        cv::circle(canvas, cv::Point(position.x, position.y), robot_radius, cv::Scalar(255, 229, 204), -1);
+    }
+}
+
+void PathRenderer::Flush()
+{
+    if(video_writer.isOpened())
+    {
+        video_writer.write(canvas);
+    }
+}
+
+bool PathRenderer::SavePng(const std::string& image_path) const
+{
+    if(canvas.empty())
+    {
+        return false;
+    }
+    return cv::imwrite(image_path, canvas);
+}
+
+const cv::Mat3b& PathRenderer::GetCanvas() const
+{
+    return canvas;
+}
+
+void PathRenderer::SetPixel(const Point2D& point, const cv::Scalar& color)
+{
+    if(point.x < 0 || point.y < 0 || point.x >= canvas.cols || point.y >= canvas.rows)
+    {
+        return;
+    }
+    canvas.at<cv::Vec3b>(point.y, point.x) = cv::Vec3b(uchar(color[0]), uchar(color[1]), uchar(color[2]));
+}
+
+void PathRenderer::StepFrame()
+{
+    drawn_points++;
+    if(video_writer.isOpened() && drawn_points % frame_stride == 0)
+    {
+        video_writer.write(canvas);
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef BCD_PLANNER_RENDERER_H
+#define BCD_PLANNER_RENDERER_H
+
+#include <vector>
+#include <deque>
+#include <string>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/videoio/videoio.hpp>
+
+#include "bcd.hpp"
+
+
+const int palette_colors = 1530;
+
+void InitializeColorMap(std::deque<cv::Scalar>& JetColorMap, int repeat_times);
+void UpdateColorMap(std::deque<cv::Scalar>& JetColorMap);
+
+void DrawCell(cv::Mat& map, const CellNode& cell, const cv::Scalar& color=cv::Scalar(100, 100, 100));
+
+
+/** 离屏渲染: cell与路径累积在同一张画布上, 最后输出png, 或每隔frame_stride个点向视频写一帧 **/
+class PathRenderer
+{
+public:
+    PathRenderer();
+    explicit PathRenderer(const cv::Mat& map, int color_repeats=10);
+
+    // 灰度图会转成彩色作为底图, 同时清空已绘制的内容与颜色表
+    void SetCanvas(const cv::Mat& map, int color_repeats=10);
+
+    bool OpenVideo(const std::string& video_path, double fps=30.0, int stride=100);
+    void CloseVideo();
+    bool IsRecording() const;
+
+    void DrawCells(const std::vector<CellNode>& cell_graph, const cv::Scalar& color=cv::Scalar(100, 100, 100));
+    void DrawMarker(const Point2D& point, int radius, const cv::Scalar& color);
+    void DrawPolygons(const std::vector<std::vector<cv::Point>>& contours, const cv::Scalar& color);
+
+    // 按照jet颜色表逐点着色, 颜色在多次调用之间连续
+    void DrawPathPoint(const Point2D& point);
+    void DrawPath(const std::deque<Point2D>& path);
+    void DrawPath(const std::deque<std::deque<Point2D>>& path);
+    // 使用固定颜色
+    void DrawPath(const std::deque<Point2D>& path, const cv::Scalar& color);
+    // 用实心圆表示机器人, 已经过的位置使用浅色
+    void DrawRobotPath(const std::deque<Point2D>& path, int robot_radius);
+
+    // 把当前画布写成视频的一帧(若正在录制)
+    void Flush();
+    bool SavePng(const std::string& image_path) const;
+    const cv::Mat3b& GetCanvas() const;
+
+private:
+    void SetPixel(const Point2D& point, const cv::Scalar& color);
+    void StepFrame();
+
+    cv::Mat3b canvas;
+    std::deque<cv::Scalar> JetColorMap;
+
+    cv::VideoWriter video_writer;
+    int frame_stride;
+    long long drawn_points;
+};
+
+#endif //BCD_PLANNER_RENDERER_H
@@ -0,0 +1,568 @@
+#include <algorithm>
+#include <sstream>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "streaming.hpp"
+#include "profiler.hpp"
+
+
+/** 按列带读取占据栅格图 **/
+
+namespace
+{
+
+// 读取PGM头部的下一个数, 跳过空白与#开头的注释
+bool ReadPgmHeaderValue(std::istream& input, int& value)
+{
+    while(true)
+    {
+        int c = input.peek();
+        if(c == '#')
+        {
+            std::string comment;
+            std::getline(input, comment);
+        }
+        else if(c == ' ' || c == '\t' || c == '\r' || c == '\n')
+        {
+            input.get();
+        }
+        else
+        {
+            break;
+        }
+    }
+    return bool(input >> value);
+}
+
+}
+
+MapBandReader::MapBandReader()
+{
+    data_offset = 0;
+    cols = 0;
+    rows = 0;
+}
+
+bool MapBandReader::Open(const std::string& map_file_path)
+{
+    Close();
+
+    map_file.open(map_file_path, std::ios::binary);
+    if(map_file.is_open())
+    {
+        char magic[2] = {0, 0};
+        int max_value = 0;
+        map_file.read(magic, 2);
+        if(magic[0] == 'P' && magic[1] == '5'
+           && ReadPgmHeaderValue(map_file, cols) && ReadPgmHeaderValue(map_file, rows) && ReadPgmHeaderValue(map_file, max_value)
+           && cols > 0 && rows > 0 && max_value > 0 && max_value < 256)
+        {
+            // 头部之后恰好一个空白字符
+            map_file.get();
+            data_offset = map_file.tellg();
+            return true;
+        }
+        map_file.close();
+    }
+
+    cols = 0;
+    rows = 0;
+    decoded_map = ReadMap(map_file_path);
+    if(decoded_map.empty())
+    {
+        return false;
+    }
+    cols = decoded_map.cols;
+    rows = decoded_map.rows;
+    return true;
+}
+
+void MapBandReader::Close()
+{
+    if(map_file.is_open())
+    {
+        map_file.close();
+    }
+    map_file.clear();
+    decoded_map = cv::Mat1b();
+    data_offset = 0;
+    cols = 0;
+    rows = 0;
+}
+
+bool MapBandReader::IsOpen() const
+{
+    return cols > 0 && rows > 0;
+}
+
+bool MapBandReader::IsStreaming() const
+{
+    return map_file.is_open();
+}
+
+int MapBandReader::Cols() const
+{
+    return cols;
+}
+
+int MapBandReader::Rows() const
+{
+    return rows;
+}
+
+cv::Mat1b MapBandReader::ReadBand(int x_begin, int x_end)
+{
+    if(!IsOpen() || x_end <= x_begin)
+    {
+        return cv::Mat1b();
+    }
+
+    cv::Mat1b band(rows, x_end-x_begin, uchar(0));
+
+    int valid_begin = std::max(x_begin, 0);
+    int valid_end = std::min(x_end, cols);
+    if(valid_end <= valid_begin)
+    {
+        return band;
+    }
+
+    if(!IsStreaming())
+    {
+        for(int y = 0; y < rows; y++)
+        {
+            std::copy(decoded_map.ptr(y) + valid_begin, decoded_map.ptr(y) + valid_end, band.ptr(y) + (valid_begin-x_begin));
+        }
+        return band;
+    }
+
+    for(int y = 0; y < rows; y++)
+    {
+        map_file.seekg(data_offset + std::streamoff(y) * cols + valid_begin);
+        map_file.read(reinterpret_cast<char*>(band.ptr(y) + (valid_begin-x_begin)), valid_end-valid_begin);
+    }
+    if(!map_file)
+    {
+        map_file.clear();
+        return cv::Mat1b();
+    }
+    return band;
+}
+
+
+/** 逐列扫描空闲游程 **/
+
+namespace
+{
+
+// 一列中连续的空闲像素[top, bottom]
+class FreeRun
+{
+public:
+    FreeRun(int top_y, int bottom_y)
+    {
+        top = top_y;
+        bottom = bottom_y;
+    }
+    int top;
+    int bottom;
+};
+
+typedef std::function<void(int, const std::vector<FreeRun>&)> ColumnHandler;
+typedef std::function<void(CellNode&)> ClosedCellHandler;
+
+// 对每一列(从左到右)的空闲游程调用column_handler, 同一时刻只有一个列带在内存中
+bool ForEachFreeColumn(MapBandReader& reader, int robot_radius, int band_width, const ColumnHandler& column_handler)
+{
+    robot_radius = std::max(robot_radius, 0);
+    band_width = std::max(band_width, 1);
+
+    cv::Mat kernel;
+    if(robot_radius > 0)
+    {
+        kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(2*robot_radius+1, 2*robot_radius+1));
+    }
+
+    std::vector<FreeRun> runs;
+
+    for(int band_begin = 0; band_begin < reader.Cols(); band_begin += band_width)
+    {
+        int band_end = std::min(band_begin+band_width, reader.Cols());
+
+        // 两侧多读robot_radius列, 腐蚀后只取中间的列; 地图之外都按障碍处理
+        cv::Mat1b band = reader.ReadBand(band_begin-robot_radius, band_end+robot_radius);
+        if(band.empty())
+        {
+            return false;
+        }
+        cv::threshold(band, band, 128, 255, cv::THRESH_BINARY);
+        if(robot_radius > 0)
+        {
+            cv::erode(band, band, kernel, cv::Point(-1, -1), 1, cv::BORDER_CONSTANT, cv::Scalar(0));
+        }
+
+        for(int x = band_begin; x < band_end; x++)
+        {
+            int band_x = x - band_begin + robot_radius;
+
+            runs.clear();
+            for(int y = 0; y < band.rows; y++)
+            {
+                if(band(y, band_x) == 0)
+                {
+                    continue;
+                }
+                if(!runs.empty() && runs.back().bottom == y-1)
+                {
+                    runs.back().bottom = y;
+                }
+                else
+                {
+                    runs.emplace_back(FreeRun(y, y));
+                }
+            }
+
+            column_handler(x, runs);
+        }
+    }
+
+    return true;
+}
+
+// 相邻两列的游程互相只与对方重叠时延续同一个cell, 否则左边的cell闭合, 右边的游程开始新的cell, 重叠的两者互为邻居
+class FreeRunSweep
+{
+public:
+    explicit FreeRunSweep(const ClosedCellHandler& handler) : closed_cell_handler(handler)
+    {
+        cell_num = 0;
+    }
+
+    void AddColumn(int x, const std::vector<FreeRun>& runs)
+    {
+        overlaps.clear();
+        active_overlap_nums.assign(active_runs.size(), 0);
+        run_overlap_nums.assign(runs.size(), 0);
+
+        // 两列的游程都按y排好, 双指针找出所有重叠的对
+        int i = 0, j = 0;
+        while(i < int(active_runs.size()) && j < int(runs.size()))
+        {
+            if(active_runs[i].top <= runs[j].bottom && runs[j].top <= active_runs[i].bottom)
+            {
+                overlaps.emplace_back(std::make_pair(i, j));
+                active_overlap_nums[i]++;
+                run_overlap_nums[j]++;
+            }
+            if(active_runs[i].bottom < runs[j].bottom)
+            {
+                i++;
+            }
+            else
+            {
+                j++;
+            }
+        }
+
+        next_cells.assign(runs.size(), CellNode());
+        continued.assign(runs.size(), false);
+        closed.assign(active_runs.size(), true);
+
+        for(const auto& overlap : overlaps)
+        {
+            if(active_overlap_nums[overlap.first] == 1 && run_overlap_nums[overlap.second] == 1)
+            {
+                next_cells[overlap.second] = std::move(active_cells[overlap.first]);
+                continued[overlap.second] = true;
+                closed[overlap.first] = false;
+            }
+        }
+
+        for(int k = 0; k < int(runs.size()); k++)
+        {
+            if(!continued[k])
+            {
+                next_cells[k].cellIndex = cell_num++;
+            }
+            next_cells[k].ceiling.emplace_back(Point2D(x, runs[k].top));
+            next_cells[k].floor.emplace_back(Point2D(x, runs[k].bottom));
+        }
+
+        for(const auto& overlap : overlaps)
+        {
+            if(closed[overlap.first])
+            {
+                active_cells[overlap.first].neighbor_indices.emplace_back(next_cells[overlap.second].cellIndex);
+                next_cells[overlap.second].neighbor_indices.emplace_back(active_cells[overlap.first].cellIndex);
+            }
+        }
+
+        for(int k = 0; k < int(active_cells.size()); k++)
+        {
+            if(closed[k])
+            {
+                closed_cell_handler(active_cells[k]);
+            }
+        }
+
+        active_cells.swap(next_cells);
+        active_runs.assign(runs.begin(), runs.end());
+    }
+
+    void Finish()
+    {
+        for(auto& cell : active_cells)
+        {
+            closed_cell_handler(cell);
+        }
+        active_cells.clear();
+        active_runs.clear();
+    }
+
+    int CellNum() const
+    {
+        return cell_num;
+    }
+
+private:
+    const ClosedCellHandler& closed_cell_handler;
+
+    std::vector<FreeRun> active_runs;
+    std::vector<CellNode> active_cells;
+    int cell_num;
+
+    std::vector<std::pair<int, int>> overlaps;
+    std::vector<int> active_overlap_nums;
+    std::vector<int> run_overlap_nums;
+    std::vector<CellNode> next_cells;
+    std::vector<char> continued;
+    std::vector<char> closed;
+};
+
+int FindComponent(std::vector<int>& component_parents, int cell_index)
+{
+    while(component_parents[cell_index] != cell_index)
+    {
+        component_parents[cell_index] = component_parents[component_parents[cell_index]];
+        cell_index = component_parents[cell_index];
+    }
+    return cell_index;
+}
+
+}
+
+bool ApproximateStreamingDecomposition(const std::string& map_file_path, int robot_radius, int band_width, const CellHandler& cell_handler)
+{
+    BCD_PROFILE_SCOPE("ApproximateStreamingDecomposition");
+
+    MapBandReader reader;
+    if(!reader.Open(map_file_path))
+    {
+        return false;
+    }
+
+    // 第一遍: 只保留每个cell的连通分量与面积
+    std::vector<int> component_parents;
+    std::vector<long long> cell_areas;
+
+    ClosedCellHandler union_cells = [&component_parents, &cell_areas](CellNode& cell)
+    {
+        int max_index = cell.cellIndex;
+        for(int neighbor_index : cell.neighbor_indices)
+        {
+            max_index = std::max(max_index, neighbor_index);
+        }
+        while(int(component_parents.size()) <= max_index)
+        {
+            component_parents.emplace_back(int(component_parents.size()));
+            cell_areas.emplace_back(0);
+        }
+
+        for(int i = 0; i < int(cell.ceiling.size()); i++)
+        {
+            cell_areas[cell.cellIndex] += cell.floor[i].y - cell.ceiling[i].y + 1;
+        }
+        for(int neighbor_index : cell.neighbor_indices)
+        {
+            int root = FindComponent(component_parents, cell.cellIndex);
+            int neighbor_root = FindComponent(component_parents, neighbor_index);
+            component_parents[std::max(root, neighbor_root)] = std::min(root, neighbor_root);
+        }
+    };
+
+    {
+        FreeRunSweep sweep(union_cells);
+        if(!ForEachFreeColumn(reader, robot_radius, band_width, [&sweep](int x, const std::vector<FreeRun>& runs){ sweep.AddColumn(x, runs); }))
+        {
+            return false;
+        }
+        sweep.Finish();
+    }
+
+    if(component_parents.empty())
+    {
+        return false;
+    }
+
+    std::vector<long long> component_areas(component_parents.size(), 0);
+    for(int i = 0; i < int(component_parents.size()); i++)
+    {
+        component_areas[FindComponent(component_parents, i)] += cell_areas[i];
+    }
+    int largest_component = int(std::max_element(component_areas.begin(), component_areas.end()) - component_areas.begin());
+
+    // 保留的cell按原来的顺序重新编号
+    std::vector<int> new_indices(component_parents.size(), INT_MAX);
+    int kept_cell_num = 0;
+    for(int i = 0; i < int(component_parents.size()); i++)
+    {
+        if(FindComponent(component_parents, i) == largest_component)
+        {
+            new_indices[i] = kept_cell_num++;
+        }
+    }
+    std::vector<int>().swap(component_parents);
+    std::vector<long long>().swap(cell_areas);
+
+    // 第二遍: 交出最大连通区域中的cell
+    ClosedCellHandler emit_cell = [&new_indices, &cell_handler](CellNode& cell)
+    {
+        if(new_indices[cell.cellIndex] == INT_MAX)
+        {
+            return;
+        }
+        cell.cellIndex = new_indices[cell.cellIndex];
+        for(auto& neighbor_index : cell.neighbor_indices)
+        {
+            neighbor_index = new_indices[neighbor_index];
+        }
+        cell_handler(cell);
+    };
+
+    FreeRunSweep sweep(emit_cell);
+    if(!ForEachFreeColumn(reader, robot_radius, band_width, [&sweep](int x, const std::vector<FreeRun>& runs){ sweep.AddColumn(x, runs); }))
+    {
+        return false;
+    }
+    sweep.Finish();
+
+    BCD_PROFILE_COUNT("cells", kept_cell_num);
+    return true;
+}
+
+bool ApproximateStreamingDecomposition(const std::string& map_file_path, const std::string& cell_file_path, int robot_radius, int band_width)
+{
+    std::ofstream output(cell_file_path);
+    if(!output.is_open())
+    {
+        return false;
+    }
+
+    bool succeeded = ApproximateStreamingDecomposition(map_file_path, robot_radius, band_width, [&output](const CellNode& cell){ WriteStreamedCell(output, cell); });
+    output.flush();
+
+    return succeeded && bool(output);
+}
+
+
+/** cell文件 **/
+
+bool WriteStreamedCell(std::ostream& output, const CellNode& cell)
+{
+    output<<cell.cellIndex<<" "<<cell.neighbor_indices.size();
+    for(int neighbor_index : cell.neighbor_indices)
+    {
+        output<<" "<<neighbor_index;
+    }
+
+    output<<" "<<(cell.ceiling.empty() ? 0 : cell.ceiling.front().x)<<" "<<cell.ceiling.size();
+    for(const auto& point : cell.ceiling)
+    {
+        output<<" "<<point.y;
+    }
+    for(const auto& point : cell.floor)
+    {
+        output<<" "<<point.y;
+    }
+    output<<"\n";
+
+    return bool(output);
+}
+
+std::vector<CellNode> ReadStreamedCellGraph(const std::string& cell_file_path)
+{
+    std::ifstream input(cell_file_path);
+    if(!input.is_open())
+    {
+        return {};
+    }
+
+    std::vector<CellNode> cell_graph;
+    std::vector<char> loaded;
+
+    std::string line;
+    while(std::getline(input, line))
+    {
+        if(line.empty())
+        {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        CellNode cell;
+        int neighbor_num = 0, x_begin = 0, column_num = 0;
+
+        if(!(fields>>cell.cellIndex>>neighbor_num) || cell.cellIndex < 0 || neighbor_num < 0)
+        {
+            return {};
+        }
+        for(int i = 0; i < neighbor_num; i++)
+        {
+            int neighbor_index;
+            if(!(fields>>neighbor_index) || neighbor_index < 0)
+            {
+                return {};
+            }
+            cell.neighbor_indices.emplace_back(neighbor_index);
+        }
+        if(!(fields>>x_begin>>column_num) || column_num <= 0)
+        {
+            return {};
+        }
+        for(int i = 0; i < 2*column_num; i++)
+        {
+            int y;
+            if(!(fields>>y))
+            {
+                return {};
+            }
+            Edge& edge = i < column_num ? cell.ceiling : cell.floor;
+            edge.emplace_back(Point2D(x_begin + i % column_num, y));
+        }
+
+        if(cell.cellIndex >= int(cell_graph.size()))
+        {
+            cell_graph.resize(cell.cellIndex+1);
+            loaded.resize(cell.cellIndex+1, false);
+        }
+        loaded[cell.cellIndex] = true;
+        cell_graph[cell.cellIndex] = std::move(cell);
+    }
+
+    for(int i = 0; i < int(cell_graph.size()); i++)
+    {
+        if(!loaded[i])
+        {
+            return {};
+        }
+        for(int neighbor_index : cell_graph[i].neighbor_indices)
+        {
+            if(neighbor_index >= int(cell_graph.size()))
+            {
+                return {};
+            }
+        }
+    }
+
+    return cell_graph;
+}
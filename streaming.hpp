@@ -0,0 +1,65 @@
+#ifndef BCD_PLANNER_STREAMING_H
+#define BCD_PLANNER_STREAMING_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <functional>
+
+#include <opencv2/core/core.hpp>
+
+#include "bcd.hpp"
+
+
+/** 近似流式分解: 按列带读取地图, 逐列把空闲像素切成竖直游程, 相邻两列的游程一一重叠时属于同一个cell; **/
+/** cell一旦闭合(右侧没有唯一的延续)就立即交出, 内存只与列带宽度(乘以地图高度)和当前活动的cell有关, 与地图面积无关 **/
+/** 只做分解, 不规划路径; 不生成事件, 也不走slice扫描, 结果与ExtractContours+ExecuteCellDecomposition不同: **/
+/** 1. cell在游程逐像素分裂/合并处切开, 而不是在轮廓的事件处, cell的数目与边界都不一样 **/
+/** 2. 膨胀用半径为robot_radius的圆腐蚀空闲区域, 主流程是在距离场上取阈值再做开运算, 边界可能差几个像素 **/
+/** 3. 只保留面积最大的连通区域, 面积相近或膨胀把区域切开时保留的区域可能与主流程取的外轮廓不同 **/
+/** 地图放不进内存、近似的cell划分即可时使用; 需要与主流程一致的cell graph时用ConstructCellGraph **/
+
+
+/** 按列带读取占据栅格图 **/
+class MapBandReader
+{
+public:
+    MapBandReader();
+
+    // 二进制PGM(P5, 8位)按行定位读取, 不会把整张图读进内存;
+    // 其它格式只能整张解码, 之后同样按列带取用, 但内存不再受列带宽度限制
+    bool Open(const std::string& map_file_path);
+    void Close();
+    bool IsOpen() const;
+    // 是否真正按列带读取
+    bool IsStreaming() const;
+
+    int Cols() const;
+    int Rows() const;
+
+    // 读取[x_begin, x_end)列的原始灰度, 超出地图的列填0(障碍)
+    cv::Mat1b ReadBand(int x_begin, int x_end);
+
+private:
+    std::ifstream map_file;
+    std::streamoff data_offset;
+    cv::Mat1b decoded_map;
+    int cols;
+    int rows;
+};
+
+typedef std::function<void(const CellNode&)> CellHandler;
+
+// 两遍扫描: 第一遍只合并连通的cell并统计面积, 第二遍只交出面积最大的连通区域中的cell(与ExtractRawContours取面积最大的外轮廓对应),
+// cell的编号在交出的cell中连续; cell按闭合的先后交出, 不是按编号顺序
+// robot_radius>0时用半径为robot_radius的圆腐蚀空闲区域, 列带两侧各多读robot_radius列
+bool ApproximateStreamingDecomposition(const std::string& map_file_path, int robot_radius, int band_width, const CellHandler& cell_handler);
+// 把闭合的cell逐个写入文本文件
+bool ApproximateStreamingDecomposition(const std::string& map_file_path, const std::string& cell_file_path, int robot_radius, int band_width);
+
+// 每行一个cell: 编号 邻居数 邻居... 起始x 列数 每列的ceiling.y... 每列的floor.y...
+bool WriteStreamedCell(std::ostream& output, const CellNode& cell);
+// 读回整张cell graph并按编号排好, 文件不完整时返回空
+std::vector<CellNode> ReadStreamedCellGraph(const std::string& cell_file_path);
+
+#endif //BCD_PLANNER_STREAMING_H
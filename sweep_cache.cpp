@@ -0,0 +1,156 @@
+#include <algorithm>
+
+#include "sweep_cache.hpp"
+#include "profiler.hpp"
+
+
+namespace
+{
+
+uint64_t MixDigest(uint64_t digest, uint32_t value)
+{
+    for(int i = 0; i < 4; i++)
+    {
+        digest ^= uint8_t(value >> (8*i));
+        digest *= 1099511628211ULL;
+    }
+    return digest;
+}
+
+SweepKey MakeSweepKey(const CellGraph& cell_graph, int cell_index, int corner_indicator, int robot_radius)
+{
+    CellEdgeView ceiling = cell_graph.Ceiling(cell_index);
+    CellEdgeView floor = cell_graph.Floor(cell_index);
+
+    SweepKey key;
+    key.left_x = cell_graph.Left(cell_index);
+    key.width = cell_graph.Width(cell_index);
+    key.corner_indicator = corner_indicator;
+    key.robot_radius = robot_radius;
+
+    uint64_t digest = 14695981039346656037ULL;
+    for(int i = 0; i < key.width; i++)
+    {
+        digest = MixDigest(digest, uint32_t(ceiling[i].y));
+        digest = MixDigest(digest, uint32_t(floor[i].y));
+    }
+    key.geometry_digest = digest;
+
+    return key;
+}
+
+}
+
+bool operator==(const SweepKey& lhs, const SweepKey& rhs)
+{
+    return lhs.geometry_digest == rhs.geometry_digest && lhs.left_x == rhs.left_x && lhs.width == rhs.width
+        && lhs.corner_indicator == rhs.corner_indicator && lhs.robot_radius == rhs.robot_radius;
+}
+
+size_t SweepKeyHash::operator()(const SweepKey& key) const
+{
+    uint64_t digest = key.geometry_digest;
+    digest = MixDigest(digest, uint32_t(key.left_x));
+    digest = MixDigest(digest, uint32_t(key.width));
+    digest = MixDigest(digest, uint32_t(key.corner_indicator));
+    digest = MixDigest(digest, uint32_t(key.robot_radius));
+    return size_t(digest);
+}
+
+SweepCache::SweepCache(int capacity)
+{
+    this->capacity = std::max(capacity, 1);
+    hit_count = 0;
+    miss_count = 0;
+}
+
+std::shared_ptr<const std::deque<Point2D>> SweepCache::Find(const CellGraph& cell_graph, int cell_index, int corner_indicator, int robot_radius)
+{
+    SweepKey key = MakeSweepKey(cell_graph, cell_index, corner_indicator, robot_radius);
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    std::shared_ptr<const CachedSweep> cached_sweep = sweeps.Find(key);
+    if(cached_sweep != nullptr)
+    {
+        CellEdgeView ceiling = cell_graph.Ceiling(cell_index);
+        CellEdgeView floor = cell_graph.Floor(cell_index);
+        bool same_geometry = true;
+        for(int i = 0; i < key.width && same_geometry; i++)
+        {
+            same_geometry = (cached_sweep->ceiling_y[i] == ceiling[i].y && cached_sweep->floor_y[i] == floor[i].y);
+        }
+        if(same_geometry)
+        {
+            BCD_PROFILE_COUNT("sweep_cache_hits", 1);
+            hit_count++;
+            return cached_sweep->sweep;
+        }
+    }
+
+    BCD_PROFILE_COUNT("sweep_cache_misses", 1);
+    miss_count++;
+    return nullptr;
+}
+
+void SweepCache::Insert(const CellGraph& cell_graph, int cell_index, int corner_indicator, int robot_radius, const std::shared_ptr<const std::deque<Point2D>>& sweep)
+{
+    if(sweep == nullptr)
+    {
+        return;
+    }
+
+    std::shared_ptr<CachedSweep> cached_sweep = std::make_shared<CachedSweep>();
+    CellEdgeView ceiling = cell_graph.Ceiling(cell_index);
+    CellEdgeView floor = cell_graph.Floor(cell_index);
+    cached_sweep->ceiling_y.reserve(ceiling.size());
+    cached_sweep->floor_y.reserve(floor.size());
+    for(int i = 0; i < ceiling.size(); i++)
+    {
+        cached_sweep->ceiling_y.emplace_back(ceiling[i].y);
+        cached_sweep->floor_y.emplace_back(floor[i].y);
+    }
+    cached_sweep->sweep = sweep;
+
+    SweepKey key = MakeSweepKey(cell_graph, cell_index, corner_indicator, robot_radius);
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    sweeps.Insert(key, cached_sweep, capacity);
+}
+
+void SweepCache::SetCapacity(int capacity)
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    this->capacity = std::max(capacity, 1);
+    sweeps.Shrink(this->capacity);
+}
+
+int SweepCache::GetCapacity() const
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return capacity;
+}
+
+int SweepCache::Size() const
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return sweeps.Size();
+}
+
+void SweepCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    sweeps.Clear();
+}
+
+long long SweepCache::GetHitCount() const
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return hit_count;
+}
+
+long long SweepCache::GetMissCount() const
+{
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    return miss_count;
+}
@@ -0,0 +1,77 @@
+#ifndef BCD_PLANNER_SWEEP_CACHE_H
+#define BCD_PLANNER_SWEEP_CACHE_H
+
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "bcd.hpp"
+#include "lru_table.hpp"
+
+
+/** 往返路径缓存: 以cell的几何(left_x与每列的ceiling/floor)加上入口corner与robot_radius为键, 保存GetBoustrophedonPath的结果 **/
+/** ceiling/floor改变的cell自然查不到旧的结果, 不需要显式失效; 与cell的下标无关, 重新分解或动态重规划后几何不变的cell仍可命中 **/
+/** 可挂在多个CellGraph(包括规划时的副本)上共享, 所有接口可在多个线程中调用 **/
+class SweepKey
+{
+public:
+    SweepKey()
+    {
+        geometry_digest = 0;
+        left_x = 0;
+        width = 0;
+        corner_indicator = 0;
+        robot_radius = 0;
+    }
+    uint64_t geometry_digest;
+    int left_x;
+    int width;
+    int corner_indicator;
+    int robot_radius;
+};
+
+bool operator==(const SweepKey& lhs, const SweepKey& rhs);
+
+class SweepKeyHash
+{
+public:
+    size_t operator()(const SweepKey& key) const;
+};
+
+class SweepCache
+{
+public:
+    // 最多保留capacity条往返路径, 按最近使用的顺序淘汰
+    explicit SweepCache(int capacity=4096);
+
+    // 命中时返回共享的路径, 否则返回nullptr; 摘要相同时再逐列比较ceiling/floor
+    std::shared_ptr<const std::deque<Point2D>> Find(const CellGraph& cell_graph, int cell_index, int corner_indicator, int robot_radius);
+    void Insert(const CellGraph& cell_graph, int cell_index, int corner_indicator, int robot_radius, const std::shared_ptr<const std::deque<Point2D>>& sweep);
+
+    void SetCapacity(int capacity);
+    int GetCapacity() const;
+    int Size() const;
+    void Clear();
+
+    long long GetHitCount() const;
+    long long GetMissCount() const;
+
+private:
+    class CachedSweep
+    {
+    public:
+        std::vector<int> ceiling_y;
+        std::vector<int> floor_y;
+        std::shared_ptr<const std::deque<Point2D>> sweep;
+    };
+
+    mutable std::mutex cache_mutex;
+    int capacity;
+    long long hit_count;
+    long long miss_count;
+    LeastRecentlyUsedTable<SweepKey, CachedSweep, SweepKeyHash> sweeps;
+};
+
+#endif //BCD_PLANNER_SWEEP_CACHE_H
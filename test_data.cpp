@@ -0,0 +1,165 @@
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "test_data.hpp"
+
+
+
+
+/** 静态地图路径规划测试多边形 **/
+std::vector<std::vector<cv::Point>> ConstructHandcraftedContours1()
+{
+    std::vector<cv::Point> handcrafted_polygon_1_1 = {cv::Point(200,300), cv::Point(300,200), cv::Point(200,100), cv::Point(100,200)};
+    std::vector<cv::Point> handcrafted_polygon_1_2 = {cv::Point(300,350), cv::Point(350,300), cv::Point(300,250), cv::Point(250,300)};
+    std::vector<std::vector<cv::Point>> contours = {handcrafted_polygon_1_1, handcrafted_polygon_1_2};
+    return contours;
+}
+
+std::vector<std::vector<cv::Point>> ConstructHandcraftedContours2()
+{
+    std::vector<cv::Point> handcrafted_polygon_2 = {cv::Point(125,125), cv::Point(125,175), cv::Point(225,175), cv::Point(225,225),
+                                                    cv::Point(175,250), cv::Point(225,300), cv::Point(125,325), cv::Point(125,375),
+                                                    cv::Point(375,375), cv::Point(375,325), cv::Point(275,325), cv::Point(275,275),
+                                                    cv::Point(325,250), cv::Point(275,200), cv::Point(375,175), cv::Point(375,125)};
+    std::vector<std::vector<cv::Point>> contours = {handcrafted_polygon_2};
+    return contours;
+}
+
+std::vector<std::vector<cv::Point>> ConstructHandcraftedContours3()
+{
+    std::vector<cv::Point> handcrafted_polygon_3 = {cv::Point(100,100), cv::Point(100,500), cv::Point(150,500), cv::Point(150,150),
+                                                    cv::Point(450,150), cv::Point(450,300), cv::Point(300,300), cv::Point(300,250),
+                                                    cv::Point(350,250), cv::Point(350,200), cv::Point(250,200), cv::Point(250,350),
+                                                    cv::Point(500,350), cv::Point(500,100)};
+    std::vector<std::vector<cv::Point>> contours = {handcrafted_polygon_3};
+    return contours;
+}
+
+std::vector<std::vector<cv::Point>> ConstructHandcraftedContours4()
+{
+    std::vector<cv::Point> handcrafted_polygon_4_1 = {cv::Point(20,20),  cv::Point(20,200), cv::Point(100,200),cv::Point(100,399),
+                                                      cv::Point(20,399), cv::Point(20, 579),cv::Point(200,579),cv::Point(200,499),cv::Point(399,499),cv::Point(399,579),
+                                                      cv::Point(579,579),cv::Point(579,399),cv::Point(499,399),cv::Point(499,200),cv::Point(579,200),cv::Point(579,20),
+                                                      cv::Point(349,20), cv::Point(349,100),cv::Point(250,100),cv::Point(250,20)};
+    std::vector<cv::Point> handcrafted_polygon_4_2 = {cv::Point(220,220),cv::Point(220,380),cv::Point(380,380),cv::Point(380,220)};
+    std::vector<std::vector<cv::Point>> contours = {handcrafted_polygon_4_1, handcrafted_polygon_4_2};
+    return contours;
+}
+
+/** 动态地图路径规划测试多边形 **/
+std::vector<std::vector<cv::Point>> ConstructHandcraftedContours5()
+{
+    std::vector<cv::Point> handcrafted_polygon_5_1 = {cv::Point(125, 50), cv::Point(50, 125), cv::Point(125, 200), cv::Point(200, 125)};
+    std::vector<cv::Point> handcrafted_polygon_5_2 = {cv::Point(80, 300), cv::Point(80, 400), cv::Point(160, 400), cv::Point(120, 350),
+                                                      cv::Point(160, 300)};
+    std::vector<cv::Point> handcrafted_polygon_5_3 = {cv::Point(100, 450), cv::Point(100, 550), cv::Point(140, 550), cv::Point(140, 450)};
+    std::vector<cv::Point> handcrafted_polygon_5_4 = {cv::Point(300, 150), cv::Point(300, 250), cv::Point(400, 220), cv::Point(400, 180)};
+    std::vector<std::vector<cv::Point>> contours = {handcrafted_polygon_5_1, handcrafted_polygon_5_2, handcrafted_polygon_5_3, handcrafted_polygon_5_4};
+    return contours;
+}
+
+
+
+/** 生成测试地图 **/
+
+
+cv::Mat1b ConstructHandcraftedMap(int index)
+{
+    cv::Mat1b map;
+
+    switch(index)
+    {
+        case 1:
+            map = cv::Mat1b(cv::Size(500, 500), CV_8U);
+            map.setTo(255);
+            cv::fillPoly(map, ConstructHandcraftedContours1(), 0);
+            break;
+        case 2:
+            map = cv::Mat1b(cv::Size(600, 600), CV_8U);
+            map.setTo(255);
+            cv::fillPoly(map, ConstructHandcraftedContours2(), 0);
+            break;
+        case 3:
+            map = cv::Mat1b(cv::Size(600, 600), CV_8U);
+            map.setTo(255);
+            cv::fillPoly(map, ConstructHandcraftedContours3(), 0);
+            break;
+        case 4:
+        {
+            // 第一个多边形为外轮廓, 第二个为内部障碍物
+            std::vector<std::vector<cv::Point>> contours = ConstructHandcraftedContours4();
+            std::vector<std::vector<cv::Point>> external_contours = {contours.front()};
+            std::vector<std::vector<cv::Point>> inner_contours = {contours.back()};
+            map = cv::Mat1b(cv::Size(600, 600), CV_8U);
+            map.setTo(0);
+            cv::fillPoly(map, external_contours, 255);
+            cv::fillPoly(map, inner_contours, 0);
+            break;
+        }
+        case 5:
+            map = cv::Mat1b(cv::Size(600, 600), CV_8U);
+            map.setTo(255);
+            cv::fillPoly(map, ConstructHandcraftedContours5(), 0);
+            break;
+        default:
+            break;
+    }
+
+    return map;
+}
+
+cv::Mat1b GenerateSyntheticMap(int map_size, int obstacle_num, unsigned int seed)
+{
+    cv::Mat1b map;
+    if(map_size <= 0 || obstacle_num < 0)
+    {
+        return map;
+    }
+
+    int grid_num = int(std::ceil(std::sqrt(double(std::max(obstacle_num, 1)))));
+    int grid_size = map_size / grid_num;
+    // 障碍物与网格边界之间至少留出的间隙
+    int margin = std::max(2, grid_size / 8);
+    if(grid_size - 2*margin < 8)
+    {
+        return map;
+    }
+
+    map = cv::Mat1b(cv::Size(map_size, map_size), CV_8U);
+    map.setTo(255);
+    // 外围墙壁
+    cv::rectangle(map, cv::Point(0, 0), cv::Point(map_size-1, map_size-1), cv::Scalar(0), 1);
+
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> size_distribution(0.4, 1.0);
+
+    // 使用轴对齐的矩形障碍物, 尺寸与在网格内的位置随机
+    std::vector<std::vector<cv::Point>> contours;
+    for(int i = 0; i < obstacle_num; i++)
+    {
+        int grid_x = i % grid_num;
+        int grid_y = i / grid_num;
+
+        int max_size = grid_size - 2*margin;
+        int width = std::max(4, int(max_size*size_distribution(generator)));
+        int height = std::max(4, int(max_size*size_distribution(generator)));
+        std::uniform_int_distribution<int> x_offset_distribution(0, max_size-width);
+        std::uniform_int_distribution<int> y_offset_distribution(0, max_size-height);
+
+        int left = grid_x*grid_size + margin + x_offset_distribution(generator);
+        int top = grid_y*grid_size + margin + y_offset_distribution(generator);
+        int right = left + width - 1;
+        int bottom = top + height - 1;
+
+        std::vector<cv::Point> polygon = {cv::Point(left, top), cv::Point(left, bottom), cv::Point(right, bottom), cv::Point(right, top)};
+        contours.emplace_back(polygon);
+    }
+
+    cv::fillPoly(map, contours, 0);
+
+    return map;
+}
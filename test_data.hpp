@@ -0,0 +1,24 @@
+#ifndef BCD_PLANNER_TEST_DATA_H
+#define BCD_PLANNER_TEST_DATA_H
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+
+/** 静态地图路径规划测试多边形 **/
+std::vector<std::vector<cv::Point>> ConstructHandcraftedContours1();
+std::vector<std::vector<cv::Point>> ConstructHandcraftedContours2();
+std::vector<std::vector<cv::Point>> ConstructHandcraftedContours3();
+std::vector<std::vector<cv::Point>> ConstructHandcraftedContours4();
+
+/** 动态地图路径规划测试多边形 **/
+std::vector<std::vector<cv::Point>> ConstructHandcraftedContours5();
+
+/** 生成测试地图 **/
+// 将手工多边形画到地图上, index为1~5
+cv::Mat1b ConstructHandcraftedMap(int index);
+// map_size*map_size的方形地图, 矩形障碍物按网格排布且互不相交; 网格过密时返回空地图
+cv::Mat1b GenerateSyntheticMap(int map_size, int obstacle_num, unsigned int seed=0);
+
+#endif //BCD_PLANNER_TEST_DATA_H
@@ -0,0 +1,183 @@
+#include <atomic>
+#include <memory>
+#include <exception>
+#include <algorithm>
+
+#include "thread_pool.hpp"
+
+
+ThreadPool::ThreadPool(int thread_num)
+{
+    stopping = false;
+
+    if(thread_num <= 0)
+    {
+        thread_num = int(std::thread::hardware_concurrency()) - 1;
+    }
+
+    for(int i = 0; i < thread_num; i++)
+    {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_condition.notify_all();
+
+    for(auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+int ThreadPool::Size() const
+{
+    return int(workers.size());
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        tasks.emplace_back(std::move(task));
+    }
+    queue_condition.notify_one();
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int)>& task)
+{
+    if(count <= 0)
+    {
+        return;
+    }
+
+    if(workers.empty() || count == 1)
+    {
+        std::exception_ptr first_exception;
+        for(int i = 0; i < count; i++)
+        {
+            try
+            {
+                task(i);
+            }
+            catch(...)
+            {
+                if(!first_exception)
+                {
+                    first_exception = std::current_exception();
+                }
+            }
+        }
+        if(first_exception)
+        {
+            std::rethrow_exception(first_exception);
+        }
+        return;
+    }
+
+    // 工作线程可能在调用返回之后才被调度到, 所以共享状态放在堆上
+    class ParallelState
+    {
+    public:
+        ParallelState(int total, const std::function<void(int)>& func) : task(func)
+        {
+            count = total;
+            next_index = 0;
+            finished = 0;
+        }
+        const std::function<void(int)>& task;
+        int count;
+        std::atomic<int> next_index;
+        int finished;
+        // 第一个抛出的异常, 由finished_mutex保护
+        std::exception_ptr first_exception;
+        std::mutex finished_mutex;
+        std::condition_variable finished_condition;
+    };
+
+    std::shared_ptr<ParallelState> state = std::make_shared<ParallelState>(count, task);
+
+    // 领取下标直到取完, 只有真正领到下标时才会访问task, 因此task的生命周期只需覆盖本次调用
+    // task抛出的异常不离开工作线程: 记下第一个, 其余下标照常执行, 全部完成后在调用线程上重新抛出
+    auto run = [](const std::shared_ptr<ParallelState>& state)
+    {
+        int done = 0;
+        for(int i = state->next_index++; i < state->count; i = state->next_index++)
+        {
+            try
+            {
+                state->task(i);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(state->finished_mutex);
+                if(!state->first_exception)
+                {
+                    state->first_exception = std::current_exception();
+                }
+            }
+            done++;
+        }
+        if(done > 0)
+        {
+            std::lock_guard<std::mutex> lock(state->finished_mutex);
+            state->finished += done;
+            if(state->finished == state->count)
+            {
+                state->finished_condition.notify_all();
+            }
+        }
+    };
+
+    int helper_num = std::min(Size(), count-1);
+    for(int i = 0; i < helper_num; i++)
+    {
+        Enqueue([state, run](){ run(state); });
+    }
+
+    run(state);
+
+    std::unique_lock<std::mutex> lock(state->finished_mutex);
+    state->finished_condition.wait(lock, [&state](){ return state->finished == state->count; });
+    if(state->first_exception)
+    {
+        std::rethrow_exception(state->first_exception);
+    }
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while(true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_condition.wait(lock, [this](){ return stopping || !tasks.empty(); });
+            if(stopping && tasks.empty())
+            {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        // Enqueue的任务没有返回异常的途径, 丢弃异常以免工作线程退出导致整个进程终止; ParallelFor的任务已在内部捕获
+        try
+        {
+            task();
+        }
+        catch(...)
+        {
+        }
+    }
+}
+
+ThreadPool& DefaultThreadPool()
+{
+    static ThreadPool pool;
+    return pool;
+}
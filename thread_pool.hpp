@@ -0,0 +1,48 @@
+#ifndef BCD_PLANNER_THREAD_POOL_H
+#define BCD_PLANNER_THREAD_POOL_H
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+
+/** 固定大小的线程池 **/
+/** ParallelFor的调用线程也参与执行, 在工作线程内嵌套调用不会死锁 **/
+
+
+class ThreadPool
+{
+public:
+    // thread_num<=0时使用硬件并发数减一(调用线程算一个)
+    explicit ThreadPool(int thread_num=0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int Size() const;
+
+    // task抛出的异常被丢弃, 需要结果或异常时由task自行传出
+    void Enqueue(std::function<void()> task);
+
+    // 对[0, count)中的每个下标调用一次task, 返回时全部执行完毕
+    // 某个下标抛出异常时其余下标仍会执行, 全部完成后在调用线程上重新抛出第一个异常
+    void ParallelFor(int count, const std::function<void(int)>& task);
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex queue_mutex;
+    std::condition_variable queue_condition;
+    bool stopping;
+};
+
+// 进程内共享的线程池, 第一次调用时创建
+ThreadPool& DefaultThreadPool();
+
+#endif //BCD_PLANNER_THREAD_POOL_H